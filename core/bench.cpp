@@ -0,0 +1,654 @@
+// ep128emu-core -- libretro core version of the ep128emu emulator
+// Copyright (C) 2022 Zoltan Balogh
+// https://github.com/zoltanvb/ep128emu-core
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+// Headless benchmark runner: sets up a machine the same way as the libretro
+// core does, then runs it for a given number of emulated seconds without a
+// frontend and without any pacing. The VM is driven from the main thread
+// (VMThread::process()), and the power-on randomization uses a fixed seed,
+// so that input timing and the reported hashes are reproducible between
+// runs.
+//
+// usage: ep128emu_bench [options] [content file]
+//   -m TYPE     machine type, one of the VM_config names (default: EP128_DISK)
+//   -r DIR      ROM directory (default: current directory; ROMs not found
+//               there are replaced with the built-in images)
+//   -c FILE     machine configuration file (.ep128cfg)
+//   -d FILE     demo or snapshot file to load before starting
+//   -s SEQ      start sequence, typed as in the core (\r, \\, \xNN escapes)
+//   -i FILE     input script: lines of "frame keycode state"
+//   -n SECONDS  number of emulated seconds to run (default: 60)
+//   -a FRAMES   number of frames to run ahead (default: 0)
+//   -p COUNT    run COUNT copies of the machine on a worker pool
+//               (VMScheduler), and print the results of each
+//   -j THREADS  number of worker threads for -p (default: one per core)
+//   -f          frame aligned mode: run each frame until the next vsync
+//               instead of for 20 ms, and print the measured refresh rate
+//               and the number of frames that did not end with one vsync
+//   -k N        draw only every Nth frame, as while the frontend is
+//               fast-forwarding (default: 1)
+//   -l MS       audio latency in milliseconds (default: 18), the number
+//               of audio buffer underruns and overruns is printed
+//   -S COUNT    at the end, save COUNT snapshots of the first machine to
+//               memory as retro_serialize() does, and print the average
+//               time per snapshot
+//   -v          print core log messages, including memory usage
+//
+// Besides the hashes, the number of Z80 instructions executed is printed,
+// per emulated second and per second of run time, as a measure of the CPU
+// emulation throughput of each machine type.
+
+#include "core.hpp"
+#include "fileio.hpp"
+#include "vmsched.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+static bool verboseLog = false;
+static std::string contentFileName = "";
+
+static const void *videoData = (const void *) 0;
+static unsigned   videoWidth = 0U;
+static unsigned   videoHeight = 0U;
+static size_t     videoPitch = 0;
+
+// state of one of the machines run
+struct BenchMachine {
+  Ep128Emu::LibretroCore  *core;
+  size_t    inputEventIndex;
+  uint32_t  audioHash;
+  size_t    audioFrameCnt;
+  size_t    demoEndFrame;
+  bool      wasPlayingDemo;
+  uint32_t  frameHash;
+  unsigned  frameWidth;
+  unsigned  frameHeight;
+  BenchMachine()
+    : core((Ep128Emu::LibretroCore *) 0),
+      inputEventIndex(0),
+      audioHash(0x811C9DC5U),
+      audioFrameCnt(0),
+      demoEndFrame(0),
+      wasPlayingDemo(false),
+      frameHash(0U),
+      frameWidth(0U),
+      frameHeight(0U)
+  {
+  }
+};
+
+struct BenchInputEvent {
+  uint32_t  frame;
+  uint8_t   keyCode;
+  bool      isPressed;
+  bool operator<(const BenchInputEvent& r) const
+  {
+    return (frame < r.frame);
+  }
+};
+
+static void benchLog(enum retro_log_level level, const char *fmt, ...)
+{
+  if (!verboseLog && level < RETRO_LOG_WARN)
+    return;
+  va_list va;
+  va_start(va, fmt);
+  std::vfprintf(stderr, fmt, va);
+  va_end(va);
+}
+
+static bool benchEnvironment(unsigned cmd, void *data)
+{
+  (void) cmd;
+  (void) data;
+  return false;
+}
+
+static int16_t benchInputState(unsigned port, unsigned device,
+                               unsigned index, unsigned id)
+{
+  (void) port;
+  (void) device;
+  (void) index;
+  (void) id;
+  return 0;
+}
+
+static void benchVideoRefresh(const void *data, unsigned width,
+                              unsigned height, size_t pitch)
+{
+  if (data) {
+    videoData = data;
+    videoWidth = width;
+    videoHeight = height;
+    videoPitch = pitch;
+  }
+}
+
+static void cfgErrorFunc(void *userData, const char *msg)
+{
+  (void) userData;
+  std::fprintf(stderr, "WARNING: %s\n", msg);
+}
+
+static void fileNameCallback(void *userData, std::string& fileName)
+{
+  (void) userData;
+  fileName = contentFileName;
+}
+
+static uint32_t hashBytes(uint32_t h, const unsigned char *buf, size_t nBytes)
+{
+  // FNV-1a
+  for (size_t i = 0; i < nBytes; i++) {
+    h = h ^ uint32_t(buf[i]);
+    h = h * 0x01000193U;
+  }
+  return h;
+}
+
+static std::string parseStartSequence(const char *s)
+{
+  std::string seq;
+  while (*s != '\0') {
+    if (*s == '\\' && s[1] != '\0') {
+      s++;
+      if (*s == 'r') {
+        seq += '\r';
+      }
+      else if (*s == 'n') {
+        seq += '\n';
+      }
+      else if (*s == 'x' &&
+               std::strchr("0123456789ABCDEFabcdef", s[1]) && s[1] != '\0') {
+        char    tmp[3];
+        tmp[0] = s[1];
+        tmp[1] = '\0';
+        tmp[2] = '\0';
+        s++;
+        if (s[1] != '\0' && std::strchr("0123456789ABCDEFabcdef", s[1])) {
+          tmp[1] = s[1];
+          s++;
+        }
+        seq += char(std::strtol(&(tmp[0]), (char **) 0, 16));
+      }
+      else {
+        seq += *s;
+      }
+    }
+    else {
+      seq += *s;
+    }
+    s++;
+  }
+  return seq;
+}
+
+static void loadInputScript(std::vector< BenchInputEvent >& events,
+                            const char *fileName)
+{
+  std::FILE *f = Ep128Emu::fileOpen(fileName, "rb");
+  if (!f)
+    throw Ep128Emu::Exception("error opening input script");
+  char    lineBuf[256];
+  while (std::fgets(&(lineBuf[0]), 256, f)) {
+    char    *s = &(lineBuf[0]);
+    while (*s == ' ' || *s == '\t')
+      s++;
+    if (*s == '#' || *s == '\r' || *s == '\n' || *s == '\0')
+      continue;
+    char    *endp = (char *) 0;
+    long    frame = std::strtol(s, &endp, 0);
+    long    keyCode = std::strtol(endp, &endp, 0);
+    long    state = std::strtol(endp, &endp, 0);
+    if (frame < 0L || keyCode < 0L || keyCode > 127L) {
+      std::fclose(f);
+      throw Ep128Emu::Exception("invalid line in input script");
+    }
+    BenchInputEvent evt;
+    evt.frame = uint32_t(frame);
+    evt.keyCode = uint8_t(keyCode);
+    evt.isPressed = (state != 0L);
+    events.push_back(evt);
+  }
+  std::fclose(f);
+  std::stable_sort(events.begin(), events.end());
+}
+
+static void printUsage(const char *progName)
+{
+  std::fprintf(stderr,
+               "usage: %s [options] [content file]\n"
+               "  -m TYPE     machine type (default: EP128_DISK)\n"
+               "  -r DIR      ROM directory (default: .)\n"
+               "  -c FILE     machine configuration file\n"
+               "  -d FILE     demo or snapshot file\n"
+               "  -s SEQ      start sequence (\\r, \\\\, \\xNN escapes)\n"
+               "  -i FILE     input script (\"frame keycode state\" lines)\n"
+               "  -n SECONDS  emulated seconds to run (default: 60)\n"
+               "  -a FRAMES   frames to run ahead (default: 0)\n"
+               "  -p COUNT    run COUNT machines on a worker pool\n"
+               "  -j THREADS  worker threads for -p (default: CPU cores)\n"
+               "  -f          frame aligned mode\n"
+               "  -k N        draw only every Nth frame (default: 1)\n"
+               "  -l MS       audio latency (default: 18 ms)\n"
+               "  -S COUNT    time COUNT snapshots saved at the end\n"
+               "  -v          verbose log\n",
+               progName);
+}
+
+// creates and sets up a core, and leaves the emulation thread locked
+static Ep128Emu::LibretroCore * createCore(const std::string& machineTypeName,
+                                           const std::string& romDirectory,
+                                           const std::string& cfgFileName,
+                                           const std::string& demoFileName,
+                                           const std::string& startSequence,
+                                           const std::string& contentPath,
+                                           int runAheadFrames,
+                                           bool createThreads)
+{
+  Ep128Emu::LibretroCore  *core = new Ep128Emu::LibretroCore(
+      &benchLog, Ep128Emu::VM_config.at(machineTypeName),
+      Ep128Emu::LOCALE_UK, false, romDirectory.c_str(), "",
+      startSequence.c_str(), cfgFileName.c_str(), false, false,
+      createThreads);
+  try {
+    Ep128Emu::EmulatorConfiguration&  config = *(core->config);
+    config.setErrorCallback(&cfgErrorFunc, (void *) 0);
+    core->runAheadFrames = runAheadFrames;
+    bool    startTape = false;
+    if (contentPath != "") {
+      if (machineTypeName.find("_DISK") != std::string::npos) {
+        config.floppy.a.imageFile = contentPath;
+        config.floppyAChanged = true;
+      }
+      else if (machineTypeName.find("_TAPE") != std::string::npos) {
+        config.tape.imageFile = contentPath;
+        config.tapeFileChanged = true;
+        startTape = (core->machineType != Ep128Emu::MACHINE_ZX &&
+                     !config.tape.forceMotorOn);
+      }
+      else {
+        std::string dirName;
+        std::string baseName;
+        Ep128Emu::splitPath(contentPath, dirName, baseName);
+        contentFileName = dirName + baseName;
+        config.fileio.workingDirectory = dirName;
+        core->vm->setFileNameCallback(&fileNameCallback, (void *) 0);
+        config.fileioSettingsChanged = true;
+        config.vm.enableFileIO = true;
+        config.vmConfigurationChanged = true;
+      }
+    }
+    config.applySettings();
+    if (startTape)
+      core->vm->tapePlay();
+
+    // the emulation thread is kept blocked, and the VM is run from here
+    Ep128Emu::VMThread& vmThread = *(core->vmThread);
+    if (vmThread.lock(0x7FFFFFFF) != 0)
+      throw Ep128Emu::Exception("error locking emulation thread");
+    if (demoFileName != "") {
+      Ep128Emu::File  f(demoFileName.c_str());
+      core->vm->registerChunkTypes(f);
+      f.processAllChunks();
+      config.applySettings();
+      core->startSequenceIndex = core->startSequence.length();
+    }
+    vmThread.setSpeedPercentage(0);
+    vmThread.pause(false);
+#ifdef EP128EMU_USE_XRGB8888
+    core->w->frame_bufActive = (uint32_t *) core->w->frame_buf1;
+#else
+    core->w->frame_bufActive = (uint16_t *) core->w->frame_buf1;
+#endif // EP128EMU_USE_XRGB8888
+  }
+  catch (...) {
+    delete core;
+    throw;
+  }
+  return core;
+}
+
+int main(int argc, char **argv)
+{
+  std::string machineTypeName = "EP128_DISK";
+  std::string romDirectory = ".";
+  std::string cfgFileName = "";
+  std::string demoFileName = "";
+  std::string startSequence = "";
+  std::string inputScriptName = "";
+  std::string contentPath = "";
+  double      emulatedSeconds = 60.0;
+  int         runAheadFrames = 0;
+  int         nMachines = 0;
+  int         nWorkers = 0;
+  bool        frameAligned = false;
+  int         frameSkip = 1;
+  int         audioLatency = -1;
+  int         nSnapshots = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg == "-v") {
+      verboseLog = true;
+    }
+    else if (arg == "-f") {
+      frameAligned = true;
+    }
+    else if (arg.length() == 2 && arg[0] == '-' &&
+             std::strchr("mrcdsinapjklS", arg[1]) && (i + 1) < argc) {
+      i++;
+      switch (arg[1]) {
+      case 'm':
+        machineTypeName = argv[i];
+        break;
+      case 'r':
+        romDirectory = argv[i];
+        break;
+      case 'c':
+        cfgFileName = argv[i];
+        break;
+      case 'd':
+        demoFileName = argv[i];
+        break;
+      case 's':
+        startSequence = parseStartSequence(argv[i]);
+        break;
+      case 'i':
+        inputScriptName = argv[i];
+        break;
+      case 'n':
+        emulatedSeconds = std::atof(argv[i]);
+        break;
+      case 'a':
+        runAheadFrames = std::atoi(argv[i]);
+        break;
+      case 'p':
+        nMachines = std::atoi(argv[i]);
+        break;
+      case 'j':
+        nWorkers = std::atoi(argv[i]);
+        break;
+      case 'k':
+        frameSkip = std::atoi(argv[i]);
+        break;
+      case 'l':
+        audioLatency = std::atoi(argv[i]);
+        break;
+      case 'S':
+        nSnapshots = std::atoi(argv[i]);
+        break;
+      }
+    }
+    else if (arg.length() > 0 && arg[0] != '-' && contentPath == "") {
+      contentPath = arg;
+    }
+    else {
+      printUsage(argv[0]);
+      return -1;
+    }
+  }
+  if (Ep128Emu::VM_config.find(machineTypeName) == Ep128Emu::VM_config.end() ||
+      machineTypeName == "VM_CONFIG_AUTO" ||
+      machineTypeName == "VM_CONFIG_UNKNOWN" || !(emulatedSeconds > 0.0) ||
+      runAheadFrames < 0 || nMachines < 0 || nWorkers < 0 || frameSkip < 1 ||
+      nSnapshots < 0 ||
+      (nMachines > 0 && (runAheadFrames > 0 || frameAligned))) {
+    printUsage(argv[0]);
+    return -1;
+  }
+#ifdef WIN32
+  if (romDirectory == "" || romDirectory[romDirectory.length() - 1] != '\\')
+    romDirectory += '\\';
+#else
+  if (romDirectory == "" || romDirectory[romDirectory.length() - 1] != '/')
+    romDirectory += '/';
+#endif
+
+  Ep128Emu::Timer::setFixedRandomSeed(0x4550800AU);
+  // without -p, a single machine is run from the main thread
+  bool    usePool = (nMachines > 0);
+  std::vector< BenchMachine > machines(size_t(usePool ? nMachines : 1));
+  Ep128Emu::VMScheduler *scheduler = (Ep128Emu::VMScheduler *) 0;
+  int     retval = 0;
+  try {
+    std::vector< BenchInputEvent >  inputEvents;
+    if (inputScriptName != "")
+      loadInputScript(inputEvents, inputScriptName.c_str());
+    if (usePool)
+      scheduler = new Ep128Emu::VMScheduler(nWorkers);
+    for (size_t k = 0; k < machines.size(); k++) {
+      // the same random seed is used for each machine, so that the
+      // results are identical
+      Ep128Emu::Timer::setFixedRandomSeed(0x4550800AU);
+      machines[k].core =
+          createCore(machineTypeName, romDirectory, cfgFileName,
+                     demoFileName, startSequence, contentPath,
+                     runAheadFrames, !usePool);
+      machines[k].wasPlayingDemo = machines[k].core->vm->getIsPlayingDemo();
+      if (frameAligned)
+        machines[k].core->set_frame_aligned(true);
+      machines[k].core->w->frameSkip = frameSkip;
+      if (audioLatency >= 0) {
+        dynamic_cast< Ep128Emu::AudioOutput_libretro * >(
+            machines[k].core->audioOutput)->setLatency(
+                size_t(audioLatency * EP128EMU_SAMPLE_RATE / 1000));
+      }
+      if (scheduler)
+        scheduler->addVM(*(machines[k].core->vmThread));
+    }
+
+    const size_t  frameTime = 1000000 / 50;
+    size_t  nFrames = size_t(emulatedSeconds * 50.0 + 0.5);
+    nFrames = (nFrames > 0 ? nFrames : 1);
+    double  expectedAudioFrames =
+        double(frameTime) * EP128EMU_SAMPLE_RATE_FLOAT / 1000000.0;
+    if (frameAligned)
+      expectedAudioFrames = -1.0;
+    uint64_t  startTime = machines[0].core->vmThread->getEmulatedTime();
+    size_t  unalignedFrameCnt = 0;
+    std::vector< int16_t >  audioBuffer(size_t(EP128EMU_AUDIO_FRAMES_MAX) * 2);
+    std::vector< double >   frameTimes(nFrames);
+    Ep128Emu::Timer totalTimer;
+    Ep128Emu::Timer frameTimer;
+    for (size_t i = 0; i < nFrames; i++) {
+      frameTimer.reset();
+      for (size_t k = 0; k < machines.size(); k++) {
+        BenchMachine& m = machines[k];
+        Ep128Emu::VMThread& vmThread = *(m.core->vmThread);
+        while (m.inputEventIndex < inputEvents.size() &&
+               inputEvents[m.inputEventIndex].frame <= uint32_t(i)) {
+          uint8_t keyEvent =
+              uint8_t((inputEvents[m.inputEventIndex].keyCode & 0x7F)
+                      | (inputEvents[m.inputEventIndex].isPressed ?
+                         0x80 : 0x00));
+          vmThread.setKeyboardState(&keyEvent, 1, vmThread.getInputTime());
+          m.inputEventIndex++;
+        }
+        m.core->update_input(&benchInputState, &benchEnvironment,
+                             EP128EMU_MAX_USERS);
+      }
+      if (scheduler) {
+        scheduler->runFor(frameTime);
+      }
+      else {
+        Ep128Emu::LibretroCore  *core = machines[0].core;
+        Ep128Emu::VMThread& vmThread = *(core->vmThread);
+        uint32_t  prvFrameCount = core->w->frameCount;
+        vmThread.allowRunFor(size_t(core->get_run_time(frameTime)));
+        while (!vmThread.isReady()) {
+          if (!vmThread.process())
+            throw Ep128Emu::Exception("emulation thread terminated");
+        }
+        if ((core->w->frameCount - prvFrameCount) != 1U)
+          unalignedFrameCnt++;
+        if (runAheadFrames > 0)
+          core->run_ahead(frameTime);
+      }
+      for (size_t k = 0; k < machines.size(); k++) {
+        BenchMachine& m = machines[k];
+        m.core->sync_display();
+        size_t  n = 0;
+        m.core->audioOutput->forwardAudioData(&(audioBuffer.front()), &n,
+                                              expectedAudioFrames);
+        for (size_t j = 0; j < (n << 1); j++) {
+          unsigned char tmp[2];
+          tmp[0] = (unsigned char) (uint16_t(audioBuffer[j]) & 0xFF);
+          tmp[1] = (unsigned char) (uint16_t(audioBuffer[j]) >> 8);
+          m.audioHash = hashBytes(m.audioHash, &(tmp[0]), 2);
+        }
+        m.audioFrameCnt += n;
+        videoData = (const void *) 0;
+        m.core->render(&benchVideoRefresh, &benchEnvironment);
+        if (m.wasPlayingDemo && !m.core->vm->getIsPlayingDemo()) {
+          m.wasPlayingDemo = false;
+          m.demoEndFrame = i + 1;
+        }
+        if ((i + 1) < nFrames || !videoData)
+          continue;
+        // make sure that the display thread has finished the last frame
+        for (int j = 0; j < 3; j++)
+          m.core->sync_display();
+        size_t  bytesPerPixel = sizeof(*(m.core->w->frame_bufActive));
+        m.frameHash = 0x811C9DC5U;
+        m.frameWidth = videoWidth;
+        m.frameHeight = videoHeight;
+        for (unsigned y = 0U; y < videoHeight; y++) {
+          m.frameHash = hashBytes(m.frameHash,
+                                  reinterpret_cast< const unsigned char * >(
+                                      videoData) + (size_t(y) * videoPitch),
+                                  size_t(videoWidth) * bytesPerPixel);
+        }
+      }
+      frameTimes[i] = frameTimer.getRealTime();
+    }
+    double  wallTime = totalTimer.getRealTime();
+    double  snapshotTime = 0.0;
+    size_t  snapshotSize = 0;
+    if (nSnapshots > 0) {
+      std::vector< unsigned char >  snapshotData(EP128EMU_SNAPSHOT_SIZE);
+      Ep128Emu::File::Buffer  snapshotArena;
+      Ep128Emu::Timer snapshotTimer;
+      for (int j = 0; j < nSnapshots; j++) {
+        Ep128Emu::File  f;
+        f.swapBuffer(snapshotArena);
+        machines[0].core->vm->saveState(f);
+        snapshotSize = f.getBufferDataSize();
+        f.writeMem(&(snapshotData.front()), snapshotData.size());
+        f.swapBuffer(snapshotArena);
+      }
+      snapshotTime = snapshotTimer.getRealTime() / double(nSnapshots);
+    }
+    for (size_t k = 0; k < machines.size(); k++)
+      machines[k].core->log_memory_usage();
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    double  emulatedTime = double(nFrames) * double(frameTime) / 1000000.0;
+    if (frameAligned) {
+      emulatedTime =
+          double(machines[0].core->vmThread->getEmulatedTime() - startTime)
+          / 1000000.0;
+    }
+    std::printf("machine:          %s\n", machineTypeName.c_str());
+    if (scheduler) {
+      std::printf("machines:         %d on %d worker threads\n",
+                  nMachines, scheduler->getWorkerCount());
+    }
+    std::printf("frames:           %lu\n", (unsigned long) nFrames);
+    std::printf("emulated time:    %.3f s\n", emulatedTime);
+    std::printf("wall time:        %.3f s\n", wallTime);
+    std::printf("speed:            %.3f emulated s / wall s\n",
+                (wallTime > 0.0 ?
+                 (emulatedTime * double(machines.size()) / wallTime) : 0.0));
+    std::printf("frame time (ms):  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+                frameTimes[(nFrames - 1) * 50 / 100] * 1000.0,
+                frameTimes[(nFrames - 1) * 90 / 100] * 1000.0,
+                frameTimes[(nFrames - 1) * 99 / 100] * 1000.0,
+                frameTimes[nFrames - 1] * 1000.0);
+    if (nSnapshots > 0) {
+      std::printf("snapshot:         %lu bytes, %.3f ms\n",
+                  (unsigned long) snapshotSize, snapshotTime * 1000.0);
+    }
+    if (frameAligned) {
+      std::printf("refresh rate:     %.3f Hz, %lu unaligned frames\n",
+                  machines[0].core->get_refresh_rate(),
+                  (unsigned long) unalignedFrameCnt);
+    }
+    for (size_t k = 0; k < machines.size(); k++) {
+      BenchMachine& m = machines[k];
+      if (scheduler) {
+        Ep128Emu::VMScheduler::VMStats  st;
+        scheduler->getVMStats(int(k), st);
+        std::printf("machine %lu:\n", (unsigned long) k);
+        std::printf("  throughput:     %.3f emulated s / run s, "
+                    "%lu slices, %lu migrations\n",
+                    (st.runTime > 0.0 ?
+                     (double(st.emulatedTime) / 1000000.0 / st.runTime) : 0.0),
+                    (unsigned long) st.sliceCnt,
+                    (unsigned long) st.migrationCnt);
+      }
+      if (demoFileName != "") {
+        if (m.demoEndFrame > 0)
+          std::printf("demo ended:       frame %lu\n",
+                      (unsigned long) m.demoEndFrame);
+        else
+          std::printf("demo ended:       no\n");
+      }
+      // instructions per second of wall time, or of the time spent running
+      // this machine on the worker pool
+      uint64_t  instructionCnt = m.core->vm->getInstructionCount();
+      double    runTime = wallTime;
+      if (scheduler) {
+        Ep128Emu::VMScheduler::VMStats  st;
+        scheduler->getVMStats(int(k), st);
+        runTime = st.runTime;
+      }
+      std::printf("instructions:     %lu, %.3f M/s emulated, %.3f M/s run\n",
+                  (unsigned long) instructionCnt,
+                  double(instructionCnt) / emulatedTime / 1000000.0,
+                  (runTime > 0.0 ?
+                   (double(instructionCnt) / runTime / 1000000.0) : 0.0));
+      std::printf("framebuffer:      %ux%u hash %08X\n",
+                  m.frameWidth, m.frameHeight, (unsigned int) m.frameHash);
+      std::printf("audio:            %lu frames hash %08X\n",
+                  (unsigned long) m.audioFrameCnt, (unsigned int) m.audioHash);
+      Ep128Emu::AudioOutput_libretro  *audioOutput_ =
+          dynamic_cast< Ep128Emu::AudioOutput_libretro * >(
+              m.core->audioOutput);
+      std::printf("audio buffer:     %lu frames latency, "
+                  "%lu underruns, %lu overruns\n",
+                  (unsigned long) audioOutput_->getLatency(),
+                  (unsigned long) audioOutput_->getUnderrunCount(),
+                  (unsigned long) audioOutput_->getOverrunCount());
+    }
+  }
+  catch (std::exception& e) {
+    std::fprintf(stderr, "%s: error: %s\n", argv[0], e.what());
+    retval = -1;
+  }
+  if (scheduler)
+    delete scheduler;
+  for (size_t k = 0; k < machines.size(); k++) {
+    if (machines[k].core)
+      delete machines[k].core;
+  }
+  return retval;
+}
@@ -19,14 +19,17 @@
 #include "core.hpp"
 #include "libretro_keys_reverse.h"
 #include "roms/roms.hpp"
+#include "romcache.hpp"
 namespace Ep128Emu {
 
 LibretroCore::LibretroCore(retro_log_printf_t log_cb_, int machineDetailedType_, int contentLocale, bool canSkipFrames_, const char* romDirectory_, const char* saveDirectory_,
-                           const char* startSequence_, const char* cfgFile, bool useHalfFrame_, bool enhancedRom)
+                           const char* startSequence_, const char* cfgFile, bool useHalfFrame_, bool enhancedRom, bool createThreads)
   : log_cb(log_cb_),
     autofireFrame(0),
     autofireButtonId(256),
     autofireFrameCycle(1),
+    joypadMappingsChanged(true),
+    inputBitmasks(-1),
     useHalfFrame(useHalfFrame_),
     isHalfFrame(useHalfFrame_),
     canSkipFrames(canSkipFrames_),
@@ -39,6 +42,14 @@ LibretroCore::LibretroCore(retro_log_printf_t log_cb_, int machineDetailedType_,
     defaultHalfHeight(EP128EMU_LIBRETRO_SCREEN_HEIGHT/2),
     defaultWidth(EP128EMU_LIBRETRO_SCREEN_WIDTH),
     borderSize(0),
+    runAheadFrames(0),
+    runAheadLead(0),
+    frameAligned(false),
+    alignStartTime(0),
+    alignStartLine(0),
+    alignStartFrame(0),
+    alignVsyncLine(0),
+    alignVsyncFrame(0),
     machineType(MACHINE_EP),
     machineDetailedType(machineDetailedType_),
     totalTime(0),
@@ -89,7 +100,7 @@ LibretroCore::LibretroCore(retro_log_printf_t log_cb_, int machineDetailedType_,
 
   audioOutput = new Ep128Emu::AudioOutput_libretro();
   //audioOutput->setOutputFile("/tmp/core_sound.wav");
-  w = new Ep128Emu::LibretroDisplay(32, 32, EP128EMU_LIBRETRO_SCREEN_WIDTH, EP128EMU_LIBRETRO_SCREEN_HEIGHT, "", useHalfFrame);
+  w = new Ep128Emu::LibretroDisplay(32, 32, EP128EMU_LIBRETRO_SCREEN_WIDTH, EP128EMU_LIBRETRO_SCREEN_HEIGHT, "", useHalfFrame, createThreads);
   if(machineType == MACHINE_TVC)
   {
     vm = new TVC64::TVC64VM(*(dynamic_cast<Ep128Emu::VideoDisplay *>(w)),
@@ -515,7 +526,7 @@ LibretroCore::LibretroCore(retro_log_printf_t log_cb_, int machineDetailedType_,
   log_cb(RETRO_LOG_DEBUG, "Applying settings\n");
   config->applySettings();
 
-  vmThread = new Ep128Emu::VMThread(*vm);
+  vmThread = new Ep128Emu::VMThread(*vm, (void *) 0, createThreads);
 }
 
 LibretroCore::~LibretroCore()
@@ -543,8 +554,10 @@ void LibretroCore::initialize_keyboard_map(void)
     for(int i=0; i<256; i++)
     {
       inputJoyMap[i][port] = -1;
+      inputStateMap[i][port] = false;
     }
   }
+  joypadMappingsChanged = true;
 
   libretro_to_ep128emu_kbmap[RETROK_n]         = 0x00;
   libretro_to_ep128emu_kbmap[RETROK_OEM_102]   = 0x01; // positional mapping for ISO keyboard: kb í -> EP \ backslash
@@ -855,6 +868,8 @@ void LibretroCore::initialize_joystick_map(std::string zoomKey, std::string info
     }
   }
 
+  joypadMappingsChanged = true;
+
   // Fill the info text.
   infoMessage += ", button map: ";
   for (int j=0; j<12; j++)
@@ -884,6 +899,7 @@ void LibretroCore::initialize_joystick_map(std::string zoomKey, std::string info
 void LibretroCore::update_joystick_map(const unsigned char * joystickCodes, int port, int length)
 {
   reset_joystick_map(port);
+  joypadMappingsChanged = true;
   inputJoyMap[joystickCodes[0]][port] = RETRO_DEVICE_ID_JOYPAD_UP;
   inputJoyMap[joystickCodes[1]][port] = RETRO_DEVICE_ID_JOYPAD_DOWN;
   inputJoyMap[joystickCodes[2]][port] = RETRO_DEVICE_ID_JOYPAD_LEFT;
@@ -897,6 +913,7 @@ void LibretroCore::update_joystick_map(const unsigned char * joystickCodes, int
 
 void LibretroCore::reset_joystick_map(int port, unsigned value)
 {
+  joypadMappingsChanged = true;
   for(int i=0; i<255; i++)
   {
     if((unsigned)inputJoyMap[i][port] == value)
@@ -906,6 +923,7 @@ void LibretroCore::reset_joystick_map(int port, unsigned value)
 
 void LibretroCore::reset_joystick_map(int port)
 {
+  joypadMappingsChanged = true;
   for(int i=1; i<JOY_TYPE_AMOUNT; i++)
   {
     // reset only the one that was set previously
@@ -931,7 +949,9 @@ void LibretroCore::update_keyboard(bool down, unsigned keycode, uint32_t charact
   int convertedKeycode = config->convertKeyCode(keycode);
   if (convertedKeycode >= 0)
   {
-    vmThread->setKeyboardState((uint8_t)convertedKeycode,down);
+    // applied at the start of the next frame, independently of thread timing
+    uint8_t keyEvent = (uint8_t)((convertedKeycode & 0x7F) | (down ? 0x80 : 0));
+    vmThread->setKeyboardState(&keyEvent, 1, vmThread->getInputTime());
   } else if (down && keycode == RETROK_F12) {
     w->scanBorders = true;
   }
@@ -940,76 +960,135 @@ void LibretroCore::update_keyboard(bool down, unsigned keycode, uint32_t charact
   // to match with up events
 }
 
+void LibretroCore::update_joypad_mappings(void)
+{
+  joypadMappings.clear();
+  for(int port=0; port<EP128EMU_MAX_USERS; port++)
+  {
+    joypadButtonsUsed[port] = 0;
+    for(int i=0; i<256; i++)
+    {
+      // RETRO_DEVICE_ID_JOYPAD_MASK has one bit for each of the 16 buttons
+      if(inputJoyMap[i][port] >= 0 && inputJoyMap[i][port] < 16)
+      {
+        JoypadMapping m;
+        m.epKey = (uint8_t)i;
+        m.port = (uint8_t)port;
+        m.buttonId = (uint8_t)inputJoyMap[i][port];
+        joypadMappings.push_back(m);
+        joypadButtonsUsed[port] |= (uint16_t)(1 << m.buttonId);
+      }
+    }
+  }
+  joypadMappingsChanged = false;
+}
+
 void LibretroCore::update_input(retro_input_state_t input_state_cb, retro_environment_t environ_cb, unsigned maxUsers)
 {
-  int i;
   unsigned port;
   bool currInputState;
   unsigned scanLimit = maxUsers < EP128EMU_MAX_USERS ? maxUsers : EP128EMU_MAX_USERS;
+  uint16_t buttonState[EP128EMU_MAX_USERS];
+  // key changes are collected and sent to the VM thread in one batch
+  uint8_t keyEvents[64];
+  size_t nKeyEvents = 0;
+  // emulated time at the start of the next frame
+  uint64_t inputTime = vmThread->getInputTime();
+
+  if (joypadMappingsChanged)
+    update_joypad_mappings();
+  if (inputBitmasks < 0)
+    inputBitmasks = environ_cb(RETRO_ENVIRONMENT_GET_INPUT_BITMASKS, NULL) ? 1 : 0;
 
+  // Poll each port once, or once per used button if bitmasks are not supported.
   for(port=0; port<scanLimit; port++)
   {
-    for(i=0; i<256; i++)
+    buttonState[port] = 0;
+    if (!joypadButtonsUsed[port])
+      continue;
+    if (inputBitmasks)
     {
-      if(inputJoyMap[i][port]>=0)
+      buttonState[port] = (uint16_t)input_state_cb(port, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_MASK);
+    }
+    else
+    {
+      for(unsigned b=0; b<16; b++)
       {
-        currInputState = input_state_cb(port, RETRO_DEVICE_JOYPAD, 0, inputJoyMap[i][port]);
-        if (currInputState && !inputStateMap[i][port])
+        if ((joypadButtonsUsed[port] & (1 << b)) && input_state_cb(port, RETRO_DEVICE_JOYPAD, 0, b))
+          buttonState[port] |= (uint16_t)(1 << b);
+      }
+    }
+  }
+
+  for(size_t n=0; n<joypadMappings.size(); n++)
+  {
+    const JoypadMapping& m = joypadMappings[n];
+    int i = m.epKey;
+    port = m.port;
+    if (port >= scanLimit)
+      break;
+    if (nKeyEvents > sizeof(keyEvents) - 2)
+    {
+      vmThread->setKeyboardState(keyEvents, nKeyEvents, inputTime);
+      nKeyEvents = 0;
+    }
+    currInputState = ((buttonState[port] >> m.buttonId) & 1) != 0;
+    if (currInputState && !inputStateMap[i][port])
+    {
+      // Joystick map codes below 0x80 are interpreted as keyboard state
+      // including all joystick types (int, ext)
+      if(i<128)
+      {
+        keyEvents[nKeyEvents++] = (uint8_t)(i | 0x80);
+      }
+      // All other codes are interpreted by the libretro core itself.
+      else
+      {
+        if(i == EPKEY_INFO)
         {
-          // Joystick map codes below 0x80 are interpreted as keyboard state
-          // including all joystick types (int, ext)
-          if(i<128)
+          struct retro_message message;
+          std::string longMsg = "Wait for end of startup sequence... ";
+          if (startSequenceIndex < startSequence.length())
           {
-            vmThread->setKeyboardState(i,true);
+            longMsg += infoMessage;
+            message.msg = longMsg.c_str();
           }
-          // All other codes are interpreted by the libretro core itself.
           else
           {
-            if(i == EPKEY_INFO)
-            {
-              struct retro_message message;
-              std::string longMsg = "Wait for end of startup sequence... ";
-              if (startSequenceIndex < startSequence.length())
-              {
-                longMsg += infoMessage;
-                message.msg = longMsg.c_str();
-              }
-              else
-              {
-                message.msg = infoMessage.c_str();
-              }
-              message.frames = EP128EMU_MESSAGE_DISPLAY_FRAMES;
-              environ_cb(RETRO_ENVIRONMENT_SET_MESSAGE, &message);
-            }
-            if(i == EPKEY_ZOOM)
-            {
-              w->scanBorders = true;
-            }
-            // EPKEY_NONE does nothing.
+            message.msg = infoMessage.c_str();
           }
+          message.frames = EP128EMU_MESSAGE_DISPLAY_FRAMES;
+          environ_cb(RETRO_ENVIRONMENT_SET_MESSAGE, &message);
         }
-        else if (inputStateMap[i][port] && !currInputState)
+        if(i == EPKEY_ZOOM)
         {
-          if(i<128)
-            vmThread->setKeyboardState(i,false);
+          w->scanBorders = true;
         }
-        // autofire - button is pressed already
-        else if (inputJoyMap[i][port] == (int)autofireButtonId && inputStateMap[i][port] && currInputState) {
-          bool shouldFire =    (w->frameCount >= autofireFrame + 2*autofireFrameCycle) ? true        : false;
-          bool shouldRelease = (w->frameCount >= autofireFrame +   autofireFrameCycle) ? !shouldFire : false;
-          if(shouldFire) {
-            autofireFrame = w->frameCount;
-            vmThread->setKeyboardState(i,true);
-          }
-          if(shouldRelease) {
-            vmThread->setKeyboardState(i,false);
-          }
-        }
-
-        inputStateMap[i][port] = currInputState;
+        // EPKEY_NONE does nothing.
       }
     }
+    else if (inputStateMap[i][port] && !currInputState)
+    {
+      if(i<128)
+        keyEvents[nKeyEvents++] = (uint8_t)i;
+    }
+    // autofire - button is pressed already
+    else if (m.buttonId == autofireButtonId && inputStateMap[i][port] && currInputState) {
+      bool shouldFire =    (w->frameCount >= autofireFrame + 2*autofireFrameCycle) ? true        : false;
+      bool shouldRelease = (w->frameCount >= autofireFrame +   autofireFrameCycle) ? !shouldFire : false;
+      if(shouldFire) {
+        autofireFrame = w->frameCount;
+        keyEvents[nKeyEvents++] = (uint8_t)((i & 0x7F) | 0x80);
+      }
+      if(shouldRelease) {
+        keyEvents[nKeyEvents++] = (uint8_t)(i & 0x7F);
+      }
+    }
+
+    inputStateMap[i][port] = currInputState;
   }
+  if (nKeyEvents > 0)
+    vmThread->setKeyboardState(keyEvents, nKeyEvents, inputTime);
   // startSequence handling.
   // Send keyboard input at specific frames (down presses)
   if (startSequenceIndex < startSequence.length())
@@ -1124,14 +1203,14 @@ void LibretroCore::render(retro_video_refresh_t video_cb, retro_environment_t en
   }
   unsigned stride  = currWidth;
 
-  if (canSkipFrames && prevFrameCount == w->frameCount)
+  if (canSkipFrames && prevFrameCount == w->drawnFrameCount)
   {
     log_cb(RETRO_LOG_DEBUG, "frame dupe %d \n",prevFrameCount);
     video_cb(NULL, 0, 0, 0);
   }
   else
   {
-    prevFrameCount = w->frameCount;
+    prevFrameCount = w->drawnFrameCount;
     {
       // Video callback, stride depends on pixel format (4 byte / 2 byte)
 #ifdef EP128EMU_USE_XRGB8888
@@ -1201,7 +1280,7 @@ void LibretroCore::run_for(retro_usec_t frameTime, float waitPeriod, void * fb)
 #endif // EP128EMU_USE_XRGB8888
   }
 
-  vmThread->allowRunFor(frameTime);
+  vmThread->allowRunFor(get_run_time(frameTime));
   do
   {
     w->wakeDisplay(false);
@@ -1210,6 +1289,127 @@ void LibretroCore::run_for(retro_usec_t frameTime, float waitPeriod, void * fb)
       Timer::wait(waitPeriod);
   }
   while(true);
+  if (runAheadFrames > 0 && vmThread->lock(0x7FFFFFFF) == 0)
+  {
+    run_ahead(frameTime);
+    vmThread->unlock();
+  }
+}
+
+// After frames run ahead were kept, run less in the following frames
+// (at most half of each) until the emulated time is back in sync.
+// In frame aligned mode, run until one and a half lines after the next vsync,
+// so that the end of the run stays after the vsync even if the length of the
+// frame changes by a line (interlace), and the frame time of the frontend
+// is only used until the line period and frame length are known.
+retro_usec_t LibretroCore::get_run_time(retro_usec_t frameTime)
+{
+  if (frameAligned)
+  {
+    // the frames kept by run-ahead are taken into account by aligning to
+    // the next vsync
+    runAheadLead = 0;
+    if (alignVsyncFrame == alignStartFrame && w->frameCount != alignStartFrame)
+    {
+      alignVsyncLine = w->frameStartLine;
+      alignVsyncFrame = w->frameCount;
+    }
+    uint64_t t = vmThread->getEmulatedTime() - alignStartTime;
+    uint32_t nLines = w->lineCount - alignStartLine;
+    if (w->frameLines == 0 || nLines == 0 || t == 0)
+      return frameTime;
+    double linePeriod = double(t) / double(nLines);
+    double linesLeft = double(int(w->frameLines) - int(w->lineCount - w->frameStartLine));
+    linesLeft = (linesLeft > 0.0 ? linesLeft : 0.0) + 1.5;
+    retro_usec_t runTime = retro_usec_t(linesLeft * linePeriod + 0.5);
+    // limit the run time if the frame length has changed a lot, the next
+    // frames will be aligned again
+    if (runTime < (frameTime >> 2))
+      runTime = frameTime >> 2;
+    else if (runTime > (frameTime << 1))
+      runTime = frameTime << 1;
+    return runTime;
+  }
+  retro_usec_t t = runAheadLead < (frameTime >> 1) ? runAheadLead : (frameTime >> 1);
+  runAheadLead -= t;
+  return frameTime - t;
+}
+
+// Run the emulation ahead by runAheadFrames frames, so that the displayed
+// frame reflects the input of the current frame, then restore the state.
+// The emulation thread must be locked.
+void LibretroCore::run_ahead(retro_usec_t frameTime)
+{
+  if (runAheadLead > 0 || !vm->getIsStateForkAllowed())
+    return;
+  Ep128Emu::AudioOutput_libretro *audioOutput_ =
+    dynamic_cast<Ep128Emu::AudioOutput_libretro *>(audioOutput);
+  try
+  {
+    // finish the current frame first, if the emulation thread has not
+    if (!vmThread->runLocked())
+      return;
+    LibretroDisplay::ScanPosition scanPosition;
+    size_t audioBufIndex, audioWritePos;
+    w->getScanPosition(scanPosition);
+    audioOutput_->getWritePosition(audioBufIndex, audioWritePos);
+    stateFork.beginSave();
+    vmThread->forkState(stateFork);
+    for (int i = 0; i < runAheadFrames; i++)
+    {
+      vmThread->allowRunFor(frameTime);
+      if (!vmThread->runLocked(true))
+        return;
+      if (!vm->getIsStateForkAllowed())
+      {
+        // tape, disk or file I/O was started, which cannot be undone:
+        // keep the frames already run
+        runAheadLead += retro_usec_t(i + 1) * frameTime;
+        return;
+      }
+    }
+    stateFork.beginRestore();
+    vmThread->forkState(stateFork);
+    w->setScanPosition(scanPosition);
+    audioOutput_->setWritePosition(audioBufIndex, audioWritePos);
+  }
+  catch (std::exception& e)
+  {
+    log_cb(RETRO_LOG_ERROR, "Run-ahead disabled: %s\n", e.what());
+    runAheadFrames = 0;
+  }
+}
+
+void LibretroCore::set_frame_aligned(bool enabled)
+{
+  if (enabled == frameAligned)
+    return;
+  frameAligned = enabled;
+  vmThread->setExactRunTime(enabled);
+  if (enabled)
+  {
+    // the emulation thread is idle between run_for() calls
+    alignStartTime = vmThread->getEmulatedTime();
+    alignStartLine = w->lineCount;
+    alignStartFrame = w->frameCount;
+    alignVsyncLine = alignStartLine;
+    alignVsyncFrame = alignStartFrame;
+  }
+}
+
+double LibretroCore::get_refresh_rate(void)
+{
+  if (!frameAligned)
+    return 0.0;
+  uint64_t t = vmThread->getEmulatedTime() - alignStartTime;
+  uint32_t nLines = w->lineCount - alignStartLine;
+  uint32_t nFrames = w->frameCount - alignVsyncFrame;
+  // wait for about one second of frames for an accurate value
+  if (alignVsyncFrame == alignStartFrame || nFrames < 50 || t == 0)
+    return 0.0;
+  double linePeriod = double(t) / double(nLines);
+  double frameLines = double(w->frameStartLine - alignVsyncLine) / double(nFrames);
+  return 1000000.0 / (frameLines * linePeriod);
 }
 
 void LibretroCore::sync_display(void)
@@ -1217,6 +1417,22 @@ void LibretroCore::sync_display(void)
   w->wakeDisplay(true);
 }
 
+void LibretroCore::log_memory_usage(void)
+{
+  Ep128Emu::VirtualMachine::MemoryUsage m;
+  vm->getMemoryUsage(m);
+  size_t displaySize = w->getMemoryUsage();
+  size_t audioSize = dynamic_cast<Ep128Emu::AudioOutput_libretro *>(audioOutput)->getMemoryUsage();
+  size_t total = m.ramSize + m.romSize + m.sharedROMSize + m.tableSize + m.machineSize + displaySize + audioSize + sizeof(LibretroCore);
+  log_cb(RETRO_LOG_INFO, "Memory usage: RAM %u KB, ROM %u KB, shared ROM %u KB (%u KB in cache)\n",
+         unsigned(m.ramSize >> 10), unsigned(m.romSize >> 10), unsigned(m.sharedROMSize >> 10),
+         unsigned(Ep128Emu::ROMSegmentCache::getTotalSize() >> 10));
+  log_cb(RETRO_LOG_INFO, "Memory usage: tables %u KB, machine %u KB, display %u KB, audio %u KB, core %u KB\n",
+         unsigned(m.tableSize >> 10), unsigned(m.machineSize >> 10), unsigned(displaySize >> 10),
+         unsigned(audioSize >> 10), unsigned(sizeof(LibretroCore) >> 10));
+  log_cb(RETRO_LOG_INFO, "Memory usage: total %u KB\n", unsigned(total >> 10));
+}
+
 void LibretroCore::errorCallback(void *userData, const char *msg)
 {
   (void) userData;
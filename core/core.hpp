@@ -29,6 +29,7 @@
 #include "libretro-funcs.hpp"
 #include "libretrodisp.hpp"
 #include "libretrosnd.hpp"
+#include <vector>
 
 namespace Ep128Emu
 {
@@ -272,9 +273,21 @@ private:
   unsigned int autofireFrame;
   unsigned int autofireButtonId;
   unsigned int autofireFrameCycle;
+  // active entries of inputJoyMap, in the order they are polled
+  struct JoypadMapping {
+    uint8_t epKey;
+    uint8_t port;
+    uint8_t buttonId;
+  };
+  std::vector<JoypadMapping> joypadMappings;
+  // RETRO_DEVICE_ID_JOYPAD_* buttons used by each port
+  uint16_t joypadButtonsUsed[EP128EMU_MAX_USERS];
+  bool joypadMappingsChanged;
+  // -1: not queried yet, 0: not supported, 1: RETRO_DEVICE_ID_JOYPAD_MASK is usable
+  int inputBitmasks;
+  void update_joypad_mappings(void);
 
 public:
-  uint16_t audioBuffer[EP128EMU_SAMPLE_RATE*1000*2];
   int inputJoyMap[256][EP128EMU_MAX_USERS];
   bool inputStateMap[256][EP128EMU_MAX_USERS];
   bool useHalfFrame;
@@ -290,11 +303,27 @@ public:
   int defaultHalfHeight;
   int defaultWidth;
   int borderSize;
+  // number of frames to run ahead and then rewind, 0 to disable
+  int runAheadFrames;
+  // emulated time run ahead and kept, to be made up for in later frames
+  retro_usec_t runAheadLead;
+  // if true, each frame is run until the next vsync of the emulated machine
+  // instead of for the frame time of the frontend (see set_frame_aligned())
+  bool frameAligned;
+  // emulated time and line count where the measurement of the line period
+  // started in frame aligned mode, and the line and frame counts at the
+  // first vsync after that, for measuring the average frame length
+  uint64_t alignStartTime;
+  uint32_t alignStartLine;
+  uint32_t alignStartFrame;
+  uint32_t alignVsyncLine;
+  uint32_t alignVsyncFrame;
   int machineType;
   int machineDetailedType;
   retro_usec_t totalTime;
   std::string startSequence;
   std::string infoMessage;
+  Ep128Emu::StateFork             stateFork;
 
   Ep128Emu::VMThread              *vmThread    ;
   Ep128Emu::LibretroDisplay       *w           ;
@@ -304,8 +333,11 @@ public:
 
   // ----------------
 
+  // if 'createThreads' is false, the emulation and display threads are not
+  // created, and the machine is run with VMThread::runSlice() (for example
+  // by a VMScheduler) instead of run_for()
   LibretroCore(retro_log_printf_t log_cb_, int machineDetailedType, int contentLocale, bool canSkipFrames_, const char* romDirectory_, const char* saveDirectory_,
-  const char* startSequence_, const char* cfgFile, bool useHalfFrame, bool enhancedRom);
+  const char* startSequence_, const char* cfgFile, bool useHalfFrame, bool enhancedRom, bool createThreads = true);
   virtual ~LibretroCore();
 
   void initialize_keyboard_map(void);
@@ -316,11 +348,22 @@ public:
   void reset_joystick_map(int port);
   void start(void);
   void run_for(retro_usec_t frameTime, float waitPeriod, void * fb);
+  retro_usec_t get_run_time(retro_usec_t frameTime);
+  // enable or disable frame aligned mode: the run time of each frame is
+  // then calculated from the line period and the position of the last vsync,
+  // so that exactly one frame is completed by each run_for() call, and the
+  // time allowed is run to the microsecond
+  void set_frame_aligned(bool enabled);
+  // returns the refresh rate of the emulated machine measured in frame
+  // aligned mode, or 0.0 if not known yet
+  double get_refresh_rate(void);
+  void run_ahead(retro_usec_t frameTime);
   void sync_display();
   char* get_current_message(void);
   void update_input(retro_input_state_t input_state_cb, retro_environment_t environ_cb, unsigned maxUsers);
   void render(retro_video_refresh_t video_cb, retro_environment_t environ_cb);
   void change_resolution(int width, int height, retro_environment_t environ_cb);
+  void log_memory_usage(void);
   void errorCallback(void *userData, const char *msg);
 };
 }
@@ -0,0 +1,1188 @@
+
+// ep128emu-core -- libretro core version of the ep128emu emulator
+// Copyright (C) 2022 Zoltan Balogh
+// https://github.com/zoltanvb/ep128emu-core
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+#include "fileio.hpp"
+#include "instance.hpp"
+#include "libretro_core_options.h"
+
+namespace Ep128Emu
+{
+
+thread_local LibretroInstance *LibretroInstance::currentInstance = (LibretroInstance *) 0;
+
+static bool header_match(const char* buf1, const unsigned char* buf2, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    if ((unsigned char)buf1[i] != buf2[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool zx_header_match(const unsigned char* buf2)
+{
+  // as per original spec, "13 00 00 00" would fit, but it doesn't always match
+  // https://sinclair.wiki.zxnet.co.uk/wiki/TAP_format
+  // empirical boundaries are from scanning the tosec collection
+  if (buf2[0]>0xe && buf2[0]<0x22 && buf2[1] == 0x0 && (buf2[2] == 0x0 || buf2[2] == 0xff))
+    return true;
+  return false;
+}
+
+LibretroInstance::LibretroInstance()
+  : log_cb(&fallback_log),
+    environ_cb((retro_environment_t) 0),
+    video_cb((retro_video_refresh_t) 0),
+    audio_cb((retro_audio_sample_t) 0),
+    audio_batch_cb((retro_audio_sample_batch_t) 0),
+    input_poll_cb((retro_input_poll_t) 0),
+    input_state_cb((retro_input_state_t) 0),
+    led_state_cb((retro_set_led_state_t) 0),
+    userData((void *) 0),
+    systemBiosDirectory(""),
+    systemSaveDirectory(""),
+    contentDirectory(""),
+    contentFileName(""),
+    currFrameTime(0),
+    waitPeriod(0.001f),
+    useSwFb(false),
+    useHalfFrame(false),
+    borderSize(0),
+    runAheadFrames(0),
+    frameAligned(false),
+    fastForward(false),
+    fastForwardFrameSkip(1),
+    audioLatency(18),
+    refreshRate(50.0),
+    soundHq(true),
+    canSkipFrames(false),
+    enhancedRom(false),
+    maxUsers(EP128EMU_MAX_USERS),
+    maxUsersSupported(true),
+    diskIndex(0),
+    diskCount(1),
+    diskEjected(false),
+    tapeContent(false),
+    diskContent(false),
+    fileContent(false),
+    core((Ep128Emu::LibretroCore *) 0),
+    vmThread((Ep128Emu::VMThread *) 0),
+    config((Ep128Emu::EmulatorConfiguration *) 0)
+{
+  ledState[0] = 0;
+  ledState[1] = 0;
+}
+
+LibretroInstance::~LibretroInstance()
+{
+  EntryGuard  guard(this);
+  delete_core();
+}
+
+LibretroInstance * LibretroInstance::get_current(void)
+{
+  return currentInstance;
+}
+
+void LibretroInstance::fallback_log(enum retro_log_level level, const char *fmt, ...)
+{
+  (void)level;
+  va_list va;
+  va_start(va, fmt);
+  vfprintf(stderr, fmt, va);
+  va_end(va);
+}
+
+void LibretroInstance::cfgErrorFunc(void *userData, const char *msg)
+{
+  (void) userData;
+  std::fprintf(stderr, "WARNING: %s\n", msg);
+}
+
+void LibretroInstance::fileNameCallback(void *userData, std::string& fileName)
+{
+  fileName = reinterpret_cast< LibretroInstance * >(userData)->contentFileName;
+}
+
+void LibretroInstance::delete_core(void)
+{
+  if (core)
+  {
+    Ep128Emu::AudioOutput_libretro *audioOutput_ =
+      dynamic_cast<Ep128Emu::AudioOutput_libretro *>(core->audioOutput);
+    log_cb(RETRO_LOG_INFO, "Audio: %u underruns, %u overruns\n",
+           unsigned(audioOutput_->getUnderrunCount()), unsigned(audioOutput_->getOverrunCount()));
+    delete core;
+    core = (Ep128Emu::LibretroCore *) 0;
+    vmThread = (Ep128Emu::VMThread *) 0;
+    config = (Ep128Emu::EmulatorConfiguration *) 0;
+  }
+  // any streams opened from the memory file are closed by now
+  if (!memoryContentPath.empty())
+  {
+    Ep128Emu::unregisterMemoryFile(memoryContentPath.c_str());
+    memoryContentPath.clear();
+  }
+}
+
+void LibretroInstance::set_environment(retro_environment_t cb)
+{
+  EntryGuard  guard(this);
+  environ_cb = cb;
+
+  bool no_content = true;
+  environ_cb(RETRO_ENVIRONMENT_SET_SUPPORT_NO_GAME, &no_content);
+
+  struct retro_log_callback logging;
+  if (environ_cb(RETRO_ENVIRONMENT_GET_LOG_INTERFACE, &logging))
+    log_cb = logging.log;
+  else
+    log_cb = fallback_log;
+
+  bool categories_supported;
+  libretro_set_core_options(environ_cb,&categories_supported);
+
+#ifndef WIN32
+  // read-only tapes and program files can be loaded from memory, so the
+  // frontend does not need to extract them from archives first; disk
+  // images are still opened by path, as they may be written
+  static const struct retro_system_content_info_override contentOverrides[] =
+  {
+    { "tap|cdt|tzx|tvcwav|com|trn|128|bas|cas", false, false },
+    { NULL, false, false }
+  };
+  environ_cb(RETRO_ENVIRONMENT_SET_CONTENT_INFO_OVERRIDE, (void *) contentOverrides);
+#endif
+}
+
+void LibretroInstance::set_video_refresh(retro_video_refresh_t cb)
+{
+  video_cb = cb;
+}
+
+void LibretroInstance::set_audio_sample(retro_audio_sample_t cb)
+{
+  audio_cb = cb;
+}
+
+void LibretroInstance::set_audio_sample_batch(retro_audio_sample_batch_t cb)
+{
+  audio_batch_cb = cb;
+}
+
+void LibretroInstance::set_input_poll(retro_input_poll_t cb)
+{
+  input_poll_cb = cb;
+}
+
+void LibretroInstance::set_input_state(retro_input_state_t cb)
+{
+  input_state_cb = cb;
+}
+
+void LibretroInstance::set_frame_time(retro_usec_t usec)
+{
+  if (usec == 0 || usec > 2*1000000/50)
+  {
+    currFrameTime = 1000000/50;
+  }
+  else
+  {
+    currFrameTime = usec;
+  }
+}
+
+/* LED interface */
+void LibretroInstance::update_led_interface(void)
+{
+
+   unsigned int led_state[2] = {0};
+   unsigned int l            = 0;
+
+   // TODO: power LED should go off during reset (even though original machine had no such thing)
+   led_state[0] = 1;
+   if (core)
+      led_state[1] = core->vm->getFloppyDriveLEDState() ? 1 : 0;
+   else
+      led_state[1] = 0;
+
+   for (l = 0; l < sizeof(led_state)/sizeof(led_state[0]); l++)
+   {
+      if (ledState[l] != led_state[l])
+      {
+         log_cb(RETRO_LOG_DEBUG, "LED control: change LED nr. %d (%d)->(%d)\n",l,ledState[l],led_state[l]);
+         ledState[l] = led_state[l];
+         led_state_cb(l, led_state[l]);
+      }
+   }
+}
+
+void LibretroInstance::update_keyboard(bool down, unsigned keycode,
+                                       uint32_t character, uint16_t key_modifiers)
+{
+  EntryGuard  guard(this);
+  if(keycode != RETROK_UNKNOWN && core)
+    core->update_keyboard(down,keycode,character,key_modifiers);
+}
+
+void LibretroInstance::check_variables(void)
+{
+  struct retro_variable var =
+  {
+    .key = "ep128emu_wait",
+  };
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    waitPeriod = 0.001f * std::atoi(var.value);
+  }
+
+  var.key = "ep128emu_swfb";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    useSwFb = std::atoi(var.value) == 1 ? true : false;
+  }
+
+  var.key = "ep128emu_sdhq";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    bool soundHq_;
+    soundHq_ = std::atoi(var.value) == 1 ? true : false;
+    if (soundHq != soundHq_)
+    {
+      soundHq = soundHq_;
+      if(core)
+      {
+        core->config->sound.highQuality = soundHq && !fastForward;
+        core->config->soundSettingsChanged = true;
+        core->config->applySettings();
+      }
+    }
+  }
+
+  var.key = "ep128emu_useh";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    useHalfFrame = std::atoi(var.value) == 1 ? true : false;
+  }
+
+  var.key = "ep128emu_brds";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    borderSize = std::atoi(var.value);
+    if(core)
+      core->borderSize = borderSize*2;
+  }
+
+  var.key = "ep128emu_rahd";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    runAheadFrames = std::atoi(var.value);
+    if(core)
+      core->runAheadFrames = runAheadFrames;
+  }
+
+  var.key = "ep128emu_ffsk";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    fastForwardFrameSkip = std::atoi(var.value);
+    if(core)
+      update_fast_forward();
+  }
+
+  var.key = "ep128emu_fral";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    frameAligned = std::atoi(var.value) == 1 ? true : false;
+    if(core)
+      core->set_frame_aligned(frameAligned);
+  }
+
+  var.key = "ep128emu_alat";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    audioLatency = std::atoi(var.value);
+    if(core)
+      dynamic_cast<Ep128Emu::AudioOutput_libretro *>(core->audioOutput)->setLatency(
+          size_t(audioLatency * EP128EMU_SAMPLE_RATE / 1000));
+  }
+
+  var.key = "ep128emu_romv";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    if(var.value[0] == 'E') { enhancedRom = true;}
+    else { enhancedRom = false;}
+  }
+
+  std::string zoomKey;
+  var.key = "ep128emu_zoom";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    zoomKey = var.value;
+    Ep128Emu::stringToLowerCase(zoomKey);
+  }
+
+  std::string infoKey;
+  var.key = "ep128emu_info";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    infoKey = var.value;
+    Ep128Emu::stringToLowerCase(infoKey);
+  }
+
+  std::string autofireKey;
+  var.key = "ep128emu_afbt";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    autofireKey = var.value;
+    Ep128Emu::stringToLowerCase(autofireKey);
+  }
+
+  int autofireSpeed = -1;
+  var.key = "ep128emu_afsp";
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+  {
+    autofireSpeed = std::atoi(var.value);
+  }
+
+  // If function is not supported, use all users (and don't interrogate again)
+  if(maxUsersSupported && !environ_cb(RETRO_ENVIRONMENT_GET_INPUT_MAX_USERS,&maxUsers)) {
+    maxUsers = EP128EMU_MAX_USERS;
+    maxUsersSupported = false;
+    log_cb(RETRO_LOG_INFO, "GET_INPUT_MAX_USERS not supported, using fixed %d\n", EP128EMU_MAX_USERS);
+  }
+
+  if(core)
+    core->initialize_joystick_map(zoomKey,infoKey,autofireKey, autofireSpeed,
+    Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"),
+    Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"));
+
+  if(vmThread) vmThread->resetKeyboard();
+}
+
+/* If ejected is true, "ejects" the virtual disk tray.
+ */
+bool LibretroInstance::set_eject_state(bool ejected) {
+  EntryGuard  guard(this);
+  log_cb(RETRO_LOG_DEBUG, "Disk control: eject (%d)\n",ejected?1:0);
+  diskEjected = ejected;
+  return true;
+}
+
+/* Gets current eject state. The initial state is 'not ejected'. */
+bool LibretroInstance::get_eject_state(void) {
+//  log_cb(RETRO_LOG_DEBUG, "Disk control: get eject status (%d)\n",diskEjected?1:0);
+  return diskEjected;
+}
+
+/* Gets current disk index. First disk is index 0.
+ * If return value is >= get_num_images(), no disk is currently inserted.
+ */
+unsigned LibretroInstance::get_image_index(void) {
+//  log_cb(RETRO_LOG_DEBUG, "Disk control: get image index (%d)\n",diskIndex);
+  return diskIndex;
+}
+
+/* Sets image index. Can only be called when disk is ejected.
+ */
+bool LibretroInstance::set_image_index(unsigned index) {
+  EntryGuard  guard(this);
+  log_cb(RETRO_LOG_DEBUG, "Disk control: change image to (%d)\n",index);
+  if (index>=diskCount) {
+    diskIndex = diskCount + 1;
+  } else {
+    diskIndex = index;
+    if (core) {
+      config = core->config;
+      if(diskContent) {
+        config->floppy.a.imageFile = diskPaths[index];
+        config->floppyAChanged = true;
+        log_cb(RETRO_LOG_DEBUG, "Disk control: new disk is %s\n",diskPaths[index].c_str());
+      } else if(tapeContent) {
+        config->tape.imageFile = diskPaths[index];
+        config->tapeFileChanged = true;
+        log_cb(RETRO_LOG_DEBUG, "Disk control: new tape is %s\n",diskPaths[index].c_str());
+      } else if (fileContent) {
+        std::string contentPath;
+        Ep128Emu::splitPath(diskPaths[index],contentPath,diskNames[index]);
+        config->fileio.workingDirectory = contentPath;
+        contentFileName=diskPaths[index];
+        config->fileioSettingsChanged = true;
+        log_cb(RETRO_LOG_DEBUG, "Disk control: new file is %s\n",diskPaths[index].c_str());
+     }
+     config->applySettings();
+    }
+  }
+  return true;
+}
+
+/* Gets total number of images which are available to use. */
+unsigned LibretroInstance::get_num_images(void) {return diskCount;}
+
+/* Replaces the disk image associated with index.
+ * Arguments to pass in info have same requirements as retro_load_game().
+ */
+bool LibretroInstance::replace_image_index(unsigned index,
+      const struct retro_game_info *info) {
+
+  EntryGuard  guard(this);
+  log_cb(RETRO_LOG_DEBUG, "Disk control: replace image index (%d) to %s\n",index,info->path);
+  if (index >= diskCount) return false;
+  diskPaths[index] = info->path;
+  std::string contentPath;
+  Ep128Emu::splitPath(diskPaths[index],contentPath,diskNames[index]);
+  return true;
+}
+
+/* Adds a new valid index (get_num_images()) to the internal disk list.
+ * This will increment subsequent return values from get_num_images() by 1.
+ * This image index cannot be used until a disk image has been set
+ * with replace_image_index. */
+bool LibretroInstance::add_image_index(void) {
+  EntryGuard  guard(this);
+  log_cb(RETRO_LOG_DEBUG, "Disk control: add image index (current %d)\n",diskCount);
+  if (diskCount >= maxDiskCount) return false;
+  diskCount++;
+  return true;
+}
+
+/* Fetches the path of the specified disk image file.
+ * Returns 'false' if index is invalid (index >= get_num_images())
+ * or path is otherwise unavailable.
+ */
+bool LibretroInstance::get_image_path(unsigned index, char *path, size_t len) {
+  EntryGuard  guard(this);
+  if (index >= diskCount) return false;
+  if(diskPaths[index].length() > 0)
+  strncpy(path, diskPaths[index].c_str(), len);
+  log_cb(RETRO_LOG_DEBUG, "Disk control: get image path (%d) %s\n",index,path);
+  return true;
+}
+
+/* Fetches a core-provided 'label' for the specified disk
+ * image file. In the simplest case this may be a file name
+ * Returns 'false' if index is invalid (index >= get_num_images())
+ * or label is otherwise unavailable.
+ */
+bool LibretroInstance::get_image_label(unsigned index, char *label, size_t len) {
+  if(index >= diskCount) return false;
+  if(diskNames[index].length() > 0)
+  strncpy(label, diskNames[index].c_str(), len);
+  //log_cb(RETRO_LOG_DEBUG, "Disk control: get image label (%d) %s\n",index,label);
+  return true;
+}
+
+bool LibretroInstance::add_new_image_auto(const char *path) {
+
+  unsigned index = diskCount;
+  if (diskCount >= maxDiskCount) return false;
+  diskCount++;
+  log_cb(RETRO_LOG_DEBUG, "Disk control: add new image (%d) as %s\n",diskCount,path);
+
+  diskPaths[index] = path;
+  std::string contentPath;
+  Ep128Emu::splitPath(diskPaths[index],contentPath,diskNames[index]);
+  return true;
+}
+
+void LibretroInstance::scan_multidisk_files(const char *path) {
+
+  std::string filename(path);
+  std::string filePrefix;
+  std::string filePostfix;
+  std::string additionalFile;
+  std::map< std::string, std::string >::const_iterator  iter_multidisk;
+
+  for (iter_multidisk = Ep128Emu::multidisk_replacements.begin(); iter_multidisk != Ep128Emu::multidisk_replacements.end(); ++iter_multidisk)
+  {
+    size_t idx = filename.rfind((*iter_multidisk).first);
+    if(idx != std::string::npos) {
+      filePrefix = filename.substr(0,idx);
+      filePostfix = filename.substr(idx+(*iter_multidisk).first.length());
+      additionalFile = filePrefix + (*iter_multidisk).second.c_str() + filePostfix;
+
+      if(Ep128Emu::does_file_exist(additionalFile.c_str()))
+      {
+        log_cb(RETRO_LOG_INFO, "Multidisk additional file found: %s => %s\n",filename.c_str(), additionalFile.c_str());
+        if (!add_new_image_auto(additionalFile.c_str())) {
+          log_cb(RETRO_LOG_WARN, "Multidisk additional image add unsuccessful: %s\n",additionalFile.c_str());
+          break;
+        }
+      }
+    }
+  }
+}
+
+void LibretroInstance::init(void)
+{
+  EntryGuard  guard(this);
+  struct retro_log_callback log;
+
+  // Init log
+  if (environ_cb(RETRO_ENVIRONMENT_GET_LOG_INTERFACE, &log))
+    log_cb = log.log;
+  else
+    log_cb = fallback_log;
+
+  struct retro_led_interface led_interface;
+  if(environ_cb(RETRO_ENVIRONMENT_GET_LED_INTERFACE, &led_interface)) {
+   if (led_interface.set_led_state && !led_state_cb) {
+      led_state_cb = led_interface.set_led_state;
+      log_cb(RETRO_LOG_INFO, "LED interface supported\n");
+    } else {
+      log_cb(RETRO_LOG_INFO, "LED interface not supported\n");
+    }
+  } else {
+    log_cb(RETRO_LOG_INFO, "LED interface not present\n");
+  }
+
+  const char *system_dir = NULL;
+  if (environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &system_dir) && system_dir)
+  {
+    // if defined, use the system directory
+    systemBiosDirectory = system_dir;
+  }
+  else
+  {
+    systemBiosDirectory = ".";
+  }
+
+  const char *content_dir = NULL;
+  if (environ_cb(RETRO_ENVIRONMENT_GET_CONTENT_DIRECTORY, &content_dir) && content_dir)
+  {
+    // if defined, use the system directory
+    contentDirectory = content_dir;
+  }
+
+  const char *save_dir = NULL;
+  if (environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &save_dir) && save_dir && *save_dir)
+  {
+    // If save directory is defined use it, otherwise use system directory
+    systemSaveDirectory = save_dir;
+  }
+  else
+  {
+    // make the save directory the same in case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY is not implemented by the frontend
+    systemSaveDirectory = (system_dir ? system_dir : "");
+  }
+
+  log_cb(RETRO_LOG_DEBUG, "Retro ROM DIRECTORY %s\n", systemBiosDirectory.c_str());
+  log_cb(RETRO_LOG_DEBUG, "Retro SAVE_DIRECTORY %s\n", systemSaveDirectory.c_str());
+  log_cb(RETRO_LOG_DEBUG, "Retro CONTENT_DIRECTORY %s\n", contentDirectory.c_str());
+
+   static const struct retro_controller_info ports[EP128EMU_MAX_USERS+1] = {
+      { Ep128Emu::controller_description, 11  }, // port 1
+      { Ep128Emu::controller_description, 11  }, // port 2
+      { Ep128Emu::controller_description, 11  }, // port 3
+      { Ep128Emu::controller_description, 11  }, // port 4
+      { Ep128Emu::controller_description, 11  }, // port 5
+      { Ep128Emu::controller_description, 11  }, // port 6
+      { NULL, 0 }
+   };
+
+   environ_cb( RETRO_ENVIRONMENT_SET_CONTROLLER_INFO, (void*)ports );
+
+  environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE,&canSkipFrames);
+  //environ_cb(RETRO_ENVIRONMENT_GET_OVERSCAN,&showan);
+  // safe mode
+  canSkipFrames = false;
+  check_variables();
+  log_cb(RETRO_LOG_DEBUG, "Creating core...\n");
+  core = new Ep128Emu::LibretroCore(log_cb, Ep128Emu::VM_config.at("EP128_DISK"), Ep128Emu::LOCALE_UK, canSkipFrames, systemBiosDirectory.c_str(), systemSaveDirectory.c_str(),"","",useHalfFrame, enhancedRom);
+  config = core->config;
+  config->setErrorCallback(&cfgErrorFunc, (void *) this);
+  vmThread = core->vmThread;
+  check_variables();
+  log_cb(RETRO_LOG_DEBUG, "Starting core...\n");
+  core->start();
+  core->change_resolution(core->currWidth,core->currHeight,environ_cb);
+}
+
+void LibretroInstance::deinit(void)
+{
+  EntryGuard  guard(this);
+  delete_core();
+}
+
+void LibretroInstance::get_system_av_info(struct retro_system_av_info *info)
+{
+  float aspect = 4.0f / 3.0f;
+  aspect = 4.0f / (3.0f / (float) (core->isHalfFrame ? EP128EMU_LIBRETRO_SCREEN_HEIGHT/2/(float)core->currHeight : EP128EMU_LIBRETRO_SCREEN_HEIGHT/(float)core->currHeight));
+  //aspect = 4.0f / (3.0f / (float) (EP128EMU_LIBRETRO_SCREEN_HEIGHT/(float)core->currHeight));
+  info->timing = (struct retro_system_timing)
+  {
+    .fps = refreshRate,
+    .sample_rate = EP128EMU_SAMPLE_RATE_FLOAT,
+  };
+
+  info->geometry = (struct retro_game_geometry)
+  {
+    .base_width   = (unsigned int) core->currWidth,
+    .base_height  = (unsigned int) core->currHeight,
+    .max_width    = EP128EMU_LIBRETRO_SCREEN_WIDTH,
+    .max_height   = EP128EMU_LIBRETRO_SCREEN_HEIGHT,
+    .aspect_ratio = aspect,
+  };
+}
+
+void LibretroInstance::reset(void)
+{
+  EntryGuard  guard(this);
+  if(vmThread) vmThread->reset(true);
+}
+
+/*
+void LibretroInstance::audio_callback(void)
+{
+    audio_cb(0, 0);
+}
+*/
+void LibretroInstance::audio_callback_batch(void)
+{
+  size_t nFrames=0;
+  double exp = double(currFrameTime) * EP128EMU_SAMPLE_RATE_FLOAT / 1000000.0;
+  // in frame aligned mode, all samples of the frame are sent
+  if (frameAligned)
+    exp = -1.0;
+
+  core->audioOutput->forwardAudioData(audioBuffer,&nFrames,exp);
+  //printf("sending frames: %d exp %d frame_time: %d\n",nFrames,exp, currFrameTime);
+  //if (nFrames != exp)
+  // printf("sending diff frames: %d exp %d frame_time: %d\n",nFrames,exp, currFrameTime);
+  audio_batch_cb(audioBuffer, nFrames);
+}
+
+// While the frontend is fast-forwarding, only some of the frames are drawn
+// (the others are reported as dupes, so this requires frame dupe support),
+// and the sound is converted with the low quality converter.
+void LibretroInstance::update_fast_forward(void)
+{
+  core->w->frameSkip = (fastForward && canSkipFrames) ? fastForwardFrameSkip : 0;
+  bool soundHq_ = soundHq && !fastForward;
+  if (core->config->sound.highQuality != soundHq_)
+  {
+    core->config->sound.highQuality = soundHq_;
+    core->config->soundSettingsChanged = true;
+    core->config->applySettings();
+  }
+}
+
+void LibretroInstance::run(void)
+{
+  EntryGuard  guard(this);
+
+  bool updated = false;
+  if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
+    check_variables();
+
+  bool fastForward_ = false;
+  if (!environ_cb(RETRO_ENVIRONMENT_GET_FASTFORWARDING, &fastForward_))
+    fastForward_ = false;
+  if (fastForward_ != fastForward)
+  {
+    fastForward = fastForward_;
+    update_fast_forward();
+  }
+
+  void *buf = NULL;
+  if (useSwFb)
+  {
+    struct retro_framebuffer fb = {0};
+    fb.width = core->currWidth;
+    fb.height = core->currHeight;
+    fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+#ifdef EP128EMU_USE_XRGB8888
+    if (environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) && fb.format == RETRO_PIXEL_FORMAT_XRGB8888)
+#else
+    if (environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) && fb.format == RETRO_PIXEL_FORMAT_RGB565)
+#endif // EP128EMU_USE_XRGB8888
+    {
+      buf = fb.data;
+    }
+  }
+  input_poll_cb();
+  core->update_input(input_state_cb, environ_cb, maxUsers);
+  core->run_for(currFrameTime,waitPeriod,buf);
+  audio_callback_batch();
+  core->sync_display();
+  core->render(video_cb, environ_cb);
+  // announce the refresh rate measured in frame aligned mode
+  double refreshRate_ = 50.0;
+  if (frameAligned)
+  {
+    refreshRate_ = core->get_refresh_rate();
+    if (refreshRate_ <= 0.0)
+      refreshRate_ = refreshRate;
+  }
+  if (std::fabs(refreshRate_ - refreshRate) > 0.01)
+  {
+    struct retro_system_av_info info;
+    refreshRate = refreshRate_;
+    get_system_av_info(&info);
+    environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &info);
+    log_cb(RETRO_LOG_INFO, "Refresh rate: %.3f Hz\n", refreshRate);
+  }
+   /* LED interface */
+   if (led_state_cb)
+      update_led_interface();
+}
+
+bool LibretroInstance::load_game(const struct retro_game_info *info)
+{
+  EntryGuard  guard(this);
+
+#ifdef EP128EMU_USE_XRGB8888
+  enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+#else
+  enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
+#endif // EP128EMU_USE_XRGB8888
+  if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+  {
+#ifdef EP128EMU_USE_XRGB8888
+    log_cb(RETRO_LOG_ERROR, "XRGB8888 is not supported.\n");
+#else
+    log_cb(RETRO_LOG_ERROR, "RGB565 is not supported.\n");
+#endif // EP128EMU_USE_XRGB8888
+    return false;
+  }
+
+  check_variables();
+  if(info != nullptr)
+  {
+    delete_core();
+    if (!info->path)
+    {
+      log_cb(RETRO_LOG_ERROR, "Content without a path is not supported\n");
+      return false;
+    }
+    log_cb(RETRO_LOG_INFO, "Loading game: %s \n",info->path);
+    std::string filename(info->path);
+    std::string contentExt;
+    std::string contentPath;
+    std::string contentFile;
+    std::string contentBasename;
+    std::string configFile;
+    std::string configFileExt(".ep128cfg");
+
+    size_t idx = filename.rfind('.');
+    if(idx != std::string::npos)
+    {
+      contentExt = filename.substr(idx+1);
+      configFile = filename.substr(0,idx);
+      configFile += configFileExt;
+      Ep128Emu::stringToLowerCase(contentExt);
+    }
+    else
+    {
+      contentExt=""; // No extension found
+    }
+    log_cb(RETRO_LOG_DEBUG, "Content extension: %s \n",contentExt.c_str());
+    Ep128Emu::splitPath(filename,contentPath,contentFile);
+    contentBasename = contentFile;
+    diskPaths[0] = filename;
+    diskNames[0] = contentBasename;
+    Ep128Emu::stringToLowerCase(contentBasename);
+
+    int contentLocale = Ep128Emu::LOCALE_UK;
+    for(int i=1;i<Ep128Emu::LOCALE_AMOUNT;i++) {
+      idx = filename.rfind(Ep128Emu::locale_identifiers[i]);
+      if(idx != std::string::npos) {
+        contentLocale = i;
+        log_cb(RETRO_LOG_INFO, "Locale detected: %s \n",Ep128Emu::locale_identifiers[i].c_str());
+        break;
+      }
+    }
+
+    if(Ep128Emu::does_file_exist(configFile.c_str()))
+    {
+      log_cb(RETRO_LOG_INFO, "Content specific configuration file: %s \n",configFile.c_str());
+    }
+    else
+    {
+      configFile = "";
+      log_cb(RETRO_LOG_DEBUG, "No content specific config file exists\n");
+    }
+
+    std::string diskExt = "img";
+    std::string tapeExt = "tap";
+    std::string tapeExtEp = "ept";
+    std::string fileExtDtf = "dtf";
+    std::string fileExtTvc = "cas";
+    std::string diskExtTvc = "dsk";
+    //std::string tapeExtSnd = "notwav";
+    //std::string tapeExtZx = "tzx";
+    std::string fileExtZx = "tap";
+    std::string tapeExtCpc = "cdt";
+    std::string tapeExtTvc = "tvcwav";
+
+    const size_t nBytes = 64;
+    uint8_t headerBuf[512 + nBytes];
+    uint8_t *tmpBuf = &(headerBuf[0]);
+    uint8_t *tmpBufOffset128 = &(headerBuf[128]);
+    uint8_t *tmpBufOffset512 = &(headerBuf[512]);
+    static const char zeroBytes[nBytes] = "\0";
+
+    // the headers are taken from the frontend's buffer if the content has
+    // been loaded to memory, otherwise from the file
+    size_t headerBytes = 0;
+    std::memset(headerBuf, 0, sizeof(headerBuf));
+    if (info->data)
+    {
+      headerBytes = (info->size < sizeof(headerBuf) ? info->size : sizeof(headerBuf));
+      std::memcpy(headerBuf, info->data, headerBytes);
+      Ep128Emu::registerMemoryFile(info->path, info->data, info->size);
+      memoryContentPath = info->path;
+      log_cb(RETRO_LOG_DEBUG, "Content loaded from memory (%d bytes)\n", int(info->size));
+    }
+    else
+    {
+      std::FILE *imageFile = Ep128Emu::fileOpen(info->path, "rb");
+      if (!imageFile)
+      {
+        log_cb(RETRO_LOG_ERROR, "Error opening game content file\n");
+        return false;
+      }
+      headerBytes = std::fread(headerBuf, sizeof(uint8_t), sizeof(headerBuf), imageFile);
+      std::fclose(imageFile);
+    }
+    if (headerBytes < nBytes)
+    {
+      throw Ep128Emu::Exception("error reading game content file");
+    }
+    if (headerBytes < sizeof(headerBuf))
+    {
+      log_cb(RETRO_LOG_DEBUG, "Game content file too short for full header analysis\n");
+    }
+
+    static const char *cpcDskFileHeader = "MV - CPCEMU";
+    static const char *cpcExtFileHeader = "EXTENDED CPC DSK File";
+    static const char *ep128emuTapFileHeader = "\x02\x75\xcd\x72\x1c\x44\x51\x26";
+    static const char *epteFileMagic = "ENTERPRISE 128K TAPE FILE       ";
+    static const char *TAPirFileMagic = "\x00\x6A\xFF";
+    static const char *waveFileMagic = "RIFF";
+    static const char *tzxFileMagic = "ZXTape!\032\001";
+    static const char *tvcDskFileHeader = "\xeb\xfe\x90";
+    static const char *epDskFileHeader1 = "\xeb\x3c\x90";
+    static const char *epDskFileHeader2 = "\xeb\x4c\x90";
+    static const char *epComFileHeader = "\x00\x05";
+    static const char *epComFileHeader2 = "\x00\x06";
+    static const char *epBasFileHeader = "\x00\x04";
+    static const char *mp3FileHeader1 = "\x49\x44\x33";
+    static const char *mp3FileHeader2 = "\xff\xfb";
+    // Startup sequence may contain:
+    // - chars on the keyboard (a-z, 0-9, few symbols like :
+    // - 0xff as wait character
+    // - 0xfe as "
+    // - 0xfd as F1 (START)
+    const char* startupSequence = "";
+    tapeContent = false;
+    diskContent = false;
+    fileContent = false;
+    int detectedMachineDetailedType = Ep128Emu::VM_config.at("VM_CONFIG_UNKNOWN");
+
+    // start with longer magic strings - less chance of mis-detection
+    if(header_match(cpcDskFileHeader,tmpBuf,11) || header_match(cpcExtFileHeader,tmpBuf,21))
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("CPC_DISK");
+      diskContent=true;
+      startupSequence ="cat\r\xff\xff\xff\xff\xff\xffrun\xfe";
+    }
+    else if(header_match(tzxFileMagic,tmpBuf,9))
+    {
+      // if tzx format is called cdt, it is for CPC
+      if (contentExt == tapeExtCpc)
+      {
+        detectedMachineDetailedType = Ep128Emu::VM_config.at("CPC_TAPE");
+        tapeContent = true;
+        startupSequence ="run\xfe\r\r";
+      }
+      // TODO: replace with something else?
+      else if (contentExt == tapeExtEp)
+      {
+        detectedMachineDetailedType = Ep128Emu::VM_config.at("EP128_TAPE");
+        tapeContent=true;
+        startupSequence =" \xff\xff\xfd";
+      }
+      else
+      {
+        detectedMachineDetailedType = Ep128Emu::VM_config.at("ZX128_TAPE");
+        tapeContent = true;
+        startupSequence ="\r";
+      }
+    }
+    // tvcwav extension is made up, it is to avoid clash with normal wave file and also with retroarch's own wave player
+    else if(contentExt == tapeExtTvc && header_match(waveFileMagic,tmpBuf,4))
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("TVC64_TAPE");
+      tapeContent=true;
+      startupSequence =" \xffload\r";
+    }
+    else if (contentExt == fileExtZx && zx_header_match(tmpBuf))
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("ZX128_FILE");
+      fileContent=true;
+      startupSequence ="\r";
+    }
+    // All .tap files will fall back to be interpreted as EP128_TAPE
+    else if(header_match(epteFileMagic,tmpBufOffset128,32) || header_match(ep128emuTapFileHeader,tmpBuf,8) ||
+            header_match(waveFileMagic,tmpBuf,4) || header_match(TAPirFileMagic,tmpBufOffset512,3) ||
+            header_match(mp3FileHeader1,tmpBuf,3) || header_match(mp3FileHeader2,tmpBufOffset512,2) ||
+            contentExt == tapeExt )
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("EP128_TAPE");
+      tapeContent=true;
+      startupSequence =" \xff\xff\xfd";
+    }
+    else if (contentExt == fileExtTvc && header_match(zeroBytes,&(tmpBuf[5]),nBytes-6))
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("TVC64_FILE");
+      fileContent=true;
+      startupSequence =" \xffload\r";
+    }
+    // EP and TVC disks may have similar extensions
+    else if (contentExt == diskExt || contentExt == diskExtTvc)
+    {
+      if (header_match(tvcDskFileHeader,tmpBuf,3))
+      {
+        detectedMachineDetailedType = Ep128Emu::VM_config.at("TVC64_DISK");
+        diskContent=true;
+        // ext 2 - dir - esc - load"
+        startupSequence =" ext 2\r dir\r \x1bload\xfe";
+      }
+      else if (header_match(epDskFileHeader1,tmpBuf,3) || header_match(epDskFileHeader2,tmpBuf,3))
+      {
+        detectedMachineDetailedType = Ep128Emu::VM_config.at("EP128_DISK");
+        diskContent=true;
+      }
+      else {
+        log_cb(RETRO_LOG_ERROR, "Content format not recognized!\n");
+        return false;
+      }
+    }
+    else if (contentExt == fileExtDtf) {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("EP128_FILE_DTF");
+      fileContent=true;
+      startupSequence =" \xff\xff\xff\xff\xff:dl ";
+    }
+    // last resort: EP file, first 2 bytes
+    else if (header_match(epComFileHeader,tmpBuf,2) || header_match(epComFileHeader2,tmpBuf,2) || header_match(epBasFileHeader,tmpBuf,2))
+    {
+      detectedMachineDetailedType = Ep128Emu::VM_config.at("EP128_FILE");
+      fileContent=true;
+      startupSequence =" \xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xfd";
+    }
+    else
+    {
+      log_cb(RETRO_LOG_ERROR, "Content format not recognized!\n");
+      return false;
+    }
+    try
+    {
+      log_cb(RETRO_LOG_DEBUG, "Creating core\n");
+      check_variables();
+      core = new Ep128Emu::LibretroCore(log_cb, detectedMachineDetailedType, contentLocale, canSkipFrames,
+                                        systemBiosDirectory.c_str(), systemSaveDirectory.c_str(),
+                                        startupSequence,configFile.c_str(),useHalfFrame, enhancedRom);
+      log_cb(RETRO_LOG_DEBUG, "Core created\n");
+      config = core->config;
+      check_variables();
+      if (diskContent)
+      {
+        config->floppy.a.imageFile = info->path;
+        config->floppyAChanged = true;
+      }
+      if (tapeContent)
+      {
+        config->tape.imageFile = info->path;
+        config->tapeFileChanged = true;
+        // Todo: add tzx based advanced detection here
+        /*    tape = openTapeFile(fileName.c_str(), 0,
+                        defaultTapeSampleRate, bitsPerSample);*/
+      }
+      if (diskContent || tapeContent) {
+        scan_multidisk_files(info->path);
+      }
+      if (fileContent)
+      {
+        config->fileio.workingDirectory = contentPath;
+        contentFileName=contentPath+contentFile;
+        core->vm->setFileNameCallback(&fileNameCallback, (void *) this);
+        config->fileioSettingsChanged = true;
+        config->vm.enableFileIO=true;
+        config->vmConfigurationChanged = true;
+        if( detectedMachineDetailedType == Ep128Emu::VM_config.at("EP128_FILE_DTF") ) {
+          core->startSequence += contentBasename+"\r";
+        }
+      }
+      config->applySettings();
+
+      if (tapeContent)
+      {
+        // ZX tape will be started at the end of the startup sequence
+        if (core->machineType == Ep128Emu::MACHINE_ZX || config->tape.forceMotorOn)
+        {
+        }
+        // for other machines, remote control will take care of actual tape control, just start it
+        else
+        {
+          core->vm->tapePlay();
+        }
+      }
+    }
+    catch (...)
+    {
+      log_cb(RETRO_LOG_ERROR, "Exception in load_game\n");
+      throw;
+    }
+
+    // ep128emu allocates memory per 16 kB segments
+    // actual place in the address map differs between ep/tvc/cpc/zx
+    // so all slots are scanned, but only 576 kB is offered as map
+    // to cover some new games that require RAM extension
+    struct retro_memory_descriptor desc[36];
+    memset(desc, 0, sizeof(desc));
+    int dindex=0;
+    for(uint8_t segment=0; dindex<32 ; segment++) {
+       if(core->vm->getSegmentPtr(segment)) {
+         desc[dindex].start=segment << 14;
+         desc[dindex].select=0xFF << 14;
+         desc[dindex].len= 0x4000;
+         desc[dindex].ptr=core->vm->getSegmentPtr(segment);
+         desc[dindex].flags=RETRO_MEMDESC_SYSTEM_RAM;
+         dindex++;
+       }
+       if(segment==0xFF) break;
+    }
+    struct retro_memory_map retromap = {
+        desc,
+        sizeof(desc)/sizeof(desc[0])
+    };
+    environ_cb(RETRO_ENVIRONMENT_SET_MEMORY_MAPS, &retromap);
+
+    config->setErrorCallback(&cfgErrorFunc, (void *) this);
+    vmThread = core->vmThread;
+    core->log_memory_usage();
+    log_cb(RETRO_LOG_DEBUG, "Starting core\n");
+    core->start();
+  }
+
+  return true;
+}
+
+void LibretroInstance::unload_game(void)
+{
+  EntryGuard  guard(this);
+  try
+  {
+    config->floppy.a.imageFile = "";
+    config->floppyAChanged = true;
+    config->applySettings();
+  }
+  catch (...)
+  {
+    log_cb(RETRO_LOG_ERROR, "Exception in unload_game\n");
+    throw;
+  }
+
+}
+
+size_t LibretroInstance::serialize_size(void)
+{
+  return EP128EMU_SNAPSHOT_SIZE;
+}
+
+bool LibretroInstance::serialize(void *data_, size_t size)
+{
+  EntryGuard  guard(this);
+  if (size < serialize_size())
+    return false;
+
+  memset( data_, 0x00,size);
+
+  Ep128Emu::File  f;
+  f.swapBuffer(snapshotArena);
+  core->vm->saveState(f);
+  f.writeMem(data_, size);
+  f.swapBuffer(snapshotArena);
+
+  return true;
+}
+
+bool LibretroInstance::unserialize(const void *data_, size_t size)
+{
+  EntryGuard  guard(this);
+  if (size < serialize_size())
+    return false;
+
+  unsigned char *buf= (unsigned char*)data_;
+
+  // workaround: find last non-zero byte - which will be crc32 of the end-of-file chunk type, 6A 50 08 5E, so essentially the end of content
+  size_t lastNonZeroByte = size-1;
+  for (size_t i=size-1; i>0; i--)
+  {
+    if(buf[i] != 0)
+    {
+      lastNonZeroByte = i;
+      break;
+    }
+  }
+  Ep128Emu::File  f((unsigned char *)data_,lastNonZeroByte+1);
+  core->vm->registerChunkTypes(f);
+  f.processAllChunks();
+  core->config->applySettings();
+  core->startSequenceIndex = core->startSequence.length();
+  if(vmThread) vmThread->resetKeyboard();
+
+  // todo: restore filenamecallback if file is used?
+  return true;
+}
+
+void LibretroInstance::set_controller_port_device(unsigned port, unsigned device)
+{
+  EntryGuard  guard(this);
+  //log_cb(RETRO_LOG_INFO, "Plugging device %u into port %u.\n", device, port);
+  std::map< unsigned, std::string>::const_iterator  iter_joytype;
+  iter_joytype = Ep128Emu::joystick_type_retrodev.find(device);
+  if (port < EP128EMU_MAX_USERS && iter_joytype != Ep128Emu::joystick_type_retrodev.end())
+  {
+    int userMap[EP128EMU_MAX_USERS] = {
+      Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"),
+      Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT"),
+      Ep128Emu::joystick_type.at("DEFAULT"), Ep128Emu::joystick_type.at("DEFAULT")};
+
+    unsigned mappedDev = Ep128Emu::joystick_type.at((*iter_joytype).second);
+    log_cb(RETRO_LOG_INFO, "Mapped device %s for user %u \n", (*iter_joytype).second.c_str(), port);
+
+    userMap[port] = mappedDev;
+    if(core)
+      core->initialize_joystick_map(std::string(""),std::string(""),std::string(""),-1,userMap[0],userMap[1],userMap[2],userMap[3],userMap[4],userMap[5]);
+  }
+}
+
+}
@@ -0,0 +1,194 @@
+
+// ep128emu-core -- libretro core version of the ep128emu emulator
+// Copyright (C) 2022 Zoltan Balogh
+// https://github.com/zoltanvb/ep128emu-core
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef EP128EMU_INSTANCE_HPP
+#define EP128EMU_INSTANCE_HPP
+
+#include "core.hpp"
+#include <string>
+
+namespace Ep128Emu
+{
+
+// One emulated machine with all the state of a libretro session (frontend
+// callbacks, core options, disk list, content type), so that any number of
+// independent instances can be created in the same process. The functions
+// follow the libretro API, core/main.cpp forwards the retro_* entry points
+// to a single instance.
+// An instance is not thread-safe, but different instances can be used from
+// different threads at the same time. The frontend callbacks are only
+// called from the thread that is in one of the functions of the instance;
+// as the libretro callback types have no user data pointer, get_current()
+// can be used in a callback to find out which instance has called it.
+
+class LibretroInstance
+{
+private:
+  static const unsigned maxDiskCount = 10;
+  static thread_local LibretroInstance *currentInstance;
+
+  class EntryGuard {
+   private:
+    LibretroInstance  *prvInstance;
+   public:
+    EntryGuard(LibretroInstance *instance)
+      : prvInstance(currentInstance)
+    {
+      currentInstance = instance;
+    }
+    ~EntryGuard()
+    {
+      currentInstance = prvInstance;
+    }
+  };
+
+  retro_log_printf_t          log_cb;
+  retro_environment_t         environ_cb;
+  retro_video_refresh_t       video_cb;
+  retro_audio_sample_t        audio_cb;
+  retro_audio_sample_batch_t  audio_batch_cb;
+  retro_input_poll_t          input_poll_cb;
+  retro_input_state_t         input_state_cb;
+  retro_set_led_state_t       led_state_cb;
+  void                        *userData;
+
+  std::string systemBiosDirectory;
+  std::string systemSaveDirectory;
+  std::string contentDirectory;
+  std::string contentFileName;
+  // content registered with Ep128Emu::registerMemoryFile(), if any
+  std::string memoryContentPath;
+  int16_t     audioBuffer[EP128EMU_AUDIO_FRAMES_MAX * 2];
+  // memory of the last snapshot, reused by the next one
+  Ep128Emu::File::Buffer snapshotArena;
+
+  retro_usec_t currFrameTime;
+  float       waitPeriod;
+  bool        useSwFb;
+  bool        useHalfFrame;
+  int         borderSize;
+  int         runAheadFrames;
+  bool        frameAligned;
+  // frames drawn while the frontend is fast-forwarding: one in every
+  // fastForwardFrameSkip
+  bool        fastForward;
+  int         fastForwardFrameSkip;
+  // audio buffered between the emulation and the frontend, in milliseconds
+  int         audioLatency;
+  // refresh rate last reported to the frontend
+  double      refreshRate;
+  bool        soundHq;
+  bool        canSkipFrames;
+  bool        enhancedRom;
+
+  unsigned    maxUsers;
+  bool        maxUsersSupported;
+
+  unsigned    diskIndex;
+  unsigned    diskCount;
+  std::string diskPaths[maxDiskCount];
+  std::string diskNames[maxDiskCount];
+  bool        diskEjected;
+
+  bool        tapeContent;
+  bool        diskContent;
+  bool        fileContent;
+
+  unsigned int ledState[2];
+
+  Ep128Emu::LibretroCore          *core;
+  Ep128Emu::VMThread              *vmThread;
+  Ep128Emu::EmulatorConfiguration *config;
+
+  static void fallback_log(enum retro_log_level level, const char *fmt, ...);
+  static void cfgErrorFunc(void *userData, const char *msg);
+  static void fileNameCallback(void *userData, std::string& fileName);
+  void delete_core(void);
+  void check_variables(void);
+  void update_led_interface(void);
+  void audio_callback_batch(void);
+  void update_fast_forward(void);
+  bool add_new_image_auto(const char *path);
+  void scan_multidisk_files(const char *path);
+
+public:
+  LibretroInstance();
+  virtual ~LibretroInstance();
+  // returns the instance the calling thread is currently in, or NULL
+  static LibretroInstance * get_current(void);
+  // arbitrary pointer for use by the frontend callbacks
+  inline void set_user_data(void *userData_)
+  {
+    userData = userData_;
+  }
+  inline void * get_user_data(void) const
+  {
+    return userData;
+  }
+  inline retro_environment_t get_environment_callback(void) const
+  {
+    return environ_cb;
+  }
+  inline retro_log_printf_t get_log_callback(void) const
+  {
+    return log_cb;
+  }
+  inline LibretroCore * get_core(void) const
+  {
+    return core;
+  }
+
+  void set_environment(retro_environment_t cb);
+  void set_video_refresh(retro_video_refresh_t cb);
+  void set_audio_sample(retro_audio_sample_t cb);
+  void set_audio_sample_batch(retro_audio_sample_batch_t cb);
+  void set_input_poll(retro_input_poll_t cb);
+  void set_input_state(retro_input_state_t cb);
+
+  void init(void);
+  void deinit(void);
+  void get_system_av_info(struct retro_system_av_info *info);
+  void reset(void);
+  void run(void);
+  bool load_game(const struct retro_game_info *info);
+  void unload_game(void);
+  size_t serialize_size(void);
+  bool serialize(void *data_, size_t size);
+  bool unserialize(const void *data_, size_t size);
+  void set_controller_port_device(unsigned port, unsigned device);
+
+  // keyboard and frame time callbacks
+  void update_keyboard(bool down, unsigned keycode, uint32_t character, uint16_t key_modifiers);
+  void set_frame_time(retro_usec_t usec);
+
+  // disk control interface
+  bool set_eject_state(bool ejected);
+  bool get_eject_state(void);
+  unsigned get_image_index(void);
+  bool set_image_index(unsigned index);
+  unsigned get_num_images(void);
+  bool replace_image_index(unsigned index, const struct retro_game_info *info);
+  bool add_image_index(void);
+  bool get_image_path(unsigned index, char *path, size_t len);
+  bool get_image_label(unsigned index, char *label, size_t len);
+};
+
+}
+
+#endif
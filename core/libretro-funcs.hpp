@@ -24,6 +24,8 @@
 
 #define EP128EMU_SAMPLE_RATE 44100
 #define EP128EMU_SAMPLE_RATE_FLOAT 44100.0
+// maximum number of stereo frames returned by one forwardAudioData() call
+#define EP128EMU_AUDIO_FRAMES_MAX (EP128EMU_SAMPLE_RATE / 4)
 //#define EP128EMU_USE_XRGB8888 1
 #define EP128EMU_SNAPSHOT_SIZE 262144
 
@@ -116,6 +116,67 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "0"
    },
+   {
+      "ep128emu_rahd",
+      "Run-ahead frames",
+      NULL,
+      "Run the emulation ahead and rewind it on every frame to reduce input lag. Suspended during tape, disk and file access.",
+      NULL,
+      "latency",
+      {
+         { "0",  "Off" },
+         { "1",  "1" },
+         { "2",  "2" },
+         { NULL, NULL },
+      },
+      "0"
+   },
+   {
+      "ep128emu_ffsk",
+      "Fast-forward frame skip",
+      NULL,
+      "Draw only one in every N frames and use low quality sound conversion while the frontend is fast-forwarding, for a higher fast-forward speed.",
+      NULL,
+      "latency",
+      {
+         { "1",  "Off" },
+         { "2",  "2" },
+         { "4",  "4" },
+         { "8",  "8" },
+         { NULL, NULL },
+      },
+      "4"
+   },
+   {
+      "ep128emu_fral",
+      "Frame-aligned timing",
+      NULL,
+      "Run each frame until the next vertical sync of the emulated machine, and report its measured refresh rate to the frontend instead of 50 Hz.",
+      NULL,
+      "latency",
+      {
+         { "0",  "Off" },
+         { "1",  "On" },
+         { NULL, NULL },
+      },
+      "0"
+   },
+   {
+      "ep128emu_alat",
+      "Audio latency (ms)",
+      NULL,
+      "Amount of sound buffered between the emulation and the frontend. Lower values reduce the sound delay, but may cause crackling if the frame rate is not stable.",
+      NULL,
+      "latency",
+      {
+         { "2",  "2" },
+         { "5",  "5" },
+         { "10", "10" },
+         { "18", "18" },
+         { NULL, NULL },
+      },
+      "18"
+   },
    {
       "ep128emu_useh",
       "Enable resolution changes (requires restart)",
@@ -327,8 +327,10 @@ LibretroDisplay::getDisplayParameters() const
 
 void LibretroDisplay::drawLine(const uint8_t *buf, size_t nBytes)
 {
+  lineCount++;
 
-  if (curLine >= 0 && curLine < (EP128EMU_LIBRETRO_SCREEN_HEIGHT + 2))
+  if (curLine >= 0 && curLine < (EP128EMU_LIBRETRO_SCREEN_HEIGHT + 2) &&
+      !skippingFrame)
   {
     Message_LineData  *m = allocateMessage<Message_LineData>();
     m->lineNum = curLine;
@@ -350,8 +352,15 @@ void LibretroDisplay::drawLine(const uint8_t *buf, size_t nBytes)
   {
     curLine = (oddFrame ? -1 : 0);
     vsyncCnt++;
-    frameDone();
+    if (!skippingFrame)
+    {
+      frameDone();
+      drawnFrameCount++;
+    }
     frameCount++;
+    frameLines = lineCount - frameStartLine;
+    frameStartLine = lineCount;
+    skippingFrame = (frameSkip > 1 && (frameCount % uint32_t(frameSkip)) != 0);
   }
 }
 
@@ -372,11 +381,43 @@ void LibretroDisplay::vsyncStateChange(bool newState, unsigned int currentSlot_)
     else interlacedFrameCount = interlacedFrameCount > 0 ? interlacedFrameCount - 1 : 0;
   }
 }
+
+void LibretroDisplay::getScanPosition(ScanPosition& p) const
+{
+  p.curLine = curLine;
+  p.vsyncCnt = vsyncCnt;
+  p.vsyncState = vsyncState;
+  p.oddFrame = oddFrame;
+  p.interlacedFrameCount = interlacedFrameCount;
+  p.frameCount = frameCount;
+  p.lineCount = lineCount;
+  p.frameStartLine = frameStartLine;
+  p.frameLines = frameLines;
+  p.drawnFrameCount = drawnFrameCount;
+  p.skippingFrame = skippingFrame;
+}
+
+void LibretroDisplay::setScanPosition(const ScanPosition& p)
+{
+  curLine = p.curLine;
+  vsyncCnt = p.vsyncCnt;
+  vsyncState = p.vsyncState;
+  oddFrame = p.oddFrame;
+  interlacedFrameCount = p.interlacedFrameCount;
+  frameCount = p.frameCount;
+  lineCount = p.lineCount;
+  frameStartLine = p.frameStartLine;
+  frameLines = p.frameLines;
+  drawnFrameCount = p.drawnFrameCount;
+  skippingFrame = p.skippingFrame;
+}
 // --------------------------------------------------------------------------
 
 LibretroDisplay::LibretroDisplay(int xx, int yy, int ww, int hh,
-                                 const char *lbl, bool useHalfFrame_)
-  :     colormap(),
+                                 const char *lbl, bool useHalfFrame_,
+                                 bool createThread_)
+  :     Thread(createThread_),
+        colormap(),
         messageQueue((Message *) 0),
         lastMessage((Message *) 0),
         freeMessageStack((Message *) 0),
@@ -393,6 +434,7 @@ LibretroDisplay::LibretroDisplay(int xx, int yy, int ww, int hh,
         threadLock1(false),
         threadLock2(true),
         exitFlag(false),
+        threadFlag(createThread_),
         displayParameters(),
         savedDisplayParameters(),
         redrawFlag(false),
@@ -405,6 +447,11 @@ LibretroDisplay::LibretroDisplay(int xx, int yy, int ww, int hh,
 #endif // EP128EMU_USE_XRGB8888
         interlacedFrameCount(0),
         frameCount(0),
+        lineCount(0),
+        frameStartLine(0),
+        frameLines(0),
+        drawnFrameCount(0),
+        frameSkip(0),
         contentTopEdge(0),
         contentLeftEdge(0),
         contentBottomEdge(EP128EMU_LIBRETRO_SCREEN_HEIGHT-1),
@@ -441,12 +488,12 @@ LibretroDisplay::LibretroDisplay(int xx, int yy, int ww, int hh,
 #ifdef EP128EMU_USE_XRGB8888
   frameSize = ww * hh * sizeof(uint32_t);
   frame_buf1 = (uint32_t*) calloc(ww * hh, sizeof(uint32_t));
-  frame_buf3 = (uint32_t*) calloc(ww * hh, sizeof(uint32_t));
 #else
   frameSize = ww * hh * sizeof(uint16_t);
   frame_buf1 = (uint16_t*) calloc(ww * hh, sizeof(uint16_t));
-  frame_buf3 = (uint16_t*) calloc(ww * hh, sizeof(uint16_t));
 #endif // EP128EMU_USE_XRGB8888
+  // the spare buffer is only needed for interlaced video, see draw()
+  frame_buf3 = NULL;
   frame_bufActive = frame_buf1;
   frame_bufSpare = frame_buf3;
   lineBuf = (unsigned char*) calloc(ww, sizeof(unsigned char));
@@ -456,6 +503,11 @@ LibretroDisplay::LibretroDisplay(int xx, int yy, int ww, int hh,
 // Enable display processing. If sync is required, do not return until all input is processed.
 void LibretroDisplay::wakeDisplay(bool syncRequired)
 {
+  if (!threadFlag)
+  {
+    processMessages();
+    return;
+  }
   threadLock1.notify();
   if (syncRequired)
   {
@@ -506,24 +558,28 @@ bool LibretroDisplay::isViewportDefault()
 }
 
 // Main display routine implementing Thread::run.
-void LibretroDisplay::run()
+void LibretroDisplay::processMessages()
 {
   bool frameDone;
+  do
+  {
+    frameDone = checkEvents();
+    if (frameDone)
+    {
+      draw(frame_bufActive, scanBorders);
+      scanBorders = false;
+    }
+  }
+  while (frameDone);
+}
+
+void LibretroDisplay::run()
+{
   while (true)
   {
     if (exitFlag) break;
-    frameDone = false;
     threadLock1.wait(10);
-    do
-    {
-      frameDone = checkEvents();
-      if (frameDone)
-      {
-        draw(frame_bufActive, scanBorders);
-        scanBorders = false;
-      }
-    }
-    while (frameDone);
+    processMessages();
     threadLock2.notify();
   }
 }
@@ -532,6 +588,8 @@ void LibretroDisplay::frameDone()
 {
   Message *m = allocateMessage<Message_FrameDone>();
   queueMessage(m);
+  if (!threadFlag)
+    processMessages();
 }
 
 bool LibretroDisplay::checkEvents()
@@ -633,6 +691,28 @@ LibretroDisplay::~LibretroDisplay()
   delete[] lineBuffers;
 }
 
+size_t LibretroDisplay::getMemoryUsage()
+{
+  size_t n = frameSize;
+  if (frame_buf3)
+    n += frameSize;
+  n += EP128EMU_LIBRETRO_SCREEN_WIDTH;
+  n += 289 * sizeof(bool);
+  n += (EP128EMU_LIBRETRO_SCREEN_HEIGHT + 2) * sizeof(Message_LineData *);
+  for (size_t i = 0; i < (EP128EMU_LIBRETRO_SCREEN_HEIGHT + 2); i++)
+  {
+    if (lineBuffers[i])
+      n += sizeof(Message_LineData);
+  }
+  messageQueueMutex.lock();
+  for (Message *m = freeMessageStack; m; m = m->nxt)
+    n += sizeof(Message_LineData);
+  for (Message *m = messageQueue; m; m = m->nxt)
+    n += sizeof(Message_LineData);
+  messageQueueMutex.unlock();
+  return n;
+}
+
 void LibretroDisplay::limitFrameRate(bool isEnabled)
 {
   (void) isEnabled;
@@ -655,6 +735,15 @@ void LibretroDisplay::draw(void * fb, bool scanForBorder)
   {
     frame_bufActive = frame_buf1;
   }
+  if (interlacedFrameCount && !frame_bufSpare)
+  {
+#ifdef EP128EMU_USE_XRGB8888
+    frame_buf3 = (uint32_t*) calloc(frameSize, 1);
+#else
+    frame_buf3 = (uint16_t*) calloc(frameSize, 1);
+#endif // EP128EMU_USE_XRGB8888
+    frame_bufSpare = frame_buf3;
+  }
   for (int yc = 0; yc < EP128EMU_LIBRETRO_SCREEN_HEIGHT; yc++)
   {
     // Skip odd lines if interlace is not used.
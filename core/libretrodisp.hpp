@@ -163,6 +163,7 @@ namespace Ep128Emu {
     static void decodeLine(unsigned char *outBuf,
                            const unsigned char *inBuf, size_t nBytes);
     void frameDone();
+    void processMessages();
     void run();
     // ----------------
     Message       *messageQueue;
@@ -185,6 +186,8 @@ namespace Ep128Emu {
     volatile bool videoResampleEnabled;
     volatile bool exitFlag;
     volatile bool limitFrameRateFlag;
+    // false if the object was created without a display thread
+    bool          threadFlag;
     DisplayParameters   displayParameters;
     DisplayParameters   savedDisplayParameters;
     Timer         limitFrameRateTimer;
@@ -218,6 +221,17 @@ namespace Ep128Emu {
     uint32_t frameSize;
     uint32_t interlacedFrameCount;
     uint32_t frameCount;
+    // number of lines drawn in total, the value of lineCount at the last
+    // vsync, and the number of lines in the last complete frame (zero if
+    // no frame has been completed yet)
+    uint32_t lineCount;
+    uint32_t frameStartLine;
+    uint32_t frameLines;
+    // number of frames passed on for drawing; if frameSkip is greater than
+    // one, only every frameSkip'th frame is drawn (e.g. while the frontend
+    // is fast-forwarding), and the line data of the others is not stored
+    uint32_t drawnFrameCount;
+    int      frameSkip;
     int      contentTopEdge;
     int      contentLeftEdge;
     int      contentBottomEdge;
@@ -228,8 +242,12 @@ namespace Ep128Emu {
     int      viewPortY2;
     volatile bool scanBorders;
     bool bordersScanned;
+    // if 'createThread_' is false, there is no display thread, and
+    // frames are drawn by the thread running the emulation at the end
+    // of each frame
     LibretroDisplay(int xx, int yy, int ww, int hh,
-                               const char *lbl, bool useHalfFrame_);
+                               const char *lbl, bool useHalfFrame_,
+                               bool createThread_ = true);
     virtual ~LibretroDisplay();
     /*!
      * Set color correction and other display parameters
@@ -278,6 +296,25 @@ namespace Ep128Emu {
     void resetViewport(void);
     bool setViewport(int x1, int y1, int x2, int y2);
     bool isViewportDefault(void);
+    // returns the number of bytes allocated for frame and line buffers
+    size_t getMemoryUsage(void);
+    struct ScanPosition {
+      int       curLine;
+      int       vsyncCnt;
+      bool      vsyncState;
+      bool      oddFrame;
+      uint32_t  interlacedFrameCount;
+      uint32_t  frameCount;
+      uint32_t  lineCount;
+      uint32_t  frameStartLine;
+      uint32_t  frameLines;
+      uint32_t  drawnFrameCount;
+      bool      skippingFrame;
+    };
+    // save and restore the current line and frame counters, so that frames
+    // drawn while running ahead are not counted
+    void getScanPosition(ScanPosition& p) const;
+    void setScanPosition(const ScanPosition& p);
 
   };
 
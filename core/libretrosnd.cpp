@@ -29,19 +29,29 @@ sound.swPeriods	16
 #include "ep128emu.hpp"
 #include "system.hpp"
 #include "libretrosnd.hpp"
+#include "libretro-funcs.hpp"
 #include <vector>
 
 namespace Ep128Emu {
 
 #define LIBRETRO_PERIOD_SIZE 16
+// one second of audio, far more than the expected latency of 800 frames
+#define LIBRETRO_PERIOD_COUNT (EP128EMU_SAMPLE_RATE / LIBRETRO_PERIOD_SIZE)
   AudioOutput_libretro::AudioOutput_libretro()
     : AudioOutput(),
       writeBufIndex(0),
       readBufIndex(0),
-      readSubBufIndex(0)
+      readSubBufIndex(0),
+      frameRemainder(0.0),
+      latencyFrames(800),
+      lastFrameValid(false),
+      underrunCnt(0),
+      overrunCnt(0)
   {
+    lastFrame[0] = 0;
+    lastFrame[1] = 0;
     // initialize buffers
-    int nPeriodsSW_ = 44100;
+    int nPeriodsSW_ = LIBRETRO_PERIOD_COUNT;
     int periodSize = LIBRETRO_PERIOD_SIZE;
     buffers.resize(size_t(nPeriodsSW_));
     for (int i = 0; i < nPeriodsSW_; i++)
@@ -81,54 +91,90 @@ namespace Ep128Emu {
     AudioOutput::sendAudioData(buf, nFrames);
   }
 
-  void AudioOutput_libretro::forwardAudioData(int16_t *buf_out, size_t* nFrames, int expectedFrames)
+  void AudioOutput_libretro::skipFrames(size_t n)
   {
-    //printf("Trying forwardAudioData: %d %d\n",readBufIndex,writeBufIndex);
+    size_t  pos = readSubBufIndex + n;
+    readBufIndex = (readBufIndex + (pos / LIBRETRO_PERIOD_SIZE)) % buffers.size();
+    readSubBufIndex = pos % LIBRETRO_PERIOD_SIZE;
+  }
 
-    int currOutputIndex = -1;
-    int expectedLatencyFrames = 800;
+  void AudioOutput_libretro::forwardAudioData(int16_t *buf_out, size_t* nFrames, double expectedFrames)
+  {
     size_t ringBufferSize = buffers.size();
-    int partialFrames_pre = LIBRETRO_PERIOD_SIZE - readSubBufIndex;
 
     forwardMutex.lock();
     size_t writeBufIndex_ = writeBufIndex;
-    int partialFrames_post = buffers[writeBufIndex_].writePos;
+    // the write position is in samples, not frames
+    size_t writeSubBufIndex = buffers[writeBufIndex_].writePos >> 1;
     forwardMutex.unlock();
 
-    signed int availableBuffers = 0;
-    if(readBufIndex<writeBufIndex_)
+    size_t availableFrames = 0;
+    if (readBufIndex != writeBufIndex_ || writeSubBufIndex < readSubBufIndex)
     {
-      availableBuffers = writeBufIndex_ - readBufIndex - 1;
-    }
-    else if (readBufIndex > writeBufIndex_)
-    {
-      availableBuffers = writeBufIndex_ + (ringBufferSize - readBufIndex) -1;
+      // the writer may also have gone round the whole ring buffer
+      size_t availableBuffers = (writeBufIndex_ + ringBufferSize - readBufIndex) % ringBufferSize;
+      if (!availableBuffers)
+        availableBuffers = ringBufferSize;
+      availableFrames = availableBuffers * LIBRETRO_PERIOD_SIZE + writeSubBufIndex - readSubBufIndex;
     }
     else
     {
-      availableBuffers = 0;
-      // if no full buffer available, discard the partial frame as well
-      partialFrames_post = 0;
-      partialFrames_pre = 0;
+      availableFrames = writeSubBufIndex - readSubBufIndex;
     }
-    // do not care about partial frames in the buffer being written
-    int availableFrames = partialFrames_pre + availableBuffers * LIBRETRO_PERIOD_SIZE + partialFrames_post;
 
-    signed int framesToSend = 0;
-    // slowly try to pull frames towards the expected amount
-    framesToSend = expectedFrames + (availableFrames - expectedFrames - expectedLatencyFrames)/100;
-    if (framesToSend > availableFrames) {
+    size_t framesToSend = 0;
+    if (expectedFrames < 0.0)
+    {
+      // send everything written since the last call
       framesToSend = availableFrames;
-      //printf("Audio buffer underrun: rd %d wr %d av %d exp %d fts %d\n",readBufIndex,writeBufIndex_, availableFrames, expectedFrames, framesToSend);
+      frameRemainder = 0.0;
+    }
+    else
+    {
+      // the number of frames produced by the emulation in the frame time,
+      // with the fraction carried over, so that there is no drift
+      double n = expectedFrames + frameRemainder;
+      framesToSend = size_t(n);
+      frameRemainder = n - double(framesToSend);
+      long excessFrames = long(availableFrames) - long(framesToSend) - long(latencyFrames);
+      if (excessFrames > long(EP128EMU_AUDIO_FRAMES_MAX))
+      {
+        // far more is buffered than needed, after a hiccup of the frontend:
+        // drop the oldest frames instead of delaying all sound from now on
+        skipFrames(size_t(excessFrames));
+        availableFrames -= size_t(excessFrames);
+        overrunCnt++;
+      }
+      else
+      {
+        // slowly pull the buffered amount towards the latency
+        excessFrames = excessFrames / 100;
+        if (excessFrames < 0 && size_t(-excessFrames) > framesToSend)
+          framesToSend = 0;
+        else
+          framesToSend = size_t(long(framesToSend) + excessFrames);
+      }
+    }
+    // the output buffer only holds EP128EMU_AUDIO_FRAMES_MAX frames
+    if (framesToSend > EP128EMU_AUDIO_FRAMES_MAX)
+      framesToSend = EP128EMU_AUDIO_FRAMES_MAX;
+    size_t framesToCopy = framesToSend;
+    if (framesToCopy > availableFrames)
+    {
+      framesToCopy = availableFrames;
+      // the sound conversion delays the first samples, that is not an
+      // underrun yet
+      if (lastFrameValid)
+        underrunCnt++;
+      else
+        framesToSend = framesToCopy;
     }
-    //printf("Trying forwardAudioData: rd %d wr %d av %d exp %d fts %d\n",readBufIndex,writeBufIndex_, availableFrames, expectedFrames, framesToSend);
 
-    for (signed int i=0; i<framesToSend; i++)
+    for (size_t i = 0; i < framesToCopy; i++)
     {
       Buffer& buf_ = buffers[readBufIndex];
-      currOutputIndex++;
-      buf_out[(currOutputIndex << 1) + 0] = buf_.audioData[(readSubBufIndex << 1) + 0];
-      buf_out[(currOutputIndex << 1) + 1] = buf_.audioData[(readSubBufIndex << 1) + 1];
+      buf_out[(i << 1) + 0] = buf_.audioData[(readSubBufIndex << 1) + 0];
+      buf_out[(i << 1) + 1] = buf_.audioData[(readSubBufIndex << 1) + 1];
       readSubBufIndex++;
       if (readSubBufIndex>=LIBRETRO_PERIOD_SIZE)
       {
@@ -137,9 +183,51 @@ namespace Ep128Emu {
         if (readBufIndex >= ringBufferSize) readBufIndex = 0;
       }
     }
+    if (framesToCopy > 0)
+    {
+      lastFrameValid = true;
+      lastFrame[0] = buf_out[((framesToCopy - 1) << 1) + 0];
+      lastFrame[1] = buf_out[((framesToCopy - 1) << 1) + 1];
+    }
+    // on underrun, the frontend still gets the expected number of frames
+    for (size_t i = framesToCopy; i < framesToSend; i++)
+    {
+      buf_out[(i << 1) + 0] = lastFrame[0];
+      buf_out[(i << 1) + 1] = lastFrame[1];
+    }
+
+    nFrames[0] = framesToSend;
+  }
 
-    //printf("Returned frames: %d\n",currOutputIndex);
-    nFrames[0]=currOutputIndex+1;
+  void AudioOutput_libretro::setLatency(size_t nFrames)
+  {
+    latencyFrames = (nFrames < EP128EMU_AUDIO_FRAMES_MAX ? nFrames : EP128EMU_AUDIO_FRAMES_MAX);
+  }
+
+  void AudioOutput_libretro::getWritePosition(size_t& bufIndex, size_t& pos)
+  {
+    forwardMutex.lock();
+    bufIndex = writeBufIndex;
+    pos = buffers[writeBufIndex].writePos;
+    forwardMutex.unlock();
+  }
+
+  void AudioOutput_libretro::setWritePosition(size_t bufIndex, size_t pos)
+  {
+    forwardMutex.lock();
+    // only the buffer being written may have a non-zero write position
+    buffers[writeBufIndex].writePos = 0;
+    writeBufIndex = bufIndex;
+    buffers[writeBufIndex].writePos = pos;
+    forwardMutex.unlock();
+  }
+
+  size_t AudioOutput_libretro::getMemoryUsage() const
+  {
+    size_t  n = buffers.capacity() * sizeof(Buffer);
+    for (size_t i = 0; i < buffers.size(); i++)
+      n += buffers[i].audioData.capacity() * sizeof(int16_t);
+    return n;
   }
 
   void AudioOutput_libretro::closeDevice()
@@ -31,11 +31,9 @@ class AudioOutput_libretro : public AudioOutput {
    private:
     struct Buffer {
       std::vector< int16_t >    audioData;
-      ThreadLock  lrLock;
-      ThreadLock  epLock;
       size_t      writePos;
       Buffer()
-        : lrLock(true), epLock(true), writePos(0)
+        : writePos(0)
       {
       }
       ~Buffer()
@@ -47,13 +45,49 @@ class AudioOutput_libretro : public AudioOutput {
     size_t        readBufIndex;
     size_t        readSubBufIndex;
     Mutex         forwardMutex;
+    // fraction of a sample frame not sent yet by forwardAudioData()
+    double        frameRemainder;
+    // number of sample frames to keep buffered
+    size_t        latencyFrames;
+    // last frame sent, repeated if there are not enough samples
+    bool          lastFrameValid;
+    int16_t       lastFrame[2];
+    size_t        underrunCnt;
+    size_t        overrunCnt;
+    void skipFrames(size_t n);
 
    public:
     AudioOutput_libretro();
     virtual ~AudioOutput_libretro();
     virtual void sendAudioData(const int16_t *buf, size_t nFrames);
-    virtual void forwardAudioData(int16_t *buf_out, size_t* nFrames, int expectedFrames);
+    virtual void forwardAudioData(int16_t *buf_out, size_t* nFrames, double expectedFrames);
     virtual void closeDevice();
+    // set the number of sample frames kept buffered between the emulation
+    // and the frontend (default: 800); lower values reduce the latency, but
+    // make underruns more likely if the frame times vary
+    void setLatency(size_t nFrames);
+    inline size_t getLatency() const
+    {
+      return latencyFrames;
+    }
+    // number of calls to forwardAudioData() that had to repeat the last
+    // sample frame because the emulation has not produced enough samples
+    inline size_t getUnderrunCount() const
+    {
+      return underrunCnt;
+    }
+    // number of times the buffered samples exceeded the latency by more
+    // than EP128EMU_AUDIO_FRAMES_MAX, and the excess was discarded
+    inline size_t getOverrunCount() const
+    {
+      return overrunCnt;
+    }
+    // save and restore the write position, so that the audio data written
+    // in between is discarded (used for run-ahead)
+    void getWritePosition(size_t& bufIndex, size_t& pos);
+    void setWritePosition(size_t bufIndex, size_t pos);
+    // returns the number of bytes allocated for the ring buffer
+    size_t getMemoryUsage() const;
   };
 }       // namespace Ep128Emu
 
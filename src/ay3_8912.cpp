@@ -69,6 +69,11 @@ namespace ZX128 {
     envEnabledA = false;
     envEnabledB = false;
     envEnabledC = false;
+    outputA = 0;
+    outputB = 0;
+    outputC = 0;
+    skipCnt = 0U;
+    skippedCycles = 0U;
     for (uint16_t i = 0; i < 16; i++)
       writeRegister(i, 0x00);
   }
@@ -100,6 +105,9 @@ namespace ZX128 {
 
   void AY3_8912::writeRegister(uint16_t addr, uint8_t value)
   {
+    if (skippedCycles)
+      updateCounters();
+    skipCnt = 0U;
     addr = addr & 0x0F;
     registers[addr] = value & registerMaskTable[addr];
     switch (addr) {
@@ -175,8 +183,94 @@ namespace ZX128 {
     }
   }
 
-  void AY3_8912::runOneCycle(uint16_t& outA, uint16_t& outB, uint16_t& outC)
+  // Advances a tone or envelope generator counter by 'n' cycles, and
+  // returns the number of times the counter was reloaded from 'period'.
+
+  template <typename T>
+  static EP128EMU_INLINE uint32_t skipCounterCycles(T& cnt, T period,
+                                                    uint32_t n)
+  {
+    uint32_t  d = uint32_t(cnt > T(1) ? (cnt - T(1)) : T(0));
+    if (n <= d) {
+      cnt = cnt - T(n);
+      return 0U;
+    }
+    n = n - (d + 1U);
+    cnt = period;
+    uint32_t  p = uint32_t(period > T(1) ? period : T(1));
+    uint32_t  nReloads = (n / p) + 1U;
+    cnt = cnt - T(n % p);
+    return nReloads;
+  }
+
+  EP128EMU_INLINE void AY3_8912::stepEnvelope()
+  {
+    envState += envDir;
+    if (envState < 0 || envState > 31) {
+      if (envHold || !envContinue) {
+        envState = ((envAlternate == envAttack || !envContinue) ? 0 : 31);
+        envDir = 0;
+      }
+      else if (!envAlternate) {
+        envState = envState & 31;
+      }
+      else {
+        envState -= envDir;
+        envDir = -envDir;
+      }
+    }
+    if (envEnabledA)
+      amplitudeA = amplitudeTable[envState >> 1];
+    if (envEnabledB)
+      amplitudeB = amplitudeTable[envState >> 1];
+    if (envEnabledC)
+      amplitudeC = amplitudeTable[envState >> 1];
+  }
+
+  void AY3_8912::updateCounters()
+  {
+    uint32_t  n = skippedCycles;
+    skippedCycles = 0U;
+    tgStateA = tgStateA ^ bool(skipCounterCycles(tgCntA, tgFreqA, n) & 1U);
+    tgStateB = tgStateB ^ bool(skipCounterCycles(tgCntB, tgFreqB, n) & 1U);
+    tgStateC = tgStateC ^ bool(skipCounterCycles(tgCntC, tgFreqC, n) & 1U);
+    for (uint32_t i = n; i > 0U; ) {
+      if (!(ngCnt & 0x7E)) {
+        ngCnt = (ngCnt ^ 0x80) | ngFreq;
+        if (!(ngCnt & 0x80)) {
+          ngState = bool(ngShiftReg & 0x00008000U);
+          ngShiftReg = ((ngShiftReg & 0x0000FFFFU) << 1)
+                       | ((~((ngShiftReg >> 16) ^ (ngShiftReg >> 13))) & 1U);
+        }
+        i--;
+      }
+      else {
+        int     d = (ngCnt & 0x7F) - 1;
+        d = (uint32_t(d) < i ? d : int(i));
+        ngCnt = ngCnt - d;
+        i = i - uint32_t(d);
+      }
+    }
+    while (envDir != 0 && n > 0U) {
+      if (envCnt > 1U) {
+        uint32_t  d = (envCnt - 1U < n ? envCnt - 1U : n);
+        envCnt = envCnt - d;
+        n = n - d;
+      }
+      else {
+        envCnt = envFreq;
+        stepEnvelope();
+        n--;
+      }
+    }
+    if (n > 0U)
+      (void) skipCounterCycles(envCnt, envFreq, n);
+  }
+
+  void AY3_8912::runOneCycle_(uint16_t& outA, uint16_t& outB, uint16_t& outC)
   {
+    if (skippedCycles)
+      updateCounters();
     outA = (((tgStateA | tgDisabledA) & (ngState | ngDisabledA)) ?
             amplitudeA : uint16_t(0));
     outB = (((tgStateB | tgDisabledB) & (ngState | ngDisabledB)) ?
@@ -217,32 +311,38 @@ namespace ZX128 {
     }
     if (envCnt <= 1U) {
       envCnt = envFreq;
-      if (envDir != 0) {
-        envState += envDir;
-        if (envState < 0 || envState > 31) {
-          if (envHold || !envContinue) {
-            envState = ((envAlternate == envAttack || !envContinue) ? 0 : 31);
-            envDir = 0;
-          }
-          else if (!envAlternate) {
-            envState = envState & 31;
-          }
-          else {
-            envState -= envDir;
-            envDir = -envDir;
-          }
-        }
-        if (envEnabledA)
-          amplitudeA = amplitudeTable[envState >> 1];
-        if (envEnabledB)
-          amplitudeB = amplitudeTable[envState >> 1];
-        if (envEnabledC)
-          amplitudeC = amplitudeTable[envState >> 1];
-      }
+      if (envDir != 0)
+        stepEnvelope();
     }
     else {
       envCnt--;
     }
+    // find the number of cycles until the output may change: a channel
+    // depends on the tone generator if it is enabled and the amplitude is
+    // not zero, and similarly on the noise and envelope generators
+    bool    usedA = (amplitudeA != 0 || envEnabledA);
+    bool    usedB = (amplitudeB != 0 || envEnabledB);
+    bool    usedC = (amplitudeC != 0 || envEnabledC);
+    uint32_t  n = 0x40000000U;
+    if (usedA && !tgDisabledA)
+      n = (uint32_t(tgCntA) < n ? uint32_t(tgCntA) : n);
+    if (usedB && !tgDisabledB)
+      n = (uint32_t(tgCntB) < n ? uint32_t(tgCntB) : n);
+    if (usedC && !tgDisabledC)
+      n = (uint32_t(tgCntC) < n ? uint32_t(tgCntC) : n);
+    if ((usedA && !ngDisabledA) | (usedB && !ngDisabledB)
+        | (usedC && !ngDisabledC)) {
+      n = (uint32_t(ngCnt & 0x7F) < n ? uint32_t(ngCnt & 0x7F) : n);
+    }
+    if (envDir != 0 && (envEnabledA | envEnabledB | envEnabledC))
+      n = (envCnt < n ? envCnt : n);
+    outputA = (((tgStateA | tgDisabledA) & (ngState | ngDisabledA)) ?
+               amplitudeA : uint16_t(0));
+    outputB = (((tgStateB | tgDisabledB) & (ngState | ngDisabledB)) ?
+               amplitudeB : uint16_t(0));
+    outputC = (((tgStateC | tgDisabledC) & (ngState | ngDisabledC)) ?
+               amplitudeC : uint16_t(0));
+    skipCnt = (n > 1U ? (n - 1U) : 0U);
   }
 
   // --------------------------------------------------------------------------
@@ -271,6 +371,8 @@ namespace ZX128 {
 
   void AY3_8912::saveState(Ep128Emu::File::Buffer& buf)
   {
+    if (skippedCycles)
+      updateCounters();
     buf.setPosition(0);
     buf.writeUInt32(0x01000001U);       // version number
     for (int i = 0; i < 16; i++)
@@ -358,5 +460,10 @@ namespace ZX128 {
     }
   }
 
+  void AY3_8912::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, AY3_8912, registers, portAInput);
+  }
+
 }       // namespace ZX128
 
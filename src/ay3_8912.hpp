@@ -62,16 +62,40 @@ namespace ZX128 {
     bool      envEnabledA;              // envelope to channel A enable flag
     bool      envEnabledB;              // envelope to channel B enable flag
     bool      envEnabledC;              // envelope to channel C enable flag
+    uint16_t  outputA;                  // channel A output in the next cycle
+    uint16_t  outputB;                  // channel B output in the next cycle
+    uint16_t  outputC;                  // channel C output in the next cycle
+    uint32_t  skipCnt;                  // cycles with unchanged output
+    uint32_t  skippedCycles;            // cycles not applied to the counters
     uint8_t   portAInput;               // port A input byte (defaults to 0xFF)
     // --------
     void resetRegisters();
+    EP128EMU_INLINE void stepEnvelope();
+    // applies the skipped cycles to the generator counters
+    void updateCounters();
+    void runOneCycle_(uint16_t& outA, uint16_t& outB, uint16_t& outC);
    public:
     AY3_8912();
     virtual ~AY3_8912();
     void reset();
     uint8_t readRegister(uint16_t addr) const;
     void writeRegister(uint16_t addr, uint8_t value);
-    void runOneCycle(uint16_t& outA, uint16_t& outB, uint16_t& outC);
+    // The generators are only stepped on cycles where the output may
+    // change; in between, the counters are updated lazily, and the output
+    // of the previous cycle is returned.
+    EP128EMU_INLINE void runOneCycle(uint16_t& outA, uint16_t& outB,
+                                     uint16_t& outC)
+    {
+      if (EP128EMU_EXPECT(skipCnt > 0U)) {
+        skipCnt--;
+        skippedCycles++;
+        outA = outputA;
+        outB = outputB;
+        outC = outputC;
+        return;
+      }
+      runOneCycle_(outA, outB, outC);
+    }
     inline void setPortAInput(uint8_t value)
     {
       portAInput = value;
@@ -85,6 +109,7 @@ namespace ZX128 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace ZX128
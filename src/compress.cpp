@@ -24,6 +24,8 @@
 
 #define COMPRESS_MAX_THREADS    4
 #define COMPRESS_BLOCK_SIZE     65536
+// maximum number of hash chain entries checked by the fast compression mode
+#define COMPRESS_FAST_MAX_CHAIN 16
 
 namespace Ep128Emu {
 
@@ -86,6 +88,9 @@ namespace Ep128Emu {
     // --------
     void writeRepeatCode(std::vector< unsigned int >& buf, size_t d, size_t n);
     inline size_t getRepeatCodeLength(size_t d, size_t n) const;
+    void findMatchesGreedy(LZMatchParameters *matchTable,
+                           const unsigned char *inBuf,
+                           size_t offs, size_t nBytes);
     void optimizeMatches_noStats(LZMatchParameters *matchTable,
                                  size_t *bitCountTable,
                                  size_t offs, size_t nBytes);
@@ -96,14 +101,17 @@ namespace Ep128Emu {
                          size_t offs, size_t nBytes);
     size_t compressData(std::vector< unsigned int >& outBuf,
                         const unsigned char *inBuf, size_t offs, size_t nBytes,
-                        bool firstPass, bool fastMode = false);
+                        bool firstPass, bool fastMode = false,
+                        const LZMatchParameters *greedyMatches =
+                            (LZMatchParameters *) 0);
    public:
     Compressor_M2();
     virtual ~Compressor_M2();
     void compressDataBlock(std::vector< unsigned int >& outBuf,
                            const unsigned char *inBuf, size_t offs,
                            size_t nBytes, size_t bufSize,
-                           bool isLastBlock, bool fastMode = false);
+                           bool isLastBlock, bool fastMode = false,
+                           bool greedyMode = false);
   };
 
   // --------------------------------------------------------------------------
@@ -167,6 +175,86 @@ namespace Ep128Emu {
     return nBits;
   }
 
+  void Compressor_M2::findMatchesGreedy(LZMatchParameters *matchTable,
+                                        const unsigned char *inBuf,
+                                        size_t offs, size_t nBytes)
+  {
+    // simple hash chain search for the fast compression mode: at each
+    // position, the longest match of at least 3 bytes is used if found,
+    // without trying to find an optimal sequence of matches and literals
+    size_t  endPos = offs + nBytes;
+    std::vector< unsigned int > hashHead(65536, 0xFFFFFFFFU);
+    std::vector< unsigned int > hashPrev(endPos, 0xFFFFFFFFU);
+    size_t  literalStart = 0;
+    for (size_t i = 0; i < endPos; ) {
+      size_t  bestLen = 0;
+      size_t  bestOffs = 0;
+      size_t  maxLen = endPos - i;
+      if (maxLen > size_t(lengthMaxValue))
+        maxLen = size_t(lengthMaxValue);
+      unsigned int  h = 0U;
+      if (maxLen >= 3) {
+        h = ((unsigned int) inBuf[i] << 8) ^ ((unsigned int) inBuf[i + 1] << 4)
+            ^ (unsigned int) inBuf[i + 2];
+        h = ((h * 0x9E3779B1U) >> 16) & 0xFFFFU;
+        if (i >= offs) {
+          unsigned int  j = hashHead[h];
+          for (size_t k = 0;
+               j != 0xFFFFFFFFU && k < COMPRESS_FAST_MAX_CHAIN &&
+               (i - size_t(j)) <= maxRepeatDist;
+               j = hashPrev[j], k++) {
+            size_t  len = 0;
+            while (len < maxLen && inBuf[size_t(j) + len] == inBuf[i + len])
+              len++;
+            if (len > bestLen) {
+              bestLen = len;
+              bestOffs = i - size_t(j);
+              if (len >= maxLen)
+                break;
+            }
+          }
+        }
+      }
+      size_t  n = (bestLen >= 3 ? bestLen : 1);
+      if (i >= offs) {
+        if (bestLen >= 3) {
+          if ((i - literalStart) >= literalSequenceMinLength) {
+            // store pending literal bytes as a sequence
+            matchTable[literalStart - offs].len =
+                (unsigned int) (i - literalStart);
+          }
+          matchTable[i - offs].d = (unsigned int) bestOffs;
+          matchTable[i - offs].len = (unsigned int) bestLen;
+          literalStart = i + n;
+        }
+        else {
+          matchTable[i - offs].clear();
+          // merge literal bytes into sequences
+          size_t  litLen = (i + 1) - literalStart;
+          if (litLen >= literalSequenceMinLength &&
+              ((i + 1) >= endPos ||
+               litLen >= (literalSequenceMinLength + 255))) {
+            matchTable[literalStart - offs].len = (unsigned int) litLen;
+            literalStart = i + 1;
+          }
+        }
+      }
+      else {
+        literalStart = offs;
+      }
+      // add all positions covered to the hash chains
+      for (size_t k = 0; k < n; k++, i++) {
+        if ((endPos - i) < 3)
+          continue;
+        h = ((unsigned int) inBuf[i] << 8) ^ ((unsigned int) inBuf[i + 1] << 4)
+            ^ (unsigned int) inBuf[i + 2];
+        h = ((h * 0x9E3779B1U) >> 16) & 0xFFFFU;
+        hashPrev[i] = hashHead[h];
+        hashHead[h] = (unsigned int) i;
+      }
+    }
+  }
+
   void Compressor_M2::optimizeMatches_noStats(LZMatchParameters *matchTable,
                                               size_t *bitCountTable,
                                               size_t offs, size_t nBytes)
@@ -410,7 +498,8 @@ namespace Ep128Emu {
   size_t Compressor_M2::compressData(std::vector< unsigned int >& tmpOutBuf,
                                      const unsigned char *inBuf,
                                      size_t offs, size_t nBytes,
-                                     bool firstPass, bool fastMode)
+                                     bool firstPass, bool fastMode,
+                                     const LZMatchParameters *greedyMatches)
   {
     size_t  endPos = offs + nBytes;
     size_t  nSymbols = 0;
@@ -426,7 +515,11 @@ namespace Ep128Emu {
     // compress data by searching for repeated byte sequences,
     // and replacing them with length/distance codes
     std::vector< LZMatchParameters >  matchTable(nBytes);
-    {
+    if (greedyMatches) {
+      for (size_t i = 0; i < nBytes; i++)
+        matchTable[i] = greedyMatches[i];
+    }
+    else {
       std::vector< size_t > bitCountTable(nBytes + 1, 0);
       if (!firstPass) {
         std::vector< unsigned int > offsSumTable(nBytes + 1, 0U);
@@ -581,7 +674,8 @@ namespace Ep128Emu {
   void Compressor_M2::compressDataBlock(std::vector< unsigned int >& outBuf,
                                         const unsigned char *inBuf, size_t offs,
                                         size_t nBytes, size_t bufSize,
-                                        bool isLastBlock, bool fastMode)
+                                        bool isLastBlock, bool fastMode,
+                                        bool greedyMode)
   {
     outBuf.clear();
     if ((offs + nBytes) > bufSize)
@@ -592,7 +686,7 @@ namespace Ep128Emu {
     // that maxRepeatDist is an integer multiple of
     {
       size_t  searchTableStart = (offs / maxRepeatDist) * maxRepeatDist;
-      bool    searchTableNeeded = (offs == searchTableStart);
+      bool    searchTableNeeded = (offs == searchTableStart && !greedyMode);
       if (searchTableNeeded) {
         if (!searchTable) {
           searchTable = new Ep128Compress::LZSearchTable(
@@ -618,12 +712,21 @@ namespace Ep128Emu {
     size_t  bestSize = 0x7FFFFFFF;
     size_t  nSymbols = 0;
     bool    doneFlag = false;
-    for (size_t i = 0; i < 40; i++) {
+    std::vector< LZMatchParameters >  greedyMatches;
+    if (greedyMode) {
+      // fast mode: the matches are found only once, and a single pass is
+      // needed to calculate the encode tables before writing the data
+      greedyMatches.resize(nBytes);
+      findMatchesGreedy(&(greedyMatches.front()), inBuf, offs, nBytes);
+    }
+    for (size_t i = 0; i < (greedyMode ? 2 : 40); i++) {
       if (doneFlag)     // if the compression cannot be optimized further,
         continue;       // quit the loop earlier
       tmpBuf.clear();
       size_t  tmp =
-          compressData(tmpBuf, inBuf, offs, nBytes, (i == 0), fastMode);
+          compressData(tmpBuf, inBuf, offs, nBytes, (i == 0), fastMode,
+                       (greedyMode ?
+                        &(greedyMatches.front()) : (LZMatchParameters *) 0));
       if (i == 0)       // the first optimization pass writes no data
         continue;
       // calculate compressed size and hash value
@@ -677,33 +780,65 @@ namespace Ep128Emu {
   class CompressorThread : public Thread {
    private:
     Compressor_M2 compressor;
+    ThreadLock    jobDoneLock;
+    volatile bool exitFlag;
+    void compressBlocks();
    public:
     std::vector< unsigned int > outBuf;
     const unsigned char *inBuf;
     size_t  inBufSize;
     size_t  startPos;
     size_t  blockSize;
+    bool    greedyMode;
     bool    errorFlag;
     // --------
     CompressorThread();
     virtual ~CompressorThread();
     virtual void run();
+    // start compressing the data set up in the public members
+    inline void startJob()
+    {
+      start();
+    }
+    // wait until the job started with startJob() is finished
+    inline void waitJob()
+    {
+      jobDoneLock.wait();
+    }
   };
 
   CompressorThread::CompressorThread()
-    : inBuf((unsigned char *) 0),
+    : Thread(),
+      jobDoneLock(false),
+      exitFlag(false),
+      inBuf((unsigned char *) 0),
       inBufSize(0),
       startPos(0),
       blockSize(Compressor_M2::maxRepeatDist),
+      greedyMode(false),
       errorFlag(false)
   {
   }
 
   CompressorThread::~CompressorThread()
   {
+    exitFlag = true;
+    start();
+    join();
   }
 
   void CompressorThread::run()
+  {
+    // the thread is kept running between calls to compressData(),
+    // and waits for the next job after finishing the previous one
+    while (!exitFlag) {
+      compressBlocks();
+      jobDoneLock.notify();
+      wait();
+    }
+  }
+
+  void CompressorThread::compressBlocks()
   {
     try {
       if (!inBuf)
@@ -715,7 +850,8 @@ namespace Ep128Emu {
         if ((startPos + nBytes) > inBufSize)
           nBytes = inBufSize - startPos;
         compressor.compressDataBlock(tmpBuf, inBuf, startPos, nBytes, inBufSize,
-                                     ((startPos + nBytes) >= inBufSize), true);
+                                     ((startPos + nBytes) >= inBufSize), true,
+                                     greedyMode);
         // append compressed data to output buffer
         size_t  prvSize = outBuf.size();
         if ((startPos % Compressor_M2::maxRepeatDist) == 0) {
@@ -745,34 +881,86 @@ namespace Ep128Emu {
 
   // --------------------------------------------------------------------------
 
+  // Set of compressor threads that are created on first use, and reused by
+  // all later calls to compressData(). Only one compression can use the
+  // threads at a time, concurrent calls are serialized by 'mutex_'.
+
+  class CompressorThreadPool {
+   private:
+    CompressorThread  *threads[COMPRESS_MAX_THREADS];
+   public:
+    Mutex   mutex_;
+    CompressorThreadPool()
+    {
+      for (int i = 0; i < COMPRESS_MAX_THREADS; i++)
+        threads[i] = (CompressorThread *) 0;
+    }
+    ~CompressorThreadPool()
+    {
+      for (int i = 0; i < COMPRESS_MAX_THREADS; i++) {
+        if (threads[i])
+          delete threads[i];
+      }
+    }
+    // returns thread 'n', creating it first if necessary;
+    // should only be called with 'mutex_' locked
+    CompressorThread& getThread(int n)
+    {
+      if (!threads[n])
+        threads[n] = new CompressorThread();
+      return *(threads[n]);
+    }
+  };
+
+  static CompressorThreadPool& getCompressorThreadPool()
+  {
+    static CompressorThreadPool threadPool;
+    return threadPool;
+  }
+
+  // --------------------------------------------------------------------------
+
   void compressData(std::vector< unsigned char >& outBuf,
-                    const unsigned char *inBuf, size_t inBufSize)
+                    const unsigned char *inBuf, size_t inBufSize,
+                    bool fastCompression)
   {
     outBuf.clear();
     if (inBufSize < 1 || !inBuf)
       return;
+    CompressorThreadPool& threadPool = getCompressorThreadPool();
     CompressorThread  *compressorThreads[COMPRESS_MAX_THREADS];
     for (int i = 0; i < COMPRESS_MAX_THREADS; i++)
       compressorThreads[i] = (CompressorThread *) 0;
+    threadPool.mutex_.lock();
+    int     nThreads = 0;
     try {
       size_t  startPos = 0;
-      int     nThreads = 0;
       while (nThreads < COMPRESS_MAX_THREADS && startPos < inBufSize) {
-        compressorThreads[nThreads] = new CompressorThread();
+        compressorThreads[nThreads] = &(threadPool.getThread(nThreads));
+        compressorThreads[nThreads]->outBuf.clear();
         compressorThreads[nThreads]->inBuf = inBuf;
         compressorThreads[nThreads]->inBufSize = inBufSize;
         compressorThreads[nThreads]->startPos = startPos;
         compressorThreads[nThreads]->blockSize = COMPRESS_BLOCK_SIZE;
+        compressorThreads[nThreads]->greedyMode = fastCompression;
+        compressorThreads[nThreads]->errorFlag = false;
         startPos = startPos + Compressor_M2::maxRepeatDist;
         nThreads++;
       }
-      for (int i = 0; i < nThreads; i++)
-        compressorThreads[i]->start();
-      for (int i = 0; i < nThreads; i++) {
-        compressorThreads[i]->join();
-        // startPos is now the read position of the output buffer of the thread
-        compressorThreads[i]->startPos = 0;
-      }
+    }
+    catch (...) {
+      threadPool.mutex_.unlock();
+      throw;
+    }
+    for (int i = 0; i < nThreads; i++)
+      compressorThreads[i]->startJob();
+    for (int i = 0; i < nThreads; i++) {
+      compressorThreads[i]->waitJob();
+      // startPos is now the read position of the output buffer of the thread
+      compressorThreads[i]->startPos = 0;
+    }
+    try {
+      size_t  startPos = 0;
       size_t        savedBufPos = 0x7FFFFFFF;
       unsigned char shiftReg = 0x01;
       for (int i = 0; true; i++) {
@@ -809,7 +997,7 @@ namespace Ep128Emu {
         if (compressorThreads[i]->startPos
             >= compressorThreads[i]->outBuf.size()) {
           // end of compressed data for this thread
-          delete compressorThreads[i];
+          compressorThreads[i]->outBuf.clear();
           compressorThreads[i] = (CompressorThread *) 0;
           continue;
         }
@@ -862,11 +1050,13 @@ namespace Ep128Emu {
     catch (...) {
       for (int i = 0; i < COMPRESS_MAX_THREADS; i++) {
         if (compressorThreads[i])
-          delete compressorThreads[i];
+          compressorThreads[i]->outBuf.clear();
       }
+      threadPool.mutex_.unlock();
       outBuf.clear();
       throw;
     }
+    threadPool.mutex_.unlock();
   }
 
 }       // namespace Ep128Emu
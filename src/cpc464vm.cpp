@@ -96,6 +96,19 @@ namespace CPC464 {
     } while (EP128EMU_UNLIKELY(z80OpcodeHalfCycles >= 8));
   }
 
+  EP128EMU_INLINE bool CPC464VM::runHaltCycle()
+  {
+    // repeat the HALT opcode fetch with the same timing as
+    // Z80_::readOpcodeFirstByte(), but without reading and decoding the
+    // opcode, unless breakpoints or single step mode need the read
+    if (singleStepMode || memory.getHaveBreakPoints())
+      return false;
+    memoryWaitM1();
+    updateCPUHalfCycles(4);
+    z80.executeHaltCycle();
+    return true;
+  }
+
   EP128EMU_INLINE void CPC464VM::ioPortWait()
   {
     updateCPUHalfCycles(((~(int(z80OpcodeHalfCycles) + 5)) & 6) + 7);
@@ -106,12 +119,8 @@ namespace CPC464 {
 
   EP128EMU_REGPARM1 void CPC464VM::runOneCycle()
   {
-    CPC464VMCallback *p = firstCallback;
-    while (p) {
-      CPC464VMCallback *nxt = p->nxt;
-      p->func(p->userData);
-      p = nxt;
-    }
+    if (EP128EMU_UNLIKELY(!(--callbackCyclesRemaining)))
+      runCallbacks();
     if (--ayCycleCnt == 0) {
       ayCycleCnt = 8;
       if (--floppyCycleCnt == 0) {
@@ -226,6 +235,28 @@ namespace CPC464 {
     return retval;
   }
 
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_REGPARM1 uint32_t CPC464VM::Z80_::readOpcodeFirstByteDecoded()
+  {
+    // readOpcodeFirstByte(), followed by the memory timing of the operand
+    // reads that the predecoded instruction already includes
+    uint32_t  retval = 0U;
+    if (EP128EMU_EXPECT(!(vm.singleStepMode ||
+                          vm.memory.getHaveBreakPoints()))) {
+      retval = vm.memory.readOpcodeDecoded(uint16_t(R.PC.W.l));
+    }
+    if (EP128EMU_UNLIKELY(!retval))
+      return (Z80_PREDECODED_VALID | uint32_t(Z80_::readOpcodeFirstByte()));
+    vm.memoryWaitM1();
+    vm.updateCPUHalfCycles(4);
+    for (uint32_t n = (retval >> 24) & 3U; n; n--) {
+      vm.memoryWait();
+      vm.updateCPUHalfCycles(1);
+    }
+    return retval;
+  }
+#endif
+
   EP128EMU_REGPARM3 void CPC464VM::Z80_::writeMemory(uint16_t addr,
                                                      uint8_t value)
   {
@@ -759,7 +790,7 @@ namespace CPC464 {
     vm.videoRenderer.crtcVSyncStateChange(newState);
   }
 
-  void CPC464VM::tapeCallback(void *userData)
+  uint32_t CPC464VM::tapeCallback(void *userData)
   {
     CPC464VM& vm = *(reinterpret_cast<CPC464VM *>(userData));
     vm.tapeSamplesRemaining += vm.tapeSamplesPerCRTCCycle;
@@ -772,9 +803,21 @@ namespace CPC464 {
       if (vm.tapeInputSignal != prvTapeInput)
         vm.updatePPIState();
     }
+    // number of cycles until the next sample
+    uint32_t  n = 0x40000000U;
+    if (vm.tapeSamplesRemaining >= 0) {
+      n = 1U;
+    }
+    else if (vm.tapeSamplesPerCRTCCycle > 0) {
+      int64_t tmp = (vm.tapeSamplesPerCRTCCycle - 1 - vm.tapeSamplesRemaining)
+                    / vm.tapeSamplesPerCRTCCycle;
+      n = uint32_t(tmp < 0x40000000 ? tmp : 0x40000000);
+    }
+    vm.tapeSamplesRemaining += (int64_t(n - 1U) * vm.tapeSamplesPerCRTCCycle);
+    return n;
   }
 
-  void CPC464VM::demoPlayCallback(void *userData)
+  uint32_t CPC464VM::demoPlayCallback(void *userData)
   {
     CPC464VM& vm = *(reinterpret_cast<CPC464VM *>(userData));
     while (!vm.demoTimeCnt) {
@@ -816,20 +859,25 @@ namespace CPC464 {
         break;
       }
     }
-    if (vm.demoTimeCnt)
-      vm.demoTimeCnt--;
+    // wait until the next event
+    uint32_t  n = uint32_t(vm.demoTimeCnt < 0x40000000U ?
+                           vm.demoTimeCnt : 0x40000000U);
+    vm.demoTimeCnt -= n;
+    return (n > 0U ? n : 1U);
   }
 
-  void CPC464VM::demoRecordCallback(void *userData)
+  uint32_t CPC464VM::demoRecordCallback(void *userData)
   {
     CPC464VM& vm = *(reinterpret_cast<CPC464VM *>(userData));
     vm.demoTimeCnt++;
+    return 1U;
   }
 
-  void CPC464VM::videoCaptureCallback(void *userData)
+  uint32_t CPC464VM::videoCaptureCallback(void *userData)
   {
     CPC464VM& vm = *(reinterpret_cast<CPC464VM *>(userData));
     vm.videoCapture->runOneCycle(vm.soundOutputSignal);
+    return 1U;
   }
 
   uint8_t CPC464VM::checkSingleStepModeBreak()
@@ -926,8 +974,8 @@ namespace CPC464 {
     updatePPIState();
   }
 
-  void CPC464VM::setCallback(void (*func)(void *userData), void *userData_,
-                             bool isEnabled)
+  void CPC464VM::setCallback(uint32_t (*func)(void *userData),
+                             void *userData_, bool isEnabled)
   {
     if (!func)
       return;
@@ -954,7 +1002,7 @@ namespace CPC464 {
         p = p->nxt;
       }
       if (!isEnabled) {
-        callbacks[ndx].func = (void (*)(void *)) 0;
+        callbacks[ndx].func = (uint32_t (*)(void *)) 0;
         callbacks[ndx].userData = (void *) 0;
         callbacks[ndx].nxt = (CPC464VMCallback *) 0;
       }
@@ -963,7 +1011,7 @@ namespace CPC464 {
       return;
     if (ndx < 0) {
       for (size_t i = 0; i < maxCallbacks; i++) {
-        if (callbacks[i].func == (void (*)(void *)) 0) {
+        if (callbacks[i].func == (uint32_t (*)(void *)) 0) {
           ndx = int(i);
           break;
         }
@@ -974,6 +1022,12 @@ namespace CPC464 {
     callbacks[ndx].func = func;
     callbacks[ndx].userData = userData_;
     callbacks[ndx].nxt = (CPC464VMCallback *) 0;
+    // schedule the function for the next cycle
+    callbacks[ndx].delay = (callbackCycles - callbackCyclesRemaining) + 1U;
+    if (callbackCyclesRemaining > 1U) {
+      callbackCycles = callbackCycles - callbackCyclesRemaining + 1U;
+      callbackCyclesRemaining = 1U;
+    }
     if (isEnabled) {
       CPC464VMCallback   *prv = (CPC464VMCallback *) 0;
       CPC464VMCallback   *p = firstCallback;
@@ -989,6 +1043,30 @@ namespace CPC464 {
     }
   }
 
+  void CPC464VM::runCallbacks()
+  {
+    // make the delays relative to the current cycle
+    CPC464VMCallback   *p = firstCallback;
+    while (p) {
+      p->delay -= callbackCycles;
+      p = p->nxt;
+    }
+    callbackCycles = 0U;
+    callbackCyclesRemaining = 0U;
+    p = firstCallback;
+    while (p) {
+      CPC464VMCallback *nxt = p->nxt;
+      if (!p->delay)
+        p->delay = p->func(p->userData);
+      p = nxt;
+    }
+    uint32_t  n = 0x40000000U;
+    for (p = firstCallback; p; p = p->nxt)
+      n = (p->delay < n ? p->delay : n);
+    callbackCycles = n;
+    callbackCyclesRemaining = n;
+  }
+
   // --------------------------------------------------------------------------
 
   CPC464VM::CPC464VM(Ep128Emu::VideoDisplay& display_,
@@ -1032,6 +1110,8 @@ namespace CPC464 {
       floppyCycleCnt(1),
       breakPointPriorityThreshold(0),
       firstCallback((CPC464VMCallback *) 0),
+      callbackCycles(1U),
+      callbackCyclesRemaining(1U),
       videoCapture((Ep128Emu::VideoCapture *) 0),
       tapeSamplesPerCRTCCycle(0L),
       tapeSamplesRemaining(-1L),
@@ -1040,9 +1120,10 @@ namespace CPC464 {
     for (size_t i = 0;
          i < (sizeof(callbacks) / sizeof(CPC464VMCallback));
          i++) {
-      callbacks[i].func = (void (*)(void *)) 0;
+      callbacks[i].func = (uint32_t (*)(void *)) 0;
       callbacks[i].userData = (void *) 0;
       callbacks[i].nxt = (CPC464VMCallback *) 0;
+      callbacks[i].delay = 0U;
     }
     floppyDrive = new FDC765_CPC();
     // register I/O callbacks
@@ -1112,7 +1193,10 @@ namespace CPC464 {
         uint32_t(uint64_t(crtcCyclesRemaining) & 0xFFFFFFFFUL);
     crtcCyclesRemainingH = int32_t(crtcCyclesRemaining >> 32);
     while (EP128EMU_EXPECT(crtcCyclesRemainingH > 0)) {
-      z80.executeInstruction();
+      // while the CPU is waiting for an interrupt in HALT, only the timing
+      // of the repeated opcode fetches needs to be emulated
+      if (EP128EMU_EXPECT(!z80.isExecutingHalt()) || !runHaltCycle())
+        z80.executeInstruction();
       while (EP128EMU_UNLIKELY(z80OpcodeHalfCycles >= 8))
         runOneCycle();
     }
@@ -1480,6 +1564,18 @@ namespace CPC464 {
     return nullptr;
   }
 
+  void CPC464VM::getMemoryUsage(MemoryUsage& memoryUsage_) const
+  {
+    memory.getMemoryUsage(memoryUsage_.ramSize, memoryUsage_.romSize,
+                          memoryUsage_.sharedROMSize, memoryUsage_.tableSize);
+    memoryUsage_.machineSize = sizeof(CPC464VM);
+  }
+
+  uint64_t CPC464VM::getInstructionCount() const
+  {
+    return z80.getInstructionCount();
+  }
+
   uint8_t CPC464VM::readMemory(uint32_t addr, bool isCPUAddress) const
   {
     if (isCPUAddress)
@@ -58,6 +58,9 @@ namespace CPC464 {
                                            (bool *) 0);
       virtual EP128EMU_REGPARM2 uint8_t readOpcodeByte(int offset);
       virtual EP128EMU_REGPARM2 uint16_t readOpcodeWord(int offset);
+#ifdef Z80_DECODE_CACHE
+      virtual EP128EMU_REGPARM1 uint32_t readOpcodeFirstByteDecoded();
+#endif
       virtual EP128EMU_REGPARM3 void writeMemory(uint16_t addr, uint8_t value);
       virtual EP128EMU_REGPARM3 void writeMemoryWord(uint16_t addr,
                                                      uint16_t value);
@@ -156,12 +159,15 @@ namespace CPC464 {
     uint8_t   floppyCycleCnt;           // divides 125 kHz sound clock by 4
     uint8_t   breakPointPriorityThreshold;
     struct CPC464VMCallback {
-      void      (*func)(void *);
+      uint32_t  (*func)(void *);
       void      *userData;
       CPC464VMCallback  *nxt;
+      uint32_t  delay;
     };
     CPC464VMCallback  callbacks[16];
     CPC464VMCallback  *firstCallback;
+    uint32_t  callbackCycles;           // length of the current wait
+    uint32_t  callbackCyclesRemaining;  // until the next callback is due
     Ep128Emu::VideoCapture  *videoCapture;
     int64_t   tapeSamplesPerCRTCCycle;
     int64_t   tapeSamplesRemaining;
@@ -174,6 +180,9 @@ namespace CPC464 {
     EP128EMU_INLINE void memoryWait();
     EP128EMU_INLINE void memoryWaitM1();
     EP128EMU_INLINE void ioPortWait();
+    // runs one cycle of a CPU executing HALT without decoding the opcode,
+    // returns false if the instruction needs to be executed normally
+    EP128EMU_INLINE bool runHaltCycle();
     EP128EMU_REGPARM1 void runOneCycle();
     static uint8_t ioPortReadCallback(void *userData, uint16_t addr);
     static void ioPortWriteCallback(void *userData,
@@ -183,20 +192,24 @@ namespace CPC464 {
                                                            bool newState);
     static EP128EMU_REGPARM2 void vSyncStateChangeCallback(void *userData,
                                                            bool newState);
-    static void tapeCallback(void *userData);
-    static void demoPlayCallback(void *userData);
-    static void demoRecordCallback(void *userData);
-    static void videoCaptureCallback(void *userData);
+    static uint32_t tapeCallback(void *userData);
+    static uint32_t demoPlayCallback(void *userData);
+    static uint32_t demoRecordCallback(void *userData);
+    static uint32_t videoCaptureCallback(void *userData);
     void stopDemoPlayback();
     void stopDemoRecording(bool writeFile_);
     EP128EMU_REGPARM1 void updatePPIState();
     uint8_t checkSingleStepModeBreak();
     void convertKeyboardState();
     void resetKeyboard();
-    // Set function to be called at every CRTC cycle. The functions are called
-    // in the order of being registered; up to 16 callbacks can be set.
-    void setCallback(void (*func)(void *userData), void *userData_,
+    // Set function to be called at the next CRTC cycle. The function returns
+    // the number of cycles (>= 1) until it is to be called again. Functions
+    // that are due in the same cycle are called in the order of being
+    // registered; up to 16 callbacks can be set.
+    void setCallback(uint32_t (*func)(void *userData), void *userData_,
                      bool isEnabled);
+    // Call the functions that are due, and schedule the next call.
+    void runCallbacks();
    public:
     CPC464VM(Ep128Emu::VideoDisplay&, Ep128Emu::AudioOutput&);
     virtual ~CPC464VM();
@@ -337,6 +350,11 @@ namespace CPC464 {
      * Returns a memory pointer to page 'n' (0x00 to 0xFF).
      */
     virtual void * getSegmentPtr(int n) const;
+    /*!
+     * Returns the number of bytes allocated by the emulated machine.
+     */
+    virtual void getMemoryUsage(MemoryUsage& memoryUsage_) const;
+    virtual uint64_t getInstructionCount() const;
     /*!
      * Read a byte from memory. If 'isCPUAddress' is false, bits 14 to 21 of
      * 'addr' define the segment number, while bits 0 to 13 are the offset
@@ -471,6 +489,16 @@ namespace CPC464 {
      * playing a demo.
      */
     virtual bool getIsPlayingDemo() const;
+    /*!
+     * Returns true if the state can be saved with forkState(); this is false
+     * while tape, disk or file I/O, demo recording or playback, or video
+     * capture is in progress.
+     */
+    virtual bool getIsStateForkAllowed() const;
+    /*!
+     * Save or restore the state of the emulated machine for run-ahead.
+     */
+    virtual void forkState(Ep128Emu::StateFork& f);
     // ----------------
     virtual void loadState(Ep128Emu::File::Buffer&);
     virtual void loadMachineConfiguration(Ep128Emu::File::Buffer&);
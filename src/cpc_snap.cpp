@@ -103,6 +103,32 @@ namespace CPC464 {
     return isPlayingDemo;
   }
 
+  bool CPC464VM::getIsStateForkAllowed() const
+  {
+    if (isRecordingDemo || isPlayingDemo || demoFile || videoCapture)
+      return false;
+    if (haveTape() && getTapeButtonState() != 0)
+      return false;
+    return (floppyDrive->getLEDState(1) == 0U);
+  }
+
+  void CPC464VM::forkState(Ep128Emu::StateFork& f)
+  {
+    Ep128Emu::VirtualMachine::forkState(f);
+    z80.forkState(f);
+    memory.forkState(f);
+    ay3.forkState(f);
+    crtc.forkState(f);
+    videoRenderer.forkState(f);
+    floppyDrive->forkState(f);
+    EP128EMU_FORK_RANGE(f, CPC464VM, crtcCyclesRemainingL, soundOutputSignal);
+    f.copy(snapshotLoadFlag);
+    f.copy(floppyCycleCnt);
+    EP128EMU_FORK_RANGE(f, CPC464VM, callbacks, callbackCyclesRemaining);
+    f.copy(tapeSamplesRemaining);
+    EP128EMU_FORK_RANGE(f, CPC464VM, keyboardState, cpcKeyboardState);
+  }
+
   // --------------------------------------------------------------------------
 
   void CPC464VM::loadState(Ep128Emu::File::Buffer& buf)
@@ -22,54 +22,38 @@
 
 #include "ep128emu.hpp"
 #include "bplist.hpp"
+#include "membase.hpp"
 
 namespace CPC464 {
 
-  class Memory {
+  class Memory : public Ep128Emu::MemoryBase {
    private:
-    uint8_t   **segmentTable;
-    bool      *segmentROMTable;
     uint8_t   pageTableR[4];
     uint8_t   pageTableW[4];
     uint16_t  currentPaging;            // configuration set with setPaging()
     uint8_t   expansionRAMBlocks;       // 0, 1, 2, 4, or 8
-    uint8_t   *breakPointTable;
-    size_t    breakPointCnt;
-    uint8_t   **segmentBreakPointTable;
-    size_t    *segmentBreakPointCntTable;
-    bool      haveBreakPoints;
-    uint8_t   breakPointPriorityThreshold;
     uint8_t   *videoMemory; // 64K for segments 0 to 3; always RAM
-    uint8_t   *dummyMemory; // 2*16K dummy memory for invalid reads and writes
     uint8_t   *pageAddressTableR[4];
     uint8_t   *pageAddressTableW[4];
     void allocateSegment(uint8_t n, bool isROM);
-    void checkExecuteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
+   protected:
+    virtual void updatePaging();
    public:
     Memory();
     virtual ~Memory();
-    void setBreakPoint(uint8_t segment, uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void setBreakPoint(uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void clearBreakPoints(uint8_t segment);
-    void clearBreakPoints();
-    void clearAllBreakPoints();
-    void setBreakPointPriorityThreshold(int n);
-    int getBreakPointPriorityThreshold();
     void setRAMSize(size_t n);  // in kilobytes; 64, 128, 192, 320, or 576
     void loadROMSegment(uint8_t segment, const uint8_t *data, size_t dataSize);
     void deleteSegment(uint8_t segment);
     void deleteAllSegments();
     inline uint8_t read(uint16_t addr);
     inline uint8_t readOpcode(uint16_t addr);
+#ifdef Z80_DECODE_CACHE
+    // returns the predecoded instruction at 'addr', or zero if it cannot
+    // be cached
+    inline uint32_t readOpcodeDecoded(uint16_t addr);
+#endif
     inline uint8_t readNoDebug(uint16_t addr) const;
-    inline uint8_t readRaw(uint32_t addr) const;
     inline void write(uint16_t addr, uint8_t value);
-    inline void writeRaw(uint32_t addr, uint8_t value);
-    inline void writeROM(uint32_t addr, uint8_t value);
     // set memory paging:
     //   bits 0 to 5:  RAM expansion configuration
     //   bit 6:        internal ROM (0000h-3FFFh) enable
@@ -79,17 +63,12 @@ namespace CPC464 {
     inline uint16_t getPaging() const;
     inline uint8_t getPage(uint8_t page) const;
     inline const uint8_t * getVideoMemory() const;
-    inline bool isSegmentROM(uint8_t segment) const;
-    inline bool isSegmentRAM(uint8_t segment) const;
-    inline void * getSegmentPtr(uint8_t segment) const;
-    bool checkIgnoreBreakPoint(uint16_t addr) const;
-    Ep128Emu::BreakPointList getBreakPointList();
+    inline bool checkIgnoreBreakPoint(uint16_t addr) const;
     void saveState(Ep128Emu::File::Buffer&);
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
-   protected:
-    virtual void breakPointCallback(bool isWrite, uint16_t addr, uint8_t value);
+    void forkState(Ep128Emu::StateFork&);
   };
 
   // --------------------------------------------------------------------------
@@ -99,7 +78,7 @@ namespace CPC464 {
     uint8_t page = uint8_t(addr >> 14);
     uint8_t value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkReadBreakPoint(addr, page, value);
+      checkReadBreakPoint(addr, pageTableR[page], value);
     return value;
   }
 
@@ -108,47 +87,29 @@ namespace CPC464 {
     uint8_t page = uint8_t(addr >> 14);
     uint8_t value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkExecuteBreakPoint(addr, page, value);
+      checkExecuteBreakPoint(addr, pageTableR[page], value);
     return value;
   }
 
-  inline uint8_t Memory::readNoDebug(uint16_t addr) const
+#ifdef Z80_DECODE_CACHE
+  inline uint32_t Memory::readOpcodeDecoded(uint16_t addr)
   {
-    return pageAddressTableR[uint8_t(addr >> 14)][addr];
+    return readDecodeCache(pageTableR[addr >> 14], uint16_t(addr & 0x3FFF));
   }
 
-  inline uint8_t Memory::readRaw(uint32_t addr) const
+#endif
+  inline uint8_t Memory::readNoDebug(uint16_t addr) const
   {
-    uint8_t segment, value;
-
-    segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      value = segmentTable[segment][addr & 0x3FFF];
-    else
-      value = 0xFF;
-    return value;
+    return pageAddressTableR[uint8_t(addr >> 14)][addr];
   }
 
   inline void Memory::write(uint16_t addr, uint8_t value)
   {
     uint8_t page = uint8_t(addr >> 14);
     if (haveBreakPoints)
-      checkWriteBreakPoint(addr, page, value);
+      checkWriteBreakPoint(addr, pageTableW[page], value);
     pageAddressTableW[page][addr] = value;
-  }
-
-  inline void Memory::writeRaw(uint32_t addr, uint8_t value)
-  {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (!segmentROMTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
-  }
-
-  inline void Memory::writeROM(uint32_t addr, uint8_t value)
-  {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
+    segmentWritten(pageTableW[page], addr);
   }
 
   inline uint16_t Memory::getPaging() const
@@ -161,26 +122,14 @@ namespace CPC464 {
     return pageTableR[page & 3];
   }
 
-  inline const uint8_t * Memory::getVideoMemory() const
-  {
-    return videoMemory;
-  }
-
-  inline bool Memory::isSegmentROM(uint8_t segment) const
-  {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            segmentROMTable[segment]);
-  }
-
-  inline bool Memory::isSegmentRAM(uint8_t segment) const
+  inline bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
   {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            !segmentROMTable[segment]);
+    return MemoryBase::checkIgnoreBreakPoint(addr, pageTableR[addr >> 14]);
   }
 
-  inline void * Memory::getSegmentPtr(uint8_t segment) const
+  inline const uint8_t * Memory::getVideoMemory() const
   {
-    return (segmentTable[segment]);
+    return videoMemory;
   }
 
 }       // namespace CPC464
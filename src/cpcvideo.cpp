@@ -88,10 +88,14 @@ namespace CPC464 {
       borderColor(0x00),
       videoMode(0),
       hSyncMax(107),
-      hSyncLen(4)
+      charCnt(0),
+      hSyncLen(4),
+      pixelTableMode(0xFF)
   {
     videoDelayBuf[0] = 0U;
     videoDelayBuf[1] = 0U;
+    for (size_t i = 0; i < 64; i++)
+      charBuf[i] = 0U;
     for (size_t i = 0; i < 16; i++)
       palette[i] = 0x00;
     lineBuf = reinterpret_cast<uint8_t *>(new uint32_t[112]);
@@ -115,10 +119,20 @@ namespace CPC464 {
 
   void CPCVideo::setColor(uint8_t penNum, uint8_t c)
   {
-    if (penNum & 0x10)
-      borderColor = c & 0x3F;
-    else
-      palette[penNum & 0x0F] = c & 0x3F;
+    c = c & 0x3F;
+    if (penNum & 0x10) {
+      if (c != borderColor) {
+        if (charCnt)
+          renderCharacters();
+        borderColor = c;
+      }
+    }
+    else if (c != palette[penNum & 0x0F]) {
+      if (charCnt)
+        renderCharacters();
+      palette[penNum & 0x0F] = c;
+      pixelTableMode = 0xFF;
+    }
   }
 
   uint8_t CPCVideo::getColor(uint8_t penNum) const
@@ -128,77 +142,103 @@ namespace CPC464 {
     return palette[penNum & 0x0F];
   }
 
-  EP128EMU_REGPARM1 void CPCVideo::runOneCycle()
+  void CPCVideo::updatePixelTable()
   {
-    if (EP128EMU_EXPECT((unsigned int) hSyncCnt < 97U)) {
-      if (EP128EMU_UNLIKELY((reinterpret_cast<unsigned char *>(
-                                 &(videoDelayBuf[0])))[0] != 0)) {
-        lineBufPtr[0] = 0x01;           // sync
-        lineBufPtr[1] = 0x14;
-        lineBufPtr = lineBufPtr + 2;
+    pixelTableMode = videoModeLatched;
+    for (int i = 0; i < 256; i++) {
+      uint8_t *p = &(pixelTable[i][0]);
+      switch (pixelTableMode) {         // mode 2 does not use the table
+      case 0:                           // 16 color mode
+        p[0] = palette[pixelConvTable_16[i & 0xAA]];
+        p[1] = palette[pixelConvTable_16[i & 0x55]];
+        p[2] = 0x00;
+        p[3] = 0x00;
+        break;
+      case 1:                           // 4 color mode
+        p[0] = palette[pixelConvTable_4[i & 0x88]];
+        p[1] = palette[pixelConvTable_4[i & 0x44]];
+        p[2] = palette[pixelConvTable_4[i & 0x22]];
+        p[3] = palette[pixelConvTable_4[i & 0x11]];
+        break;
+      case 3:                           // 4 color mode (half resolution)
+        p[0] = palette[pixelConvTable_16[i & 0xAA] & 3];
+        p[1] = palette[pixelConvTable_16[i & 0x55] & 3];
+        p[2] = 0x00;
+        p[3] = 0x00;
+        break;
       }
-      else if ((reinterpret_cast<unsigned char *>(&(videoDelayBuf[0])))[1]) {
-        uint8_t videoByte0 =
-            (reinterpret_cast<unsigned char *>(&(videoDelayBuf[0])))[2];
-        uint8_t videoByte1 =
-            (reinterpret_cast<unsigned char *>(&(videoDelayBuf[0])))[3];
+    }
+  }
+
+  EP128EMU_REGPARM1 void CPCVideo::renderCharacters()
+  {
+    if (videoModeLatched != pixelTableMode && videoModeLatched != 2)
+      updatePixelTable();
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&(charBuf[0]));
+    const uint8_t *endPtr = p + (size_t(charCnt) << 2);
+    uint8_t *bufp = lineBufPtr;
+    charCnt = 0;
+    for ( ; p < endPtr; p = p + 4) {
+      if (EP128EMU_UNLIKELY(p[0] != 0)) {
+        bufp[0] = 0x01;                 // sync
+        bufp[1] = 0x14;
+        bufp = bufp + 2;
+      }
+      else if (p[1]) {
+        const uint8_t *c0 = &(pixelTable[p[2]][0]);
+        const uint8_t *c1 = &(pixelTable[p[3]][0]);
         switch (videoModeLatched) {
-        case 0:                         // 16 color mode
-          {
-            lineBufPtr[0] = 0x04;
-            lineBufPtr[1] = palette[pixelConvTable_16[videoByte0 & 0xAA]];
-            lineBufPtr[2] = palette[pixelConvTable_16[videoByte0 & 0x55]];
-            lineBufPtr[3] = palette[pixelConvTable_16[videoByte1 & 0xAA]];
-            lineBufPtr[4] = palette[pixelConvTable_16[videoByte1 & 0x55]];
-            lineBufPtr = lineBufPtr + 5;
-          }
-          break;
         case 1:                         // 4 color mode
-          {
-            lineBufPtr[0] = 0x08;
-            lineBufPtr[1] = palette[pixelConvTable_4[videoByte0 & 0x88]];
-            lineBufPtr[2] = palette[pixelConvTable_4[videoByte0 & 0x44]];
-            lineBufPtr[3] = palette[pixelConvTable_4[videoByte0 & 0x22]];
-            lineBufPtr[4] = palette[pixelConvTable_4[videoByte0 & 0x11]];
-            lineBufPtr[5] = palette[pixelConvTable_4[videoByte1 & 0x88]];
-            lineBufPtr[6] = palette[pixelConvTable_4[videoByte1 & 0x44]];
-            lineBufPtr[7] = palette[pixelConvTable_4[videoByte1 & 0x22]];
-            lineBufPtr[8] = palette[pixelConvTable_4[videoByte1 & 0x11]];
-            lineBufPtr = lineBufPtr + 9;
-          }
+          bufp[0] = 0x08;
+          bufp[1] = c0[0];
+          bufp[2] = c0[1];
+          bufp[3] = c0[2];
+          bufp[4] = c0[3];
+          bufp[5] = c1[0];
+          bufp[6] = c1[1];
+          bufp[7] = c1[2];
+          bufp[8] = c1[3];
+          bufp = bufp + 9;
           break;
         case 2:                         // 2 color mode
-          lineBufPtr[0] = 0x06;
-          lineBufPtr[1] = palette[0];
-          lineBufPtr[2] = palette[1];
-          lineBufPtr[3] = videoByte0;
-          lineBufPtr[4] = palette[0];
-          lineBufPtr[5] = palette[1];
-          lineBufPtr[6] = videoByte1;
-          lineBufPtr = lineBufPtr + 7;
+          bufp[0] = 0x06;
+          bufp[1] = palette[0];
+          bufp[2] = palette[1];
+          bufp[3] = p[2];
+          bufp[4] = palette[0];
+          bufp[5] = palette[1];
+          bufp[6] = p[3];
+          bufp = bufp + 7;
           break;
-        case 3:                         // 4 color mode (half resolution)
-          {
-            lineBufPtr[0] = 0x04;
-            lineBufPtr[1] = palette[pixelConvTable_16[videoByte0 & 0xAA] & 3];
-            lineBufPtr[2] = palette[pixelConvTable_16[videoByte0 & 0x55] & 3];
-            lineBufPtr[3] = palette[pixelConvTable_16[videoByte1 & 0xAA] & 3];
-            lineBufPtr[4] = palette[pixelConvTable_16[videoByte1 & 0x55] & 3];
-            lineBufPtr = lineBufPtr + 5;
-          }
+        default:                        // 16 color or half resolution mode
+          bufp[0] = 0x04;
+          bufp[1] = c0[0];
+          bufp[2] = c0[1];
+          bufp[3] = c1[0];
+          bufp[4] = c1[1];
+          bufp = bufp + 5;
           break;
         }
       }
       else {
-        lineBufPtr[0] = 0x01;           // border
-        lineBufPtr[1] = borderColor;
-        lineBufPtr = lineBufPtr + 2;
+        bufp[0] = 0x01;                 // border
+        bufp[1] = borderColor;
+        bufp = bufp + 2;
       }
     }
+    lineBufPtr = bufp;
+  }
+
+  EP128EMU_REGPARM1 void CPCVideo::runOneCycle()
+  {
+    if (EP128EMU_EXPECT((unsigned int) hSyncCnt < 97U))
+      charBuf[charCnt++] = videoDelayBuf[0];
     hSyncCnt += 2;
     if (EP128EMU_UNLIKELY(crtcHSyncCnt)) {      // horizontal sync
       if (crtcHSyncCnt == 3) {
         if (hSyncCnt >= (int(hSyncMax) - 8)) {
+          if (charCnt)
+            renderCharacters();
           if (EP128EMU_EXPECT(hSyncCnt & 1))
             drawLine(lineBuf, size_t(lineBufPtr - lineBuf));
           else
@@ -209,6 +249,8 @@ namespace CPC464 {
         }
       }
       else if (crtcHSyncCnt == 7) {
+        if (videoMode != videoModeLatched && charCnt)
+          renderCharacters();
         videoModeLatched = videoMode;
         hSyncLen = 4;
         if (vSyncCnt) {
@@ -223,6 +265,8 @@ namespace CPC464 {
     }
     if ((unsigned int) (hSyncCnt + 4) >= 101U) {
       if (EP128EMU_UNLIKELY(hSyncCnt >= int(hSyncMax))) {
+        if (charCnt)
+          renderCharacters();
         if (EP128EMU_EXPECT(hSyncCnt & 1))
           drawLine(lineBuf, size_t(lineBufPtr - lineBuf));
         else
@@ -490,6 +534,8 @@ namespace CPC464 {
 
   void CPCVideo::reset()
   {
+    if (charCnt)
+      renderCharacters();
     videoModeLatched = 0;
     videoDelayBuf[0] = 0U;
     videoDelayBuf[1] = 0U;
@@ -497,6 +543,16 @@ namespace CPC464 {
       palette[i] = 0x00;
     borderColor = 0x00;
     videoMode = 0;
+    pixelTableMode = 0xFF;
+  }
+
+  void CPCVideo::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, CPCVideo, lineBufPtr, hSyncLen);
+    f.copyData(lineBuf, 112 * sizeof(uint32_t));
+    f.copyData(&(charBuf[0]), size_t(charCnt) * sizeof(uint32_t));
+    if (f.isRestoring())
+      pixelTableMode = 0xFF;
   }
 
 }       // namespace CPC464
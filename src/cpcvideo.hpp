@@ -43,7 +43,14 @@ namespace CPC464 {
     uint8_t   borderColor;
     uint8_t   videoMode;
     uint8_t   hSyncMax;
+    uint8_t   charCnt;          // number of characters in charBuf
     uint8_t   hSyncLen;
+    // characters not rendered yet, in the format of videoDelayBuf[0]
+    uint32_t  charBuf[64];
+    // pixel colors of a video byte in the current palette, for mode
+    // pixelTableMode (0xFF if the table needs to be updated)
+    uint8_t   pixelTableMode;
+    uint8_t   pixelTable[256][4];
     // --------
     /*!
      * drawLine() is called after rendering each line.
@@ -90,6 +97,11 @@ namespace CPC464 {
     EP128EMU_REGPARM1 void runOneCycle();
    private:
     EP128EMU_REGPARM1 void shiftLineBuffer();
+    void updatePixelTable();
+    // Renders the characters stored in charBuf to the line buffer. This is
+    // done at the end of the line, and before changing any of the colors
+    // or the latched video mode.
+    EP128EMU_REGPARM1 void renderCharacters();
    public:
     EP128EMU_INLINE void crtcHSyncStateChange(bool newState)
     {
@@ -97,6 +109,8 @@ namespace CPC464 {
         if (EP128EMU_UNLIKELY(crtcHSyncCnt)) {
           if (crtcHSyncCnt >= 4)
             hSyncLen = crtcHSyncCnt - 3;
+          if (videoMode != videoModeLatched && charCnt)
+            renderCharacters();
           videoModeLatched = videoMode;
           if (vSyncCnt) {
             if (--vSyncCnt == 21)       // VSync start (delayed by 5 lines)
@@ -115,6 +129,7 @@ namespace CPC464 {
         vSyncCnt = 26;
     }
     void reset();
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace CPC464
@@ -437,5 +437,10 @@ namespace CPC464 {
     }
   }
 
+  void CRTC6845::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, CRTC6845, registers, cursorEnableMask);
+  }
+
 }       // namespace CPC464
 
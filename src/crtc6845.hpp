@@ -190,6 +190,7 @@ namespace CPC464 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace CPC464
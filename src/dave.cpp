@@ -1193,6 +1193,12 @@ namespace Ep128 {
     }
   }
 
+  void Dave::forkState(Ep128Emu::StateFork& f)
+  {
+    // all pointers in the state refer to static tables or to members
+    EP128EMU_FORK_RANGE(f, Dave, clockDiv, mouseInput);
+  }
+
   // --------------------------------------------------------------------------
 
   void Dave::setMemoryPage(uint8_t page, uint8_t segment)
@@ -261,6 +261,10 @@ namespace Ep128 {
      */
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    /*!
+     * Save or restore state for run-ahead (see statefork.hpp).
+     */
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace Ep128
@@ -58,8 +58,13 @@ namespace Ep128Emu {
 
   // --------------------------------------------------------------------------
 
+  // If 'fastCompression' is true, fewer optimization passes are used,
+  // trading a lower compression ratio for speed (e.g. for snapshots that
+  // are saved frequently). The output can be read by decompressData() in
+  // both modes.
   extern void compressData(std::vector< unsigned char >& outBuf,
-                           const unsigned char *inBuf, size_t inBufSize);
+                           const unsigned char *inBuf, size_t inBufSize,
+                           bool fastCompression = false);
 
 }       // namespace Ep128Emu
 
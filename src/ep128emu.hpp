@@ -115,6 +115,7 @@ namespace Ep128Emu {
 #endif
 
 #include "fileio.hpp"
+#include "statefork.hpp"
 
 #endif  // EP128EMU_EP128EMU_HPP
 
@@ -78,6 +78,41 @@ namespace Ep128 {
                            & (int64_t(-1) << 31));
   }
 
+  EP128EMU_INLINE void Ep128VM::memoryWait(uint16_t addr)
+  {
+    int64_t   waitCycles = pageWaitCycles[addr >> 14];
+    if (EP128EMU_EXPECT(waitCycles != 0L))
+      cpuCyclesRemaining -= waitCycles;
+    else
+      videoMemoryWait();
+  }
+
+  EP128EMU_INLINE void Ep128VM::memoryWait_M1(uint16_t addr)
+  {
+    int64_t   waitCycles = pageWaitCycles_M1[addr >> 14];
+    if (EP128EMU_EXPECT(waitCycles != 0L))
+      cpuCyclesRemaining -= waitCycles;
+    else
+      videoMemoryWait_M1();
+  }
+
+  EP128EMU_INLINE bool Ep128VM::runHaltCycle()
+  {
+    // repeat the HALT opcode fetch with the same timing as
+    // Z80_::readOpcodeFirstByte(), but without reading and decoding the
+    // opcode, unless breakpoints or single step mode need the read
+    if (singleStepMode || memory.getHaveBreakPoints())
+      return false;
+    uint16_t  addr = uint16_t(z80.getReg().PC.W.l);
+#ifdef ENABLE_SDEXT
+    if (EP128EMU_UNLIKELY(sdext.isSDExtSegment(pageTable[addr >> 14])))
+      return false;
+#endif
+    memoryWait_M1(addr);
+    z80.executeHaltCycle();
+    return true;
+  }
+
   Ep128VM::Z80_::Z80_(Ep128VM& vm_)
     : Z80(),
       vm(vm_),
@@ -104,33 +139,14 @@ namespace Ep128 {
 
   EP128EMU_REGPARM2 uint8_t Ep128VM::Z80_::readMemory(uint16_t addr)
   {
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(3) << 32);
-    }
+    vm.memoryWait(addr);
     return vm.memory.read(addr);
   }
 
   EP128EMU_REGPARM2 uint16_t Ep128VM::Z80_::readMemoryWord(uint16_t addr)
   {
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-      if (vm.pageTable[((addr + 1) & 0xFFFF) >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(6) << 32);
-    }
+    vm.memoryWait(addr);
+    vm.memoryWait((addr + 1) & 0xFFFF);
     uint16_t  retval = vm.memory.read(addr);
     retval |= (uint16_t(vm.memory.read((addr + 1) & 0xFFFF) << 8));
     return retval;
@@ -139,15 +155,7 @@ namespace Ep128 {
   EP128EMU_REGPARM1 uint8_t Ep128VM::Z80_::readOpcodeFirstByte()
   {
     uint16_t  addr = uint16_t(R.PC.W.l);
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles_M1;
-      else
-        vm.videoMemoryWait_M1();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(4) << 32);
-    }
+    vm.memoryWait_M1(addr);
     if (!vm.singleStepMode)
       return vm.memory.readOpcode(addr);
     // single step mode
@@ -163,66 +171,58 @@ namespace Ep128 {
       if (EP128EMU_UNLIKELY(invalidOpcodeTable[b]))
         return b;
     }
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles_M1;
-      else
-        vm.videoMemoryWait_M1();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(4) << 32);
-    }
+    vm.memoryWait_M1(addr);
     return vm.memory.readOpcode(addr);
   }
 
   EP128EMU_REGPARM2 uint8_t Ep128VM::Z80_::readOpcodeByte(int offset)
   {
     uint16_t  addr = uint16_t((int(R.PC.W.l) + offset) & 0xFFFF);
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(3) << 32);
-    }
+    vm.memoryWait(addr);
     return vm.memory.readOpcode(addr);
   }
 
   EP128EMU_REGPARM2 uint16_t Ep128VM::Z80_::readOpcodeWord(int offset)
   {
     uint16_t  addr = uint16_t((int(R.PC.W.l) + offset) & 0xFFFF);
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-      if (vm.pageTable[((addr + 1) & 0xFFFF) >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(6) << 32);
-    }
+    vm.memoryWait(addr);
+    vm.memoryWait((addr + 1) & 0xFFFF);
     uint16_t  retval = vm.memory.readOpcode(addr);
     retval |= (uint16_t(vm.memory.readOpcode((addr + 1) & 0xFFFF) << 8));
     return retval;
   }
 
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_REGPARM1 uint32_t Ep128VM::Z80_::readOpcodeFirstByteDecoded()
+  {
+    // readOpcodeFirstByte(), followed by the memory timing of the operand
+    // reads that the predecoded instruction already includes
+    uint16_t  addr = uint16_t(R.PC.W.l);
+    uint32_t  retval = 0U;
+    if (EP128EMU_EXPECT(!(vm.singleStepMode ||
+                          vm.memory.getHaveBreakPoints()))) {
+      retval = vm.memory.readOpcodeDecoded(addr);
+    }
+    if (EP128EMU_UNLIKELY(!retval))
+      return (Z80_PREDECODED_VALID | uint32_t(Z80_::readOpcodeFirstByte()));
+    vm.memoryWait_M1(addr);
+    switch ((retval >> 24) & 3U) {
+    case 1U:
+      vm.memoryWait((addr + 1) & 0xFFFF);
+      break;
+    case 2U:
+      vm.memoryWait((addr + 1) & 0xFFFF);
+      vm.memoryWait((addr + 2) & 0xFFFF);
+      break;
+    }
+    return retval;
+  }
+#endif
+
   EP128EMU_REGPARM3 void Ep128VM::Z80_::writeMemory(uint16_t addr,
                                                     uint8_t value)
   {
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(3) << 32);
-    }
+    vm.memoryWait(addr);
     vm.memory.write(addr, value);
     if (vm.spectrumEmulatorEnabled) {
       uint32_t  tmp = uint32_t(addr) & 0x3FFFU;
@@ -240,19 +240,8 @@ namespace Ep128 {
       writeMemory((addr + 1) & 0xFFFF, uint8_t(value >> 8));
       return;
     }
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-      if (vm.pageTable[((addr + 1) & 0xFFFF) >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(6) << 32);
-    }
+    vm.memoryWait(addr);
+    vm.memoryWait((addr + 1) & 0xFFFF);
     vm.memory.write(addr, uint8_t(value) & 0xFF);
     vm.memory.write((addr + 1) & 0xFFFF, uint8_t(value >> 8));
   }
@@ -267,19 +256,8 @@ namespace Ep128 {
       writeMemory(addr, uint8_t(value) & 0xFF);
       return;
     }
-    if (vm.memoryTimingEnabled) {
-      if (vm.pageTable[((addr + 1) & 0xFFFF) >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-      if (vm.pageTable[addr >> 14] < 0xFC)
-        vm.cpuCyclesRemaining -= vm.memoryWaitCycles;
-      else
-        vm.videoMemoryWait();
-    }
-    else {
-      vm.cpuCyclesRemaining -= (int64_t(6) << 32);
-    }
+    vm.memoryWait((addr + 1) & 0xFFFF);
+    vm.memoryWait(addr);
     vm.memory.write((addr + 1) & 0xFFFF, uint8_t(value >> 8));
     vm.memory.write(addr, uint8_t(value) & 0xFF);
   }
@@ -609,6 +587,7 @@ namespace Ep128 {
   {
     vm.pageTable[page] = segment;
     vm.memory.setPage(page, segment);
+    vm.updatePageWaitCycles(page);
   }
 
   void Ep128VM::Dave_::setMemoryWaitMode(int mode)
@@ -786,6 +765,25 @@ namespace Ep128 {
       memoryWaitCycles = int64_t(3) << 32;
       break;
     }
+    for (uint8_t i = 0; i < 4; i++)
+      updatePageWaitCycles(i);
+  }
+
+  void Ep128VM::updatePageWaitCycles(uint8_t page)
+  {
+    if (!memoryTimingEnabled) {
+      pageWaitCycles_M1[page] = int64_t(4) << 32;
+      pageWaitCycles[page] = int64_t(3) << 32;
+    }
+    else if (pageTable[page] < 0xFC) {
+      pageWaitCycles_M1[page] = memoryWaitCycles_M1;
+      pageWaitCycles[page] = memoryWaitCycles;
+    }
+    else {
+      // video memory, the wait depends on the NICK slot
+      pageWaitCycles_M1[page] = 0L;
+      pageWaitCycles[page] = 0L;
+    }
   }
 
   EP128EMU_REGPARM1 void Ep128VM::runDevices()
@@ -793,12 +791,8 @@ namespace Ep128 {
     do {
       nick.runOneSlot();
       nickCyclesRemainingH--;
-      Ep128VMCallback   *p = firstCallback;
-      while (p) {
-        Ep128VMCallback *nxt = p->nxt;
-        p->func(p->userData);
-        p = nxt;
-      }
+      if (EP128EMU_UNLIKELY(!(--callbackCyclesRemaining)))
+        runCallbacks();
       daveCyclesRemaining += daveCyclesPerNickCycle;
       if (daveCyclesRemaining >= 0L) {
         do {
@@ -1159,7 +1153,6 @@ namespace Ep128 {
           vm.mouseButtonState = 0x00;
           vm.mouseWheelDelta = 0x00;
         }
-        vm.setCallback(&mouseTimerCallback, userData, true);
         uint8_t   dx = uint8_t(vm.mouseDeltaX) & 0xFF;
         uint8_t   dy = uint8_t(vm.mouseDeltaY) & 0xFF;
         uint32_t  mouseData_ =
@@ -1183,6 +1176,7 @@ namespace Ep128 {
       vm.dave.setMouseInput(daveInput);
       // 1500 us
       vm.mouseTimer = (uint32_t(vm.nickFrequency) * 1573U + 0x00080000U) >> 20;
+      vm.setCallback(&mouseTimerCallback, userData, true);
     }
     vm.prvB7PortState = value;
     vm.davePortWriteCallback(userData, addr, value);
@@ -1228,20 +1222,37 @@ namespace Ep128 {
 
 #endif
 
-  void Ep128VM::mouseTimerCallback(void *userData)
+  uint32_t Ep128VM::mouseTimerCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     if (EP128EMU_EXPECT(vm.mouseTimer > 1U)) {
-      vm.mouseTimer--;
-      return;
+      // wait until the timeout, mouseTimer is 1 until then
+      uint32_t  n = vm.mouseTimer - 1U;
+      vm.mouseTimer = 1U;
+      return n;
     }
     vm.mouseTimer = 0U;
     vm.mouseData = 0ULL;
     vm.setCallback(&mouseTimerCallback, userData, false);
     vm.dave.clearMouseInput();
+    return 1U;
   }
 
-  void Ep128VM::tapeCallback(void *userData)
+  uint32_t Ep128VM::getMouseTimer() const
+  {
+    if (!mouseTimer)
+      return 0U;
+    for (const Ep128VMCallback *p = firstCallback; p; p = p->nxt) {
+      if (p->func == &mouseTimerCallback) {
+        // add the remaining delay of the callback
+        return (mouseTimer - 1U
+                + (p->delay - (callbackCycles - callbackCyclesRemaining)));
+      }
+    }
+    return mouseTimer;
+  }
+
+  uint32_t Ep128VM::tapeCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     vm.tapeSamplesRemaining += vm.tapeSamplesPerNickCycle;
@@ -1251,9 +1262,20 @@ namespace Ep128 {
       int   daveTapeInput = vm.runTape(int(vm.soundOutputSignal & 0xFFFFU));
       vm.dave.setTapeInput(daveTapeInput, daveTapeInput);
     }
+    // number of cycles until the next sample
+    uint32_t  n = 0x40000000U;
+    if (vm.tapeSamplesRemaining > 0) {
+      n = 1U;
+    }
+    else if (vm.tapeSamplesPerNickCycle > 0) {
+      int64_t tmp = (-vm.tapeSamplesRemaining) / vm.tapeSamplesPerNickCycle + 1;
+      n = uint32_t(tmp < 0x40000000 ? tmp : 0x40000000);
+    }
+    vm.tapeSamplesRemaining += (int64_t(n - 1U) * vm.tapeSamplesPerNickCycle);
+    return n;
   }
 
-  void Ep128VM::demoPlayCallback(void *userData)
+  uint32_t Ep128VM::demoPlayCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     while (!vm.demoTimeCnt) {
@@ -1297,25 +1319,30 @@ namespace Ep128 {
         break;
       }
     }
-    if (vm.demoTimeCnt)
-      vm.demoTimeCnt--;
+    // wait until the next event
+    uint32_t  n = uint32_t(vm.demoTimeCnt < 0x40000000U ?
+                           vm.demoTimeCnt : 0x40000000U);
+    vm.demoTimeCnt -= n;
+    return (n > 0U ? n : 1U);
   }
 
-  void Ep128VM::demoRecordCallback(void *userData)
+  uint32_t Ep128VM::demoRecordCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     vm.demoTimeCnt++;
+    return 1U;
   }
 
-  void Ep128VM::videoCaptureCallback(void *userData)
+  uint32_t Ep128VM::videoCaptureCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     vm.videoCapture->runOneCycle(vm.soundOutputSignal + vm.externalDACOutput);
+    return 1U;
   }
 
 #ifdef ENABLE_RESID
 
-  void Ep128VM::sidCallback(void *userData)
+  uint32_t Ep128VM::sidCallback(void *userData)
   {
     Ep128VM&  vm = *(reinterpret_cast<Ep128VM *>(userData));
     int64_t   tmp = vm.daveCyclesRemaining + vm.daveCyclesPerNickCycle;
@@ -1337,6 +1364,7 @@ namespace Ep128 {
         vm.externalDACOutput = uint32_t((outL >> 15) | ((outR >> 15) << 16));
       } while (EP128EMU_UNLIKELY(tmp >= 0L));
     }
+    return 1U;
   }
 
 #endif
@@ -1480,8 +1508,8 @@ namespace Ep128 {
     }
   }
 
-  void Ep128VM::setCallback(void (*func)(void *userData), void *userData_,
-                            bool isEnabled)
+  void Ep128VM::setCallback(uint32_t (*func)(void *userData),
+                            void *userData_, bool isEnabled)
   {
     if (!func)
       return;
@@ -1508,7 +1536,7 @@ namespace Ep128 {
         p = p->nxt;
       }
       if (!isEnabled) {
-        callbacks[ndx].func = (void (*)(void *)) 0;
+        callbacks[ndx].func = (uint32_t (*)(void *)) 0;
         callbacks[ndx].userData = (void *) 0;
         callbacks[ndx].nxt = (Ep128VMCallback *) 0;
       }
@@ -1517,7 +1545,7 @@ namespace Ep128 {
       return;
     if (ndx < 0) {
       for (size_t i = 0; i < maxCallbacks; i++) {
-        if (callbacks[i].func == (void (*)(void *)) 0) {
+        if (callbacks[i].func == (uint32_t (*)(void *)) 0) {
           ndx = int(i);
           break;
         }
@@ -1528,6 +1556,12 @@ namespace Ep128 {
     callbacks[ndx].func = func;
     callbacks[ndx].userData = userData_;
     callbacks[ndx].nxt = (Ep128VMCallback *) 0;
+    // schedule the function for the next cycle
+    callbacks[ndx].delay = (callbackCycles - callbackCyclesRemaining) + 1U;
+    if (callbackCyclesRemaining > 1U) {
+      callbackCycles = callbackCycles - callbackCyclesRemaining + 1U;
+      callbackCyclesRemaining = 1U;
+    }
     if (isEnabled) {
       Ep128VMCallback   *prv = (Ep128VMCallback *) 0;
       Ep128VMCallback   *p = firstCallback;
@@ -1543,6 +1577,30 @@ namespace Ep128 {
     }
   }
 
+  void Ep128VM::runCallbacks()
+  {
+    // make the delays relative to the current cycle
+    Ep128VMCallback   *p = firstCallback;
+    while (p) {
+      p->delay -= callbackCycles;
+      p = p->nxt;
+    }
+    callbackCycles = 0U;
+    callbackCyclesRemaining = 0U;
+    p = firstCallback;
+    while (p) {
+      Ep128VMCallback *nxt = p->nxt;
+      if (!p->delay)
+        p->delay = p->func(p->userData);
+      p = nxt;
+    }
+    uint32_t  n = 0x40000000U;
+    for (p = firstCallback; p; p = p->nxt)
+      n = (p->delay < n ? p->delay : n);
+    callbackCycles = n;
+    callbackCyclesRemaining = n;
+  }
+
   // --------------------------------------------------------------------------
 
   Ep128VM::Ep128VM(Ep128Emu::VideoDisplay& display_,
@@ -1581,6 +1639,8 @@ namespace Ep128 {
       spectrumEmulatorEnabled(false),
       prvRTCTime(-1L),
       firstCallback((Ep128VMCallback *) 0),
+      callbackCycles(1U),
+      callbackCyclesRemaining(1U),
       videoCapture((Ep128Emu::VideoCapture *) 0),
       nickCyclesPerCPUCycleD2(0U),
       videoMemoryWaitMult(0U),
@@ -1625,9 +1685,10 @@ namespace Ep128 {
     memory.setSDExtPtr(&sdext);
 #endif
     for (size_t i = 0; i < (sizeof(callbacks) / sizeof(Ep128VMCallback)); i++) {
-      callbacks[i].func = (void (*)(void *)) 0;
+      callbacks[i].func = (uint32_t (*)(void *)) 0;
       callbacks[i].userData = (void *) 0;
       callbacks[i].nxt = (Ep128VMCallback *) 0;
+      callbacks[i].delay = 0U;
     }
     for (size_t i = 0; i < 4; i++) {
       pageTable[i] = 0x00;
@@ -1752,12 +1813,8 @@ namespace Ep128 {
     if (EP128EMU_UNLIKELY(nickCyclesRemainingH < 1))
       return;
     do {
-      Ep128VMCallback   *p = firstCallback;
-      while (p) {
-        Ep128VMCallback *nxt = p->nxt;
-        p->func(p->userData);
-        p = nxt;
-      }
+      if (EP128EMU_UNLIKELY(!(--callbackCyclesRemaining)))
+        runCallbacks();
       daveCyclesRemaining += daveCyclesPerNickCycle;
       if (daveCyclesRemaining >= 0L) {
         do {
@@ -1770,8 +1827,12 @@ namespace Ep128 {
         } while (EP128EMU_UNLIKELY(daveCyclesRemaining >= 0L));
       }
       cpuCyclesRemaining += cpuCyclesPerNickCycle;
-      while (cpuCyclesRemaining >= 0L)
-        z80.executeInstruction();
+      while (cpuCyclesRemaining >= 0L) {
+        // while the CPU is waiting for an interrupt in HALT, only the timing
+        // of the repeated opcode fetches needs to be emulated
+        if (EP128EMU_EXPECT(!z80.isExecutingHalt()) || !runHaltCycle())
+          z80.executeInstruction();
+      }
       nick.runOneSlot();
     } while (EP128EMU_EXPECT(--nickCyclesRemainingH > 0));
   }
@@ -1921,6 +1982,7 @@ namespace Ep128 {
       stopDemoPlayback();       // changing configuration implies stopping
       stopDemoRecording(false); // any demo playback or recording
       memoryTimingEnabled = isEnabled;
+      setMemoryWaitTiming();
     }
   }
 
@@ -2345,6 +2407,18 @@ namespace Ep128 {
     return nullptr;
   }
 
+  void Ep128VM::getMemoryUsage(MemoryUsage& memoryUsage_) const
+  {
+    memory.getMemoryUsage(memoryUsage_.ramSize, memoryUsage_.romSize,
+                          memoryUsage_.sharedROMSize, memoryUsage_.tableSize);
+    memoryUsage_.machineSize = sizeof(Ep128VM);
+  }
+
+  uint64_t Ep128VM::getInstructionCount() const
+  {
+    return z80.getInstructionCount();
+  }
+
   uint8_t Ep128VM::readMemory(uint32_t addr, bool isCPUAddress) const
   {
     if (isCPUAddress)
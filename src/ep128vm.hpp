@@ -69,6 +69,9 @@ namespace Ep128 {
                                            (bool *) 0);
       virtual EP128EMU_REGPARM2 uint8_t readOpcodeByte(int offset);
       virtual EP128EMU_REGPARM2 uint16_t readOpcodeWord(int offset);
+#ifdef Z80_DECODE_CACHE
+      virtual EP128EMU_REGPARM1 uint32_t readOpcodeFirstByteDecoded();
+#endif
       virtual EP128EMU_REGPARM3 void writeMemory(uint16_t addr, uint8_t value);
       virtual EP128EMU_REGPARM3 void writeMemoryWord(uint16_t addr,
                                                      uint16_t value);
@@ -83,6 +86,10 @@ namespace Ep128 {
       void writeUserMemory(uint16_t addr, uint8_t value);
      public:
       void closeAllFiles();
+      inline bool haveOpenFiles() const
+      {
+        return !fileChannels.empty();
+      }
     };
     class Memory_ : public Memory {
      private:
@@ -146,6 +153,12 @@ namespace Ep128 {
     int64_t   memoryWaitCycles;         // in 2^-32 Z80 cycle units
     uint8_t   memoryWaitMode;           // set on write to port 0xBF
     bool      memoryTimingEnabled;
+    // memoryWaitCycles_M1 and memoryWaitCycles for each page, or the times
+    // without memory timing emulation, updated on changes to pageTable and
+    // the wait settings; zero if the page is video memory (segments 0xFC to
+    // 0xFF) that needs videoMemoryWait_M1() or videoMemoryWait()
+    int64_t   pageWaitCycles_M1[4];
+    int64_t   pageWaitCycles[4];
     // 0: normal mode, 1: single step, 2: step over, 3: trace
     uint8_t   singleStepMode;
     int32_t   singleStepModeNextAddr;
@@ -190,12 +203,15 @@ namespace Ep128 {
     uint8_t   cmosMemory[64];
     int64_t   prvRTCTime;
     struct Ep128VMCallback {
-      void      (*func)(void *);
+      uint32_t  (*func)(void *);
       void      *userData;
       Ep128VMCallback *nxt;
+      uint32_t  delay;
     };
     Ep128VMCallback   callbacks[16];
     Ep128VMCallback   *firstCallback;
+    uint32_t  callbackCycles;           // length of the current wait
+    uint32_t  callbackCyclesRemaining;  // until the next callback is due
     Ep128Emu::VideoCapture  *videoCapture;
     uint8_t   externalDACIOPorts[4];
     uint32_t  nickCyclesPerCPUCycleD2;  // in 2^-31 NICK cycle units
@@ -244,10 +260,17 @@ namespace Ep128 {
     // ----------------
     void updateTimingParameters();
     void setMemoryWaitTiming();
+    void updatePageWaitCycles(uint8_t page);
     inline void updateCPUCycles(int cycles);
     EP128EMU_REGPARM1 void videoMemoryWait();
     EP128EMU_REGPARM1 void videoMemoryWait_M1();
     EP128EMU_REGPARM1 void videoMemoryWait_IO();
+    // subtract the wait cycles of a memory access or opcode fetch at 'addr'
+    EP128EMU_INLINE void memoryWait(uint16_t addr);
+    EP128EMU_INLINE void memoryWait_M1(uint16_t addr);
+    // runs one cycle of a CPU executing HALT without decoding the opcode,
+    // returns false if the instruction needs to be executed normally
+    EP128EMU_INLINE bool runHaltCycle();
     // called from the Z80 emulation to synchronize NICK and DAVE with the CPU
     EP128EMU_REGPARM1 void runDevices();
     static uint8_t davePortReadCallback(void *userData, uint16_t addr);
@@ -288,13 +311,15 @@ namespace Ep128 {
                                      uint16_t addr, uint8_t value);
     static uint8_t sidPortDebugReadCallback(void *userData, uint16_t addr);
 #endif
-    static void mouseTimerCallback(void *userData);
-    static void tapeCallback(void *userData);
-    static void demoPlayCallback(void *userData);
-    static void demoRecordCallback(void *userData);
-    static void videoCaptureCallback(void *userData);
+    static uint32_t mouseTimerCallback(void *userData);
+    // returns the number of NICK slots until the mouse timeout, or 0
+    uint32_t getMouseTimer() const;
+    static uint32_t tapeCallback(void *userData);
+    static uint32_t demoPlayCallback(void *userData);
+    static uint32_t demoRecordCallback(void *userData);
+    static uint32_t videoCaptureCallback(void *userData);
 #ifdef ENABLE_RESID
-    static void sidCallback(void *userData);
+    static uint32_t sidCallback(void *userData);
 #endif
     void stopDemoPlayback();
     void stopDemoRecording(bool writeFile_);
@@ -303,10 +328,14 @@ namespace Ep128 {
     void updateRTC();
     void resetCMOSMemory();
     void resetFloppyDrives(bool isColdReset);
-    // Set function to be called at every NICK cycle. The functions are called
-    // in the order of being registered; up to 16 callbacks can be set.
-    void setCallback(void (*func)(void *userData), void *userData_,
+    // Set function to be called at the next NICK cycle. The function returns
+    // the number of cycles (>= 1) until it is to be called again. Functions
+    // that are due in the same cycle are called in the order of being
+    // registered; up to 16 callbacks can be set.
+    void setCallback(uint32_t (*func)(void *userData), void *userData_,
                      bool isEnabled);
+    // Call the functions that are due, and schedule the next call.
+    void runCallbacks();
    public:
     Ep128VM(Ep128Emu::VideoDisplay&, Ep128Emu::AudioOutput&);
     virtual ~Ep128VM();
@@ -525,6 +554,11 @@ namespace Ep128 {
      * Returns a memory pointer to page 'n' (0x00 to 0xFF).
      */
     virtual void * getSegmentPtr(int n) const;
+    /*!
+     * Returns the number of bytes allocated by the emulated machine.
+     */
+    virtual void getMemoryUsage(MemoryUsage& memoryUsage_) const;
+    virtual uint64_t getInstructionCount() const;
     /*!
      * Read a byte from memory. If 'isCPUAddress' is false, bits 14 to 21 of
      * 'addr' define the segment number, while bits 0 to 13 are the offset
@@ -657,6 +691,16 @@ namespace Ep128 {
      * playing a demo.
      */
     virtual bool getIsPlayingDemo() const;
+    /*!
+     * Returns true if the state can be saved with forkState(); this is false
+     * while tape, disk or file I/O, demo recording or playback, or video
+     * capture is in progress.
+     */
+    virtual bool getIsStateForkAllowed() const;
+    /*!
+     * Save or restore the state of the emulated machine for run-ahead.
+     */
+    virtual void forkState(Ep128Emu::StateFork& f);
     // ----------------
     virtual void loadState(Ep128Emu::File::Buffer&);
     virtual void loadMachineConfiguration(Ep128Emu::File::Buffer&);
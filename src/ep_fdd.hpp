@@ -124,6 +124,11 @@ namespace Ep128Emu {
         return getLEDState_();
       return 0x00;
     }
+    // returns true if the drive has been accessed recently
+    inline bool getIsActive() const
+    {
+      return (ledStateCounter != 0U);
+    }
     virtual void reset();
     inline uint8_t getSectorsPerTrack() const
     {
@@ -697,6 +697,13 @@ namespace CPC464 {
     }
   }
 
+  void FDC765::forkState(Ep128Emu::StateFork& f)
+  {
+    // the sector buffer is only used while a command is being executed,
+    // see CPC464VM::getIsStateForkAllowed()
+    EP128EMU_FORK_RANGE(f, FDC765, cmdParams, rotationAngles);
+  }
+
   uint8_t FDC765::readMainStatusRegister() const
   {
     uint8_t retval = (uint8_t(fdcState != 0) << 4)
@@ -116,6 +116,7 @@ namespace CPC464 {
     FDC765();
     virtual ~FDC765();
     virtual void reset();
+    void forkState(Ep128Emu::StateFork&);
     // run floppy drive emulation (should be called at a rate of 31250 Hz)
     EP128EMU_INLINE void runOneByte()
     {
@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include <map>
+#include <utility>
 
 static const unsigned char  ep128EmuFile_Magic[16] = {
   0x5D, 0x12, 0xE4, 0xF4, 0xC9, 0xDA, 0xB6, 0x42,
@@ -88,6 +89,23 @@ namespace Ep128Emu {
     this->clear();
   }
 
+  void File::Buffer::grow(size_t nBytes)
+  {
+    // double the size, so that writing N bytes in small pieces takes
+    // O(N) time in total
+    size_t  newSize = (allocSize > 256 ? allocSize : 256);
+    while (newSize < nBytes)
+      newSize = newSize << 1;
+    unsigned char *newBuf = new unsigned char[newSize];
+    if (buf) {
+      if (dataSize > 0)
+        std::memcpy(newBuf, buf, dataSize);
+      delete[] buf;
+    }
+    buf = newBuf;
+    allocSize = newSize;
+  }
+
   File::Buffer::Buffer(const unsigned char *buf_, size_t nBytes)
   {
     buf = (unsigned char *) 0;
@@ -206,19 +224,19 @@ namespace Ep128Emu {
     return std::string(reinterpret_cast<char *>(&buf[j]));
   }
 
+  void File::Buffer::readData(unsigned char *buf_, size_t nBytes)
+  {
+    if (nBytes > (dataSize - curPos))
+      throw Exception("unexpected end of data chunk");
+    if (nBytes > 0)
+      std::memcpy(buf_, buf + curPos, nBytes);
+    curPos += nBytes;
+  }
+
   void File::Buffer::writeByte(unsigned char n)
   {
-    if (curPos >= allocSize) {
-      size_t        newSize = ((allocSize + (allocSize >> 3)) | 255) + 1;
-      unsigned char *newBuf = new unsigned char[newSize];
-      if (buf) {
-        for (size_t i = 0; i < dataSize; i++)
-          newBuf[i] = buf[i];
-        delete[] buf;
-      }
-      buf = newBuf;
-      allocSize = newSize;
-    }
+    if (EP128EMU_UNLIKELY(curPos >= allocSize))
+      grow(curPos + 1);
     buf[curPos++] = n & 0xFF;
     if (curPos > dataSize)
       dataSize = curPos;
@@ -347,22 +365,11 @@ namespace Ep128Emu {
 
   void File::Buffer::writeData(const unsigned char *buf_, size_t nBytes)
   {
-    if ((curPos + nBytes) > allocSize) {
-      size_t  newSize = allocSize;
-      do {
-        newSize = ((newSize + (newSize >> 3)) | 255) + 1;
-      } while (newSize < (curPos + nBytes));
-      unsigned char *newBuf = new unsigned char[newSize];
-      if (buf) {
-        for (size_t i = 0; i < dataSize; i++)
-          newBuf[i] = buf[i];
-        delete[] buf;
-      }
-      buf = newBuf;
-      allocSize = newSize;
-    }
-    for (size_t i = 0; i < nBytes; i++)
-      buf[curPos++] = buf_[i] & 0xFF;
+    if ((curPos + nBytes) > allocSize)
+      grow(curPos + nBytes);
+    if (nBytes > 0)
+      std::memcpy(buf + curPos, buf_, nBytes);
+    curPos += nBytes;
     if (curPos > dataSize)
       dataSize = curPos;
   }
@@ -370,27 +377,20 @@ namespace Ep128Emu {
   void File::Buffer::setPosition(size_t pos)
   {
     if (pos > dataSize) {
-      if (pos > allocSize) {
-        size_t  newSize = allocSize;
-        do {
-          newSize = ((newSize + (newSize >> 3)) | 255) + 1;
-        } while (newSize < pos);
-        unsigned char *newBuf = new unsigned char[newSize];
-        if (buf) {
-          for (size_t i = 0; i < dataSize; i++)
-            newBuf[i] = buf[i];
-          delete[] buf;
-        }
-        buf = newBuf;
-        allocSize = newSize;
-      }
-      for (size_t i = dataSize; i < pos; i++)
-        buf[i] = 0;
+      if (pos > allocSize)
+        grow(pos);
+      std::memset(buf + dataSize, 0, pos - dataSize);
       dataSize = pos;
     }
     curPos = pos;
   }
 
+  void File::Buffer::reserve(size_t nBytes)
+  {
+    if (nBytes > allocSize)
+      grow(nBytes);
+  }
+
   void File::Buffer::clear()
   {
     if (buf)
@@ -401,6 +401,20 @@ namespace Ep128Emu {
     allocSize = 0;
   }
 
+  void File::Buffer::reset()
+  {
+    curPos = 0;
+    dataSize = 0;
+  }
+
+  void File::Buffer::swap(Buffer& b)
+  {
+    std::swap(buf, b.buf);
+    std::swap(curPos, b.curPos);
+    std::swap(dataSize, b.dataSize);
+    std::swap(allocSize, b.allocSize);
+  }
+
   // --------------------------------------------------------------------------
 
   void File::loadZXSnapshotFile(std::FILE *f, const char *fileName)
@@ -581,10 +595,8 @@ namespace Ep128Emu {
   File::File(unsigned char * data, size_t size)
   {
     // Copy contents to buffer directly. Header is ignored.
-    for (size_t i = 16; i < size; i++)
-    {
-      buf.writeByte((unsigned char) (data[i] & 0xFF));
-    }
+    if (size > 16)
+      buf.writeData(data + 16, size - 16);
     buf.setPosition(0);
   }
 
@@ -724,7 +736,12 @@ namespace Ep128Emu {
           fileRemove(fullName.c_str());
       }
     }
-    buf.clear();
+    // when writing to memory (e.g. a snapshot for the frontend), the buffer
+    // is kept allocated, as it may be an arena reused with swapBuffer()
+    if (useMem)
+      buf.reset();
+    else
+      buf.clear();
     if (err)
       throw Exception("error opening or writing file");
   }
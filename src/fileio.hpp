@@ -31,6 +31,7 @@ namespace Ep128Emu {
      private:
       unsigned char *buf;
       size_t  curPos, dataSize, allocSize;
+      void grow(size_t nBytes);
      public:
       unsigned char readByte();
       bool readBoolean();
@@ -43,6 +44,7 @@ namespace Ep128Emu {
       uint64_t readUIntVLen();
       double readFloat();
       std::string readString();
+      void readData(unsigned char *buf_, size_t nBytes);
       void writeByte(unsigned char n);
       void writeBoolean(bool n);
       void writeInt16(int16_t n);
@@ -56,7 +58,16 @@ namespace Ep128Emu {
       void writeString(const std::string& n);
       void writeData(const unsigned char *buf_, size_t nBytes);
       void setPosition(size_t pos);
+      // allocates space for at least 'nBytes' bytes of data, so that
+      // writing up to that size does not need to reallocate the buffer
+      void reserve(size_t nBytes);
       void clear();
+      // like clear(), but keeps the allocated memory for reuse
+      void reset();
+      // exchanges the contents and allocated memory of the two buffers;
+      // this can be used to keep an "arena" buffer between snapshots, so
+      // that the memory of the previous one is reused
+      void swap(Buffer& b);
       inline size_t getPosition() const
       {
         return curPos;
@@ -134,6 +145,11 @@ namespace Ep128Emu {
     void loadCompressedFile(std::FILE *f);
    public:
     void addChunk(ChunkType type, const Buffer& buf_);
+    // exchanges the file buffer with 'buf_' (see Buffer::swap())
+    inline void swapBuffer(Buffer& buf_)
+    {
+      buf.swap(buf_);
+    }
     void processAllChunks();
     void writeFile(const char *fileName, bool useHomeDirectory = false,
                    bool enableCompression = false);
@@ -199,6 +199,14 @@ namespace Ep128 {
       }
       return 0U;
     }
+    // returns true if any of the drives has been accessed recently
+    inline bool getIsActive() const
+    {
+      return ((idePort0.ideDrive0.ledStateCounter
+               | idePort0.ideDrive1.ledStateCounter
+               | idePort1.ideDrive0.ledStateCounter
+               | idePort1.ideDrive1.ledStateCounter) != 0);
+    }
   };
 
 }       // namespace Ep128
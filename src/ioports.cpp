@@ -325,5 +325,10 @@ namespace Ep128 {
     }
   }
 
+  void IOPorts::forkState(Ep128Emu::StateFork& f)
+  {
+    f.copyData(portValues, 256);
+  }
+
 }       // namespace Ep128
 
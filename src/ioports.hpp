@@ -71,6 +71,7 @@ namespace Ep128 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
    protected:
     virtual void breakPointCallback(bool isWrite, uint16_t addr, uint8_t value);
   };
@@ -0,0 +1,484 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+#include "ep128emu.hpp"
+#include "membase.hpp"
+#include "romcache.hpp"
+#include "statefork.hpp"
+#ifdef Z80_DECODE_CACHE
+#  include "z80/z80.hpp"
+#endif
+
+namespace Ep128Emu {
+
+  void MemoryBase::allocateSegment(uint8_t n, bool isROM)
+  {
+    if (segmentSharedTable[n])
+      unshareSegment(n);
+    if (segmentTable[n] == (uint8_t *) 0)
+      segmentTable[n] = new uint8_t[16384];
+    segmentROMTable[n] = isROM;
+    // the position of the segments in the StateFork data may have changed
+    setAllSegmentsDirty();
+    updatePaging();
+  }
+
+  void MemoryBase::shareSegment(uint8_t n)
+  {
+    // replace private copy of ROM segment with a shared page from the cache
+    if (!segmentTable[n] || !segmentROMTable[n] || segmentSharedTable[n])
+      return;
+    const uint8_t *p = ROMSegmentCache::acquire(segmentTable[n]);
+    delete[] segmentTable[n];
+    segmentTable[n] = const_cast< uint8_t * >(p);
+    segmentSharedTable[n] = true;
+    updatePaging();
+  }
+
+  void MemoryBase::unshareSegment(uint8_t n)
+  {
+    // make a private copy of a shared segment before it is modified
+    if (!segmentSharedTable[n])
+      return;
+    uint8_t *p = new uint8_t[16384];
+    std::memcpy(p, segmentTable[n], 16384);
+    ROMSegmentCache::release(segmentTable[n]);
+    segmentTable[n] = p;
+    segmentSharedTable[n] = false;
+    updatePaging();
+  }
+
+  void MemoryBase::checkExecuteBreakPoint(uint16_t addr, uint8_t segment,
+                                          uint8_t value)
+  {
+    const uint8_t *tbl = breakPointTable;
+    if (tbl != (uint8_t *) 0 &&
+        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 36) == 4) {
+      breakPointCallback(false, addr, value);
+    }
+    else {
+      uint16_t  offs = addr & 0x3FFF;
+      tbl = segmentBreakPointTable[segment];
+      if (tbl != (uint8_t *) 0 &&
+          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 36) == 4) {
+        breakPointCallback(false, addr, value);
+      }
+    }
+  }
+
+  void MemoryBase::checkReadBreakPoint(uint16_t addr, uint8_t segment,
+                                       uint8_t value)
+  {
+    const uint8_t *tbl = breakPointTable;
+    if (tbl != (uint8_t *) 0 &&
+        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 1) != 0) {
+      breakPointCallback(false, addr, value);
+    }
+    else {
+      uint16_t  offs = addr & 0x3FFF;
+      tbl = segmentBreakPointTable[segment];
+      if (tbl != (uint8_t *) 0 &&
+          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 1) != 0) {
+        breakPointCallback(false, addr, value);
+      }
+    }
+  }
+
+  void MemoryBase::checkWriteBreakPoint(uint16_t addr, uint8_t segment,
+                                        uint8_t value)
+  {
+    const uint8_t *tbl = breakPointTable;
+    if (tbl != (uint8_t *) 0 &&
+        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 2) != 0) {
+      breakPointCallback(true, addr, value);
+    }
+    else {
+      uint16_t  offs = addr & 0x3FFF;
+      tbl = segmentBreakPointTable[segment];
+      if (tbl != (uint8_t *) 0 &&
+          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 2) != 0) {
+        breakPointCallback(true, addr, value);
+      }
+    }
+  }
+
+  MemoryBase::MemoryBase()
+    : segmentTable((uint8_t **) 0),
+      segmentROMTable((bool *) 0),
+      segmentSharedTable((bool *) 0),
+      breakPointTable((uint8_t *) 0),
+      breakPointCnt(0),
+      segmentBreakPointTable((uint8_t **) 0),
+      segmentBreakPointCntTable((size_t *) 0),
+      haveBreakPoints(false),
+      breakPointPriorityThreshold(0),
+      dummyMemory((uint8_t *) 0),
+      segmentDirtyTable((bool *) 0)
+#ifdef Z80_DECODE_CACHE
+      , decodeCacheTable((uint32_t **) 0)
+#endif
+  {
+    try {
+      segmentTable = new uint8_t*[256];
+      for (int i = 0; i < 256; i++)
+        segmentTable[i] = (uint8_t *) 0;
+      segmentROMTable = new bool[256];
+      for (int i = 0; i < 256; i++)
+        segmentROMTable[i] = true;
+      segmentSharedTable = new bool[256];
+      for (int i = 0; i < 256; i++)
+        segmentSharedTable[i] = false;
+      segmentBreakPointTable = new uint8_t*[256];
+      for (int i = 0; i < 256; i++)
+        segmentBreakPointTable[i] = (uint8_t *) 0;
+      segmentBreakPointCntTable = new size_t[256];
+      for (int i = 0; i < 256; i++)
+        segmentBreakPointCntTable[i] = 0;
+      dummyMemory = new uint8_t[32768];
+      for (int i = 0; i < 32768; i++)
+        dummyMemory[i] = 0xFF;
+      segmentDirtyTable = new bool[256];
+#ifdef Z80_DECODE_CACHE
+      decodeCacheTable = new uint32_t*[256];
+      for (int i = 0; i < 256; i++)
+        decodeCacheTable[i] = (uint32_t *) 0;
+#endif
+      setAllSegmentsDirty();
+    }
+    catch (...) {
+      if (segmentTable) {
+        delete[] segmentTable;
+        segmentTable = (uint8_t **) 0;
+      }
+      if (segmentROMTable) {
+        delete[] segmentROMTable;
+        segmentROMTable = (bool *) 0;
+      }
+      if (segmentSharedTable) {
+        delete[] segmentSharedTable;
+        segmentSharedTable = (bool *) 0;
+      }
+      if (segmentBreakPointTable) {
+        delete[] segmentBreakPointTable;
+        segmentBreakPointTable = (uint8_t **) 0;
+      }
+      if (segmentBreakPointCntTable) {
+        delete[] segmentBreakPointCntTable;
+        segmentBreakPointCntTable = (size_t *) 0;
+      }
+      if (dummyMemory) {
+        delete[] dummyMemory;
+        dummyMemory = (uint8_t *) 0;
+      }
+      if (segmentDirtyTable) {
+        delete[] segmentDirtyTable;
+        segmentDirtyTable = (bool *) 0;
+      }
+#ifdef Z80_DECODE_CACHE
+      if (decodeCacheTable) {
+        delete[] decodeCacheTable;
+        decodeCacheTable = (uint32_t **) 0;
+      }
+#endif
+      throw;
+    }
+  }
+
+  MemoryBase::~MemoryBase()
+  {
+    for (int i = 0; i < 256; i++) {
+      if (segmentSharedTable[i])
+        ROMSegmentCache::release(segmentTable[i]);
+      else if (segmentTable[i])
+        delete[] segmentTable[i];
+    }
+    delete[] dummyMemory;
+    delete[] segmentTable;
+    delete[] segmentROMTable;
+    delete[] segmentSharedTable;
+    if (breakPointTable)
+      delete[] breakPointTable;
+    for (int i = 0; i < 256; i++) {
+      if (segmentBreakPointTable[i])
+        delete[] segmentBreakPointTable[i];
+    }
+    delete[] segmentBreakPointTable;
+    delete[] segmentBreakPointCntTable;
+    delete[] segmentDirtyTable;
+#ifdef Z80_DECODE_CACHE
+    for (int i = 0; i < 256; i++) {
+      if (decodeCacheTable[i])
+        delete[] (decodeCacheTable[i] - 2);
+    }
+    delete[] decodeCacheTable;
+#endif
+  }
+
+  void MemoryBase::setBreakPoint(uint8_t segment, uint16_t addr, int priority,
+                                 bool r, bool w, bool x, bool ignoreFlag)
+  {
+    uint8_t mode =
+        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
+    if (mode) {
+      // create new breakpoint, or change existing one
+      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
+      if (!segmentBreakPointTable[segment]) {
+        segmentBreakPointTable[segment] = new uint8_t[16384];
+        for (int i = 0; i < 16384; i++)
+          segmentBreakPointTable[segment][i] = 0;
+      }
+      haveBreakPoints = true;
+      uint8_t&  bp = segmentBreakPointTable[segment][addr & 0x3FFF];
+      if (!bp)
+        segmentBreakPointCntTable[segment]++;
+      if (bp > mode)
+        mode = (bp & 56) + (mode & 7);
+      mode |= (bp & 7);
+      bp = mode;
+    }
+    else if (segmentBreakPointTable[segment]) {
+      if (segmentBreakPointTable[segment][addr & 0x3FFF]) {
+        // remove a previously existing breakpoint
+        segmentBreakPointCntTable[segment]--;
+        if (!segmentBreakPointCntTable[segment]) {
+          delete[] segmentBreakPointTable[segment];
+          segmentBreakPointTable[segment] = (uint8_t *) 0;
+        }
+      }
+    }
+  }
+
+  void MemoryBase::setBreakPoint(uint16_t addr, int priority,
+                                 bool r, bool w, bool x, bool ignoreFlag)
+  {
+    uint8_t mode =
+        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
+    if (mode) {
+      // create new breakpoint, or change existing one
+      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
+      if (!breakPointTable) {
+        breakPointTable = new uint8_t[65536];
+        for (int i = 0; i < 65536; i++)
+          breakPointTable[i] = 0;
+      }
+      haveBreakPoints = true;
+      uint8_t&  bp = breakPointTable[addr];
+      if (!bp)
+        breakPointCnt++;
+      if (bp > mode)
+        mode = (bp & 56) + (mode & 7);
+      mode |= (bp & 7);
+      bp = mode;
+    }
+    else if (breakPointTable) {
+      if (breakPointTable[addr]) {
+        // remove a previously existing breakpoint
+        breakPointCnt--;
+        if (!breakPointCnt) {
+          delete[] breakPointTable;
+          breakPointTable = (uint8_t *) 0;
+        }
+      }
+    }
+  }
+
+  void MemoryBase::clearBreakPoints(uint8_t segment)
+  {
+    for (uint16_t addr = 0; addr < 16384; addr++)
+      setBreakPoint(segment, addr, 0, false, false, false, false);
+  }
+
+  void MemoryBase::clearBreakPoints()
+  {
+    for (unsigned int addr = 0; addr < 65536; addr++)
+      setBreakPoint((uint16_t) addr, 0, false, false, false, false);
+  }
+
+  void MemoryBase::clearAllBreakPoints()
+  {
+    clearBreakPoints();
+    for (unsigned int segment = 0; segment < 256; segment++)
+      clearBreakPoints((uint8_t) segment);
+    haveBreakPoints = false;
+  }
+
+  void MemoryBase::breakPointCallback(bool isWrite,
+                                      uint16_t addr, uint8_t value)
+  {
+    (void) isWrite;
+    (void) addr;
+    (void) value;
+  }
+
+  void MemoryBase::setBreakPointPriorityThreshold(int n)
+  {
+    breakPointPriorityThreshold = uint8_t((n > 0 ? (n < 4 ? n : 4) : 0) << 3);
+  }
+
+  int MemoryBase::getBreakPointPriorityThreshold()
+  {
+    return int(breakPointPriorityThreshold >> 3);
+  }
+
+  void MemoryBase::deleteSegment(uint8_t segment)
+  {
+    if (segmentSharedTable[segment])
+      ROMSegmentCache::release(segmentTable[segment]);
+    else if (segmentTable[segment])
+      delete[] segmentTable[segment];
+    segmentTable[segment] = (uint8_t *) 0;
+    segmentROMTable[segment] = true;
+    segmentSharedTable[segment] = false;
+#ifdef Z80_DECODE_CACHE
+    if (decodeCacheTable[segment]) {
+      delete[] (decodeCacheTable[segment] - 2);
+      decodeCacheTable[segment] = (uint32_t *) 0;
+    }
+#endif
+    setAllSegmentsDirty();
+    updatePaging();
+  }
+
+  void MemoryBase::setAllSegmentsDirty()
+  {
+    for (int i = 0; i < 256; i++) {
+      segmentDirtyTable[i] = true;
+#ifdef Z80_DECODE_CACHE
+      clearDecodeCache(uint8_t(i));
+#endif
+    }
+  }
+
+  void MemoryBase::forkSegments(StateFork& f)
+  {
+    for (int i = 0; i < 256; i++) {
+      if (segmentTable[i] && !segmentROMTable[i]) {
+#ifdef Z80_DECODE_CACHE
+        if (f.isRestoring() && segmentDirtyTable[i])
+          clearDecodeCache(uint8_t(i));
+#endif
+        f.copySegment(segmentTable[i], segmentDirtyTable[i]);
+      }
+    }
+  }
+
+#ifdef Z80_DECODE_CACHE
+  uint32_t MemoryBase::decodeInstruction(uint8_t segment, uint16_t offs)
+  {
+    const uint8_t *p = segmentTable[segment];
+    if (!p)
+      return 0U;
+    uint32_t  *t = decodeCacheTable[segment];
+    if (!t) {
+      t = new uint32_t[16386];
+      for (int i = 0; i < 16386; i++)
+        t[i] = 0U;
+      t = t + 2;
+      decodeCacheTable[segment] = t;
+    }
+    uint32_t  retval =
+        Ep128::Z80::predecodeInstruction(p + offs, size_t(16384 - offs));
+    t[offs] = retval;
+    return retval;
+  }
+
+  void MemoryBase::clearDecodeCache(uint8_t segment)
+  {
+    uint32_t  *t = decodeCacheTable[segment];
+    if (t)
+      std::memset(t - 2, 0, sizeof(uint32_t) * 16386);
+  }
+
+#endif
+
+  void MemoryBase::getMemoryUsage(size_t& ramBytes, size_t& romBytes,
+                                  size_t& sharedROMBytes,
+                                  size_t& tableBytes) const
+  {
+    ramBytes = 0;
+    romBytes = 0;
+    sharedROMBytes = 0;
+    // segment tables and dummy memory
+    tableBytes = (256 * ((sizeof(uint8_t *) * 2) + (sizeof(bool) * 3)
+                         + sizeof(size_t)))
+                 + 32768;
+    if (breakPointTable)
+      tableBytes += 65536;
+    for (int i = 0; i < 256; i++) {
+      if (segmentTable[i]) {
+        if (segmentSharedTable[i])
+          sharedROMBytes += 16384;
+        else if (segmentROMTable[i])
+          romBytes += 16384;
+        else
+          ramBytes += 16384;
+      }
+      if (segmentBreakPointTable[i])
+        tableBytes += 16384;
+#ifdef Z80_DECODE_CACHE
+      if (decodeCacheTable[i])
+        tableBytes += (sizeof(uint32_t) * 16386);
+#endif
+    }
+  }
+
+  bool MemoryBase::checkIgnoreBreakPoint(uint16_t addr, uint8_t segment) const
+  {
+    const uint8_t *tbl = breakPointTable;
+    if (tbl != (uint8_t *) 0 && (tbl[addr] & 32) != 0) {
+      return true;
+    }
+    else {
+      uint16_t  offs = addr & 0x3FFF;
+      tbl = segmentBreakPointTable[segment];
+      if (tbl != (uint8_t *) 0 && (tbl[offs] & 32) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  BreakPointList MemoryBase::getBreakPointList()
+  {
+    BreakPointList  bplst;
+    if (breakPointTable) {
+      for (size_t i = 0; i < 65536; i++) {
+        uint8_t bp = breakPointTable[i];
+        if (bp)
+          bplst.addMemoryBreakPoint(uint16_t(i),
+                                    bool(bp & 1), bool(bp & 2), bool(bp & 4),
+                                    bool(bp & 32), bp >> 3);
+      }
+    }
+    for (size_t j = 0; j < 256; j++) {
+      if (segmentBreakPointTable[j]) {
+        for (size_t i = 0; i < 16384; i++) {
+          uint8_t bp = segmentBreakPointTable[j][i];
+          if (bp)
+            bplst.addMemoryBreakPoint(uint8_t(j), uint16_t(i),
+                                      bool(bp & 1), bool(bp & 2), bool(bp & 4),
+                                      bool(bp & 32), bp >> 3);
+        }
+      }
+    }
+    return bplst;
+  }
+
+}       // namespace Ep128Emu
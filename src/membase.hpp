@@ -0,0 +1,212 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef EP128EMU_MEMBASE_HPP
+#define EP128EMU_MEMBASE_HPP
+
+#include "ep128emu.hpp"
+#include "bplist.hpp"
+
+namespace Ep128Emu {
+
+  class StateFork;
+
+  // Segment and breakpoint handling shared by the memory classes of all
+  // machines. Memory is made of 256 segments of 16K, which are RAM, ROM
+  // (possibly shared through ROMSegmentCache), or missing. The derived
+  // class implements the paging of the segments into the Z80 address
+  // space, and the inline read and write functions; updatePaging() is
+  // called whenever a segment pointer or ROM flag changes, and should
+  // rebuild the page address tables from segmentTable.
+  // Segments that are not owned by this class (e.g. a separately allocated
+  // video memory) must be removed from segmentTable by the destructor of
+  // the derived class.
+  // The write functions of the derived class also call segmentWritten()
+  // for the segment written, so that forkSegments() only needs to copy the
+  // segments that have changed, and the predecoded instructions of the
+  // Z80_DECODE_CACHE build are discarded when the memory changes.
+
+  class MemoryBase {
+   protected:
+    uint8_t **segmentTable;
+    bool    *segmentROMTable;
+    // true for ROM segments that point to a page in Ep128Emu::ROMSegmentCache
+    bool    *segmentSharedTable;
+    uint8_t *breakPointTable;
+    size_t  breakPointCnt;
+    uint8_t **segmentBreakPointTable;
+    size_t  *segmentBreakPointCntTable;
+    bool    haveBreakPoints;
+    uint8_t breakPointPriorityThreshold;
+    uint8_t *dummyMemory;   // 2*16K dummy memory for invalid reads and writes
+    // true for segments that may have been written since they were last
+    // copied by forkSegments()
+    bool    *segmentDirtyTable;
+#ifdef Z80_DECODE_CACHE
+    // predecoded instructions (see Z80::predecodeInstruction()) for each
+    // offset of the segments that code has been run from, or NULL; zero
+    // entries are not decoded yet. Each table has two more entries before
+    // offset 0, so that segmentWritten() can clear the entries of the two
+    // preceding bytes without checking the offset
+    uint32_t **decodeCacheTable;
+    uint32_t decodeInstruction(uint8_t segment, uint16_t offs);
+    void clearDecodeCache(uint8_t segment);
+    // returns the predecoded instruction at offset 'offs' of 'segment', or
+    // zero if the segment does not exist
+    EP128EMU_INLINE uint32_t readDecodeCache(uint8_t segment, uint16_t offs);
+#endif
+    // --------
+    void allocateSegment(uint8_t n, bool isROM);
+    void shareSegment(uint8_t n);
+    void unshareSegment(uint8_t n);
+    // 'segment' is the segment that 'addr' is mapped to for the type of
+    // access being checked
+    void checkExecuteBreakPoint(uint16_t addr, uint8_t segment,
+                                uint8_t value);
+    void checkReadBreakPoint(uint16_t addr, uint8_t segment, uint8_t value);
+    void checkWriteBreakPoint(uint16_t addr, uint8_t segment, uint8_t value);
+    bool checkIgnoreBreakPoint(uint16_t addr, uint8_t segment) const;
+    virtual void updatePaging() = 0;
+    virtual void breakPointCallback(bool isWrite,
+                                    uint16_t addr, uint8_t value);
+    // copies the RAM segments to or from 'f' (see StateFork::copySegment());
+    // only the segments written since the previous call are copied
+    void forkSegments(StateFork& f);
+    // called by the write functions after writing 'addr' (bits 0 to 13 are
+    // the offset) in 'segment'
+    EP128EMU_INLINE void segmentWritten(uint8_t segment, uint16_t addr);
+   public:
+    MemoryBase();
+    virtual ~MemoryBase();
+    void setBreakPoint(uint8_t segment, uint16_t addr,
+                       int priority, bool r, bool w, bool x, bool ignoreFlag);
+    void setBreakPoint(uint16_t addr,
+                       int priority, bool r, bool w, bool x, bool ignoreFlag);
+    void clearBreakPoints(uint8_t segment);
+    void clearBreakPoints();
+    void clearAllBreakPoints();
+    void setBreakPointPriorityThreshold(int n);
+    int getBreakPointPriorityThreshold();
+    void deleteSegment(uint8_t segment);
+    // marks all segments as modified, and discards the predecoded
+    // instructions; this is needed after writing to the memory other than
+    // with the write functions
+    void setAllSegmentsDirty();
+    inline uint8_t readRaw(uint32_t addr) const;
+    inline void writeRaw(uint32_t addr, uint8_t value);
+    inline void writeROM(uint32_t addr, uint8_t value);
+    inline bool getHaveBreakPoints() const;
+    inline bool isSegmentROM(uint8_t segment) const;
+    inline bool isSegmentRAM(uint8_t segment) const;
+    inline void * getSegmentPtr(uint8_t segment) const;
+    void getMemoryUsage(size_t& ramBytes, size_t& romBytes,
+                        size_t& sharedROMBytes, size_t& tableBytes) const;
+    BreakPointList getBreakPointList();
+  };
+
+  // --------------------------------------------------------------------------
+
+  inline uint8_t MemoryBase::readRaw(uint32_t addr) const
+  {
+    uint8_t segment, value;
+
+    segment = uint8_t(addr >> 14);
+    if (segmentTable[segment])
+      value = segmentTable[segment][addr & 0x3FFF];
+    else
+      value = 0xFF;
+    return value;
+  }
+
+  inline void MemoryBase::writeRaw(uint32_t addr, uint8_t value)
+  {
+    uint8_t segment = uint8_t(addr >> 14);
+    if (!segmentROMTable[segment]) {
+      segmentTable[segment][addr & 0x3FFF] = value;
+      segmentWritten(segment, uint16_t(addr & 0x3FFF));
+    }
+  }
+
+  inline void MemoryBase::writeROM(uint32_t addr, uint8_t value)
+  {
+    uint8_t segment = uint8_t(addr >> 14);
+    if (EP128EMU_UNLIKELY(segmentSharedTable[segment]))
+      unshareSegment(segment);
+    if (segmentTable[segment]) {
+      segmentTable[segment][addr & 0x3FFF] = value;
+      segmentWritten(segment, uint16_t(addr & 0x3FFF));
+    }
+  }
+
+  EP128EMU_INLINE void MemoryBase::segmentWritten(uint8_t segment,
+                                                 uint16_t addr)
+  {
+    segmentDirtyTable[segment] = true;
+#ifdef Z80_DECODE_CACHE
+    uint32_t  *t = decodeCacheTable[segment];
+    if (EP128EMU_UNLIKELY(t != (uint32_t *) 0)) {
+      // the byte written may be an operand of an instruction starting at
+      // one of the two preceding offsets
+      int     offs = int(addr & 0x3FFF);
+      t[offs - 2] = 0U;
+      t[offs - 1] = 0U;
+      t[offs] = 0U;
+    }
+#endif
+  }
+
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_INLINE uint32_t MemoryBase::readDecodeCache(uint8_t segment,
+                                                      uint16_t offs)
+  {
+    const uint32_t  *t = decodeCacheTable[segment];
+    if (EP128EMU_EXPECT(t != (uint32_t *) 0)) {
+      uint32_t  retval = t[offs];
+      if (EP128EMU_EXPECT(retval != 0U))
+        return retval;
+    }
+    return decodeInstruction(segment, offs);
+  }
+
+#endif
+  inline bool MemoryBase::getHaveBreakPoints() const
+  {
+    return haveBreakPoints;
+  }
+
+  inline bool MemoryBase::isSegmentROM(uint8_t segment) const
+  {
+    return (segmentTable[segment] != (uint8_t *) 0 &&
+            segmentROMTable[segment]);
+  }
+
+  inline bool MemoryBase::isSegmentRAM(uint8_t segment) const
+  {
+    return (segmentTable[segment] != (uint8_t *) 0 &&
+            !segmentROMTable[segment]);
+  }
+
+  inline void * MemoryBase::getSegmentPtr(uint8_t segment) const
+  {
+    return (segmentTable[segment]);
+  }
+
+}       // namespace Ep128Emu
+
+#endif  // EP128EMU_MEMBASE_HPP
@@ -22,52 +22,39 @@
 
 #include "ep128emu.hpp"
 #include "bplist.hpp"
+#include "membase.hpp"
 #ifdef ENABLE_SDEXT
 #  include "sdext.hpp"
 #endif
 
 namespace Ep128 {
 
-  class Memory {
+  class Memory : public Ep128Emu::MemoryBase {
    private:
-    uint8_t **segmentTable;
-    bool    *segmentROMTable;
     uint8_t pageTable[4];
-    uint8_t *breakPointTable;
-    size_t  breakPointCnt;
-    uint8_t **segmentBreakPointTable;
-    size_t  *segmentBreakPointCntTable;
-    bool    haveBreakPoints;
-    uint8_t breakPointPriorityThreshold;
     uint8_t *videoMemory;   // 64K for segments FC, FD, FE, and FF; always RAM
-    uint8_t *dummyMemory;   // 2*16K dummy memory for invalid reads and writes
     uint8_t *pageAddressTableR[4];
     uint8_t *pageAddressTableW[4];
 #ifdef ENABLE_SDEXT
     SDExt   *sdext;
 #endif
     void allocateSegment(uint8_t n, bool isROM);
-    void checkExecuteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
+   protected:
+    virtual void updatePaging();
    public:
     Memory();
     virtual ~Memory();
-    void setBreakPoint(uint8_t segment, uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void setBreakPoint(uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void clearBreakPoints(uint8_t segment);
-    void clearBreakPoints();
-    void clearAllBreakPoints();
-    void setBreakPointPriorityThreshold(int n);
-    int getBreakPointPriorityThreshold();
     void loadSegment(uint8_t segment, bool isROM,
                      const uint8_t *data, size_t dataSize);
     void deleteSegment(uint8_t segment);
     void deleteAllSegments();
     inline uint8_t read(uint16_t addr);
     inline uint8_t readOpcode(uint16_t addr);
+#ifdef Z80_DECODE_CACHE
+    // returns the predecoded instruction at 'addr', or zero if it cannot
+    // be cached
+    inline uint32_t readOpcodeDecoded(uint16_t addr);
+#endif
     inline uint8_t readNoDebug(uint16_t addr) const;
     inline uint8_t readRaw(uint32_t addr) const;
     inline void write(uint16_t addr, uint8_t value);
@@ -76,23 +63,18 @@ namespace Ep128 {
     void setPage(uint8_t page, uint8_t segment);
     inline uint8_t getPage(uint8_t page) const;
     inline const uint8_t * getVideoMemory() const;
-    inline bool isSegmentROM(uint8_t segment) const;
-    inline bool isSegmentRAM(uint8_t segment) const;
-    inline void * getSegmentPtr(uint8_t segment) const;
-    bool checkIgnoreBreakPoint(uint16_t addr) const;
-    Ep128Emu::BreakPointList getBreakPointList();
+    inline bool checkIgnoreBreakPoint(uint16_t addr) const;
     void saveState(Ep128Emu::File::Buffer&);
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
 #ifdef ENABLE_SDEXT
     void setSDExtPtr(SDExt *p)
     {
       sdext = p;
     }
 #endif
-   protected:
-    virtual void breakPointCallback(bool isWrite, uint16_t addr, uint8_t value);
   };
 
   // --------------------------------------------------------------------------
@@ -106,7 +88,7 @@ namespace Ep128 {
       value = sdext->readCartP3(addr);
 #endif
     if (haveBreakPoints)
-      checkReadBreakPoint(addr, page, value);
+      checkReadBreakPoint(addr, pageTable[page], value);
     return value;
   }
 
@@ -119,10 +101,22 @@ namespace Ep128 {
       value = sdext->readCartP3(addr);
 #endif
     if (haveBreakPoints)
-      checkExecuteBreakPoint(addr, page, value);
+      checkExecuteBreakPoint(addr, pageTable[page], value);
     return value;
   }
 
+#ifdef Z80_DECODE_CACHE
+  inline uint32_t Memory::readOpcodeDecoded(uint16_t addr)
+  {
+    uint8_t segment = pageTable[addr >> 14];
+#ifdef ENABLE_SDEXT
+    if (EP128EMU_UNLIKELY(sdext->isSDExtSegment(segment)))
+      return 0U;
+#endif
+    return readDecodeCache(segment, uint16_t(addr & 0x3FFF));
+  }
+
+#endif
   inline uint8_t Memory::readNoDebug(uint16_t addr) const
   {
 #ifdef ENABLE_SDEXT
@@ -134,25 +128,18 @@ namespace Ep128 {
 
   inline uint8_t Memory::readRaw(uint32_t addr) const
   {
-    uint8_t segment, value;
-
 #ifdef ENABLE_SDEXT
     if (EP128EMU_UNLIKELY(sdext->isSDExtAddress(addr)))
       return sdext->readCartP3Debug(addr);
 #endif
-    segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      value = segmentTable[segment][addr & 0x3FFF];
-    else
-      value = 0xFF;
-    return value;
+    return MemoryBase::readRaw(addr);
   }
 
   inline void Memory::write(uint16_t addr, uint8_t value)
   {
     uint8_t page = uint8_t(addr >> 14);
     if (haveBreakPoints)
-      checkWriteBreakPoint(addr, page, value);
+      checkWriteBreakPoint(addr, pageTable[page], value);
 #ifdef ENABLE_SDEXT
     if (EP128EMU_UNLIKELY(sdext->isSDExtSegment(pageTable[page]))) {
       sdext->writeCartP3(addr, value);
@@ -160,6 +147,7 @@ namespace Ep128 {
     }
 #endif
     pageAddressTableW[page][addr] = value;
+    segmentWritten(pageTable[page], addr);
   }
 
   inline void Memory::writeRaw(uint32_t addr, uint8_t value)
@@ -170,9 +158,7 @@ namespace Ep128 {
       return;
     }
 #endif
-    uint8_t segment = uint8_t(addr >> 14);
-    if (!segmentROMTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
+    MemoryBase::writeRaw(addr, value);
   }
 
   inline void Memory::writeROM(uint32_t addr, uint8_t value)
@@ -183,9 +169,7 @@ namespace Ep128 {
       return;
     }
 #endif
-    uint8_t segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
+    MemoryBase::writeROM(addr, value);
   }
 
   inline uint8_t Memory::getPage(uint8_t page) const
@@ -193,26 +177,14 @@ namespace Ep128 {
     return pageTable[page & 3];
   }
 
-  inline const uint8_t * Memory::getVideoMemory() const
-  {
-    return videoMemory;
-  }
-
-  inline bool Memory::isSegmentROM(uint8_t segment) const
+  inline bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
   {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            segmentROMTable[segment]);
+    return MemoryBase::checkIgnoreBreakPoint(addr, pageTable[addr >> 14]);
   }
 
-  inline bool Memory::isSegmentRAM(uint8_t segment) const
-  {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            !segmentROMTable[segment]);
-  }
-
-  inline void * Memory::getSegmentPtr(uint8_t segment) const
+  inline const uint8_t * Memory::getVideoMemory() const
   {
-    return (segmentTable[segment]);
+    return videoMemory;
   }
 
 
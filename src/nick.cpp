@@ -1307,5 +1307,11 @@ namespace Ep128 {
     }
   }
 
+  void Nick::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, Nick, lpb, port3Value);
+    f.copyData(lineBuf, 129 * sizeof(uint32_t));
+  }
+
 }       // namespace Ep128
 
@@ -212,6 +212,7 @@ namespace Ep128 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace Ep128
@@ -0,0 +1,150 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "ep128emu.hpp"
+#include "fileio.hpp"
+#include "system.hpp"
+#include "romcache.hpp"
+
+#include <map>
+
+namespace Ep128Emu {
+
+  // maximum number of unreferenced pages kept in the cache
+  static const size_t maxUnusedPages = 32;
+
+  struct ROMCachePage {
+    uint8_t   *data;
+    uint32_t  hashValue;
+    size_t    refCnt;
+  };
+
+  struct ROMCacheState {
+    Mutex     mutex_;
+    std::multimap< uint32_t, ROMCachePage * >       hashMap;
+    std::map< const uint8_t *, ROMCachePage * >     pageMap;
+    size_t    unusedPages;
+    ROMCacheState()
+      : unusedPages(0)
+    {
+    }
+  };
+
+  static ROMCacheState& getROMCacheState()
+  {
+    // allocated on first use and never freed, so that the cache remains
+    // valid while static objects holding ROM pages are being destroyed
+    static ROMCacheState  *state = new ROMCacheState();
+    return *state;
+  }
+
+  static void purgeUnusedPages(ROMCacheState& state)
+  {
+    std::multimap< uint32_t, ROMCachePage * >::iterator i =
+        state.hashMap.begin();
+    while (i != state.hashMap.end()) {
+      ROMCachePage  *p = (*i).second;
+      if (p->refCnt == 0) {
+        state.pageMap.erase(p->data);
+        state.hashMap.erase(i++);
+        delete[] p->data;
+        delete p;
+      }
+      else {
+        i++;
+      }
+    }
+    state.unusedPages = 0;
+  }
+
+  const uint8_t * ROMSegmentCache::acquire(const uint8_t *data)
+  {
+    ROMCacheState&  state = getROMCacheState();
+    uint32_t  h = File::hash_32(data, 16384);
+    state.mutex_.lock();
+    typedef std::multimap< uint32_t, ROMCachePage * >::iterator HashMapIter;
+    std::pair< HashMapIter, HashMapIter > r = state.hashMap.equal_range(h);
+    for (HashMapIter i = r.first; i != r.second; i++) {
+      ROMCachePage  *p = (*i).second;
+      if (std::memcmp(p->data, data, 16384) == 0) {
+        if (p->refCnt++ == 0)
+          state.unusedPages--;
+        state.mutex_.unlock();
+        return p->data;
+      }
+    }
+    ROMCachePage  *p = (ROMCachePage *) 0;
+    try {
+      p = new ROMCachePage;
+      p->data = (uint8_t *) 0;
+      p->hashValue = h;
+      p->refCnt = 1;
+      p->data = new uint8_t[16384];
+      std::memcpy(p->data, data, 16384);
+      state.pageMap.insert(std::pair< const uint8_t *, ROMCachePage * >(
+                               p->data, p));
+      try {
+        state.hashMap.insert(std::pair< uint32_t, ROMCachePage * >(h, p));
+      }
+      catch (...) {
+        state.pageMap.erase(p->data);
+        throw;
+      }
+    }
+    catch (...) {
+      if (p) {
+        if (p->data)
+          delete[] p->data;
+        delete p;
+      }
+      state.mutex_.unlock();
+      throw;
+    }
+    state.mutex_.unlock();
+    return p->data;
+  }
+
+  void ROMSegmentCache::release(const uint8_t *p)
+  {
+    if (!p)
+      return;
+    ROMCacheState&  state = getROMCacheState();
+    state.mutex_.lock();
+    std::map< const uint8_t *, ROMCachePage * >::iterator i =
+        state.pageMap.find(p);
+    if (i != state.pageMap.end() && (*i).second->refCnt > 0) {
+      if (--((*i).second->refCnt) == 0) {
+        if (++state.unusedPages > maxUnusedPages)
+          purgeUnusedPages(state);
+      }
+    }
+    state.mutex_.unlock();
+  }
+
+  size_t ROMSegmentCache::getTotalSize()
+  {
+    ROMCacheState&  state = getROMCacheState();
+    state.mutex_.lock();
+    size_t  n = state.pageMap.size() * 16384;
+    state.mutex_.unlock();
+    return n;
+  }
+
+}       // namespace Ep128Emu
+
@@ -0,0 +1,49 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef EP128EMU_ROMCACHE_HPP
+#define EP128EMU_ROMCACHE_HPP
+
+#include "ep128emu.hpp"
+
+namespace Ep128Emu {
+
+  // Process-wide cache of read-only 16K ROM segments. Identical segments
+  // loaded by any number of VM instances (or reloaded on machine reset)
+  // share a single reference counted copy, keyed by content hash.
+  // The returned pages must never be written; a memory class that needs
+  // to modify a shared segment (e.g. on writeROM()) has to make a private
+  // copy first and release the shared one.
+
+  class ROMSegmentCache {
+   public:
+    // returns a shared page with the same contents as the 16384 bytes
+    // at 'data', and increments its reference count
+    static const uint8_t * acquire(const uint8_t *data);
+    // decrements the reference count of a page returned by acquire();
+    // unused pages are kept for a while so that they can be reused
+    static void release(const uint8_t *p);
+    // returns the total number of bytes allocated for cached pages
+    static size_t getTotalSize();
+  };
+
+}       // namespace Ep128Emu
+
+#endif  // EP128EMU_ROMCACHE_HPP
+
@@ -863,5 +863,16 @@ namespace Ep128 {
     }
   }
 
+  void SDExt::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, SDExt, status, sdextAddress);
+    EP128EMU_FORK_RANGE(f, SDExt, cmd, _write_specified);
+    EP128EMU_FORK_RANGE(f, SDExt, ans_p, ans_bytes_left);
+    f.copy(writePos);
+    EP128EMU_FORK_RANGE(f, SDExt, writeState, delayCnt);
+    f.copy(flashCommand);
+    f.copyData(&(sd_ram_ext.front()), sd_ram_ext.size());
+  }
+
 }       // namespace Ep128
 
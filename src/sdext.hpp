@@ -121,6 +121,8 @@ namespace Ep128 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    // the card must be idle (getLEDState() == 0) while the state is forked
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace Ep128
@@ -87,7 +87,7 @@ namespace Ep128 {
         buf.writeByte(cmosMemory[i]);
       buf.writeBoolean(mouseEmulationEnabled);
       buf.writeByte(prvB7PortState);
-      buf.writeUInt32(mouseTimer);
+      buf.writeUInt32(getMouseTimer());
       buf.writeUInt64(mouseData);
 #ifdef ENABLE_RESID
       if (sidModel) {
@@ -169,6 +169,51 @@ namespace Ep128 {
     return isPlayingDemo;
   }
 
+  bool Ep128VM::getIsStateForkAllowed() const
+  {
+    if (isRecordingDemo || isPlayingDemo || demoFile || videoCapture)
+      return false;
+    if (haveTape() && getTapeButtonState() != 0)
+      return false;
+    if (z80.haveOpenFiles())
+      return false;
+    for (int i = 0; i < 4; i++) {
+      if (floppyDrives[i].getIsActive())
+        return false;
+    }
+    if (ideInterface->getIsActive())
+      return false;
+#ifdef ENABLE_SDEXT
+    if (sdext.getLEDState() != 0U)
+      return false;
+#endif
+#ifdef ENABLE_RESID
+    if (sidEnabled)
+      return false;
+#endif
+    return true;
+  }
+
+  void Ep128VM::forkState(Ep128Emu::StateFork& f)
+  {
+    Ep128Emu::VirtualMachine::forkState(f);
+    z80.forkState(f);
+    memory.forkState(f);
+    ioPorts.forkState(f);
+    dave.forkState(f);
+    nick.forkState(f);
+    wd177x.forkState(f);
+    EP128EMU_FORK_RANGE(f, Ep128VM, pageTable, speakerDisabled);
+    f.copy(snapshotLoadFlag);
+    EP128EMU_FORK_RANGE(f, Ep128VM, breakPointPriorityThreshold, prvRTCTime);
+    EP128EMU_FORK_RANGE(f, Ep128VM, callbacks, callbackCyclesRemaining);
+    EP128EMU_FORK_RANGE(f, Ep128VM, externalDACIOPorts, tapeSamplesRemaining);
+    EP128EMU_FORK_RANGE(f, Ep128VM, mouseEmulationEnabled, mouseWheelDelta);
+#ifdef ENABLE_SDEXT
+    sdext.forkState(f);
+#endif
+  }
+
   // --------------------------------------------------------------------------
 
   void Ep128VM::loadState(Ep128Emu::File::Buffer& buf)
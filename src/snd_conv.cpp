@@ -206,6 +206,11 @@ namespace Ep128Emu {
     dcBlock2R.setCutoffFrequency(frq2);
   }
 
+  void AudioConverter::forkState(StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, AudioConverter, dcBlock1L, eqR);
+  }
+
   void AudioConverter::setEqualizerParameters(int mode_, float freq_,
                                               float level_, float q_)
   {
@@ -308,6 +313,12 @@ namespace Ep128Emu {
     downsampleRatio = inputSampleRate / outputSampleRate;
   }
 
+  void AudioConverterLowQuality::forkState(StateFork& f)
+  {
+    AudioConverter::forkState(f);
+    EP128EMU_FORK_RANGE(f, AudioConverterLowQuality, prvInputL, outRight);
+  }
+
   inline void AudioConverterHighQuality::ResampleWindow::processSample(
       float inL, float inR, float *outBufL, float *outBufR,
       int outBufSize, float bufPos)
@@ -447,5 +458,11 @@ namespace Ep128Emu {
     resampleRatio = outputSampleRate / inputSampleRate;
   }
 
+  void AudioConverterHighQuality::forkState(StateFork& f)
+  {
+    AudioConverter::forkState(f);
+    EP128EMU_FORK_RANGE(f, AudioConverterHighQuality, bufL, nxtPos);
+  }
+
 }       // namespace Ep128Emu
 
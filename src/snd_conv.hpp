@@ -67,6 +67,8 @@ namespace Ep128Emu {
     void setDCBlockFilters(float frq1, float frq2);
     void setEqualizerParameters(int mode_, float freq_, float level_, float q_);
     void setOutputVolume(float ampScale_);
+    // save or restore the filter state for run-ahead
+    virtual void forkState(StateFork& f);
    protected:
     virtual void audioOutput(int16_t left, int16_t right) = 0;
     inline void sendOutputSignal(float left, float right);
@@ -90,6 +92,7 @@ namespace Ep128Emu {
     virtual void sendMonoInputSignal(int32_t audioInput);
     virtual void setInputSampleRate(float sampleRate_);
     virtual void setOutputSampleRate(float sampleRate_);
+    virtual void forkState(StateFork& f);
   };
 
   class AudioConverterHighQuality : public AudioConverter {
@@ -126,6 +129,7 @@ namespace Ep128Emu {
     virtual void sendMonoInputSignal(int32_t audioInput);
     virtual void setInputSampleRate(float sampleRate_);
     virtual void setOutputSampleRate(float sampleRate_);
+    virtual void forkState(StateFork& f);
   };
 
 }       // namespace Ep128Emu
@@ -75,7 +75,10 @@ namespace Ep128Emu {
      */
     virtual void sendAudioData(const int16_t *buf, size_t nFrames);
 #ifdef EP128EMU_LIBRETRO_CORE
-    virtual void forwardAudioData(int16_t *buf_out, size_t* nFrames, int expectedFrames)=0;
+    // copy about 'expectedFrames' sample frames to 'buf_out' for the
+    // frontend, or all available ones if 'expectedFrames' is negative;
+    // the fractional part is carried over to the next call
+    virtual void forwardAudioData(int16_t *buf_out, size_t* nFrames, double expectedFrames)=0;
 #endif
     /*!
      * Close the audio device.
@@ -0,0 +1,90 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "ep128emu.hpp"
+#include "statefork.hpp"
+
+#include <cstring>
+
+namespace Ep128Emu {
+
+  StateFork::StateFork()
+    : bufPos(0),
+      restoreFlag(false)
+  {
+  }
+
+  StateFork::~StateFork()
+  {
+  }
+
+  void StateFork::beginSave()
+  {
+    bufPos = 0;
+    restoreFlag = false;
+  }
+
+  void StateFork::beginRestore()
+  {
+    bufPos = 0;
+    restoreFlag = true;
+  }
+
+  void StateFork::copyData(void *p, size_t nBytes)
+  {
+    if (!restoreFlag) {
+      if ((bufPos + nBytes) > buf.size())
+        buf.resize(bufPos + nBytes);
+      std::memcpy(&(buf[bufPos]), p, nBytes);
+    }
+    else {
+      if ((bufPos + nBytes) > buf.size())
+        throw Exception("internal error: state fork data is too short");
+      std::memcpy(p, &(buf[bufPos]), nBytes);
+    }
+    bufPos += nBytes;
+  }
+
+  void StateFork::copySegment(uint8_t *p, bool& dirtyFlag, size_t nBytes)
+  {
+    if (!restoreFlag) {
+      if ((bufPos + nBytes) > buf.size()) {
+        buf.resize(bufPos + nBytes);
+        dirtyFlag = true;
+      }
+      if (dirtyFlag)
+        std::memcpy(&(buf[bufPos]), p, nBytes);
+    }
+    else {
+      if ((bufPos + nBytes) > buf.size())
+        throw Exception("internal error: state fork data is too short");
+      if (dirtyFlag)
+        std::memcpy(p, &(buf[bufPos]), nBytes);
+    }
+    dirtyFlag = false;
+    bufPos += nBytes;
+  }
+
+  size_t StateFork::getMemoryUsage() const
+  {
+    return buf.capacity();
+  }
+
+}       // namespace Ep128Emu
+
@@ -0,0 +1,116 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef EP128EMU_STATEFORK_HPP
+#define EP128EMU_STATEFORK_HPP
+
+#include "ep128emu.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Ep128Emu {
+
+  // In-memory copy of the state of an emulated machine, used for running
+  // the emulation ahead and then rewinding it. Unlike snapshots, the data
+  // is not portable, and can only be restored to the same objects it was
+  // saved from, with no configuration changes in between.
+  // The same forkState() function of a device is used for both saving and
+  // restoring the state: copy() stores the variable if isRestoring() is
+  // false, and overwrites it with the stored value otherwise. Only plain
+  // data can be copied this way; pointers are allowed if they point to
+  // memory that is not reallocated while the emulation is running.
+
+  class StateFork {
+   private:
+    std::vector< uint8_t >  buf;
+    size_t    bufPos;
+    bool      restoreFlag;
+   public:
+    StateFork();
+    virtual ~StateFork();
+    // start saving the state; the buffer is reused between calls
+    void beginSave();
+    // start restoring the state saved previously
+    void beginRestore();
+    inline bool isRestoring() const
+    {
+      return restoreFlag;
+    }
+    void copyData(void *p, size_t nBytes);
+    template <typename T>
+    EP128EMU_INLINE void copy(T& x)
+    {
+      copyData(&x, sizeof(T));
+    }
+    // copies all members of a class from 'first' to 'last' (inclusive),
+    // which must be declared in this order in the same access section;
+    // use EP128EMU_FORK_RANGE() to check this at compile time
+    template <typename T1, typename T2>
+    EP128EMU_INLINE void copyRange(T1& first, T2& last)
+    {
+      copyData(&first, size_t(reinterpret_cast< char * >(&last + 1)
+                              - reinterpret_cast< char * >(&first)));
+    }
+    // copies a RAM segment of 'nBytes' bytes if 'dirtyFlag' is true, that
+    // is, if the segment has been written since it was last saved or
+    // restored, and then clears the flag; the segment must only be written
+    // by functions that set the flag (see MemoryBase::forkSegments())
+    void copySegment(uint8_t *p, bool& dirtyFlag, size_t nBytes = 16384);
+    // returns the number of bytes allocated for the stored state
+    size_t getMemoryUsage() const;
+  };
+
+}       // namespace Ep128Emu
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ < 5)
+#  define EP128EMU_FORK_IS_PLAIN_DATA(x)                                \
+     __has_trivial_copy(decltype(x))
+#else
+#  define EP128EMU_FORK_IS_PLAIN_DATA(x)                                \
+     std::is_trivially_copyable< decltype(x) >::value
+#endif
+#ifdef __GNUC__
+#  define EP128EMU_FORK_OFFSETOF_BEGIN                                  \
+     _Pragma("GCC diagnostic push")                                     \
+     _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+#  define EP128EMU_FORK_OFFSETOF_END    _Pragma("GCC diagnostic pop")
+#else
+#  define EP128EMU_FORK_OFFSETOF_BEGIN
+#  define EP128EMU_FORK_OFFSETOF_END
+#endif
+
+// f.copyRange(first, last) in a member function of class T, with compile
+// time checks for the order of the members and the type of the first and
+// last one (the members in between are not checked)
+#define EP128EMU_FORK_RANGE(f, T, first, last)                          \
+  do {                                                                  \
+    EP128EMU_FORK_OFFSETOF_BEGIN                                        \
+    static_assert(offsetof(T, first) <= offsetof(T, last),              \
+                  #T "::" #first " must be declared before " #last);    \
+    EP128EMU_FORK_OFFSETOF_END                                          \
+    static_assert(EP128EMU_FORK_IS_PLAIN_DATA(T::first) &&              \
+                  EP128EMU_FORK_IS_PLAIN_DATA(T::last),                 \
+                  #T "::" #first " and " #last " must be plain data");  \
+    (f).copyRange(first, last);                                         \
+  } while (false)
+
+#endif  // EP128EMU_STATEFORK_HPP
+
@@ -38,6 +38,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fstream>
+#include <map>
+#include <vector>
 
 namespace Ep128Emu {
 
@@ -171,9 +173,20 @@ namespace Ep128Emu {
 #endif
 
   Thread::Thread()
+    : Thread(true)
+  {
+  }
+
+  Thread::Thread(bool createThread_)
     : threadLock_(false),
-      isJoined_(false)
+      isJoined_(!createThread_)
   {
+    if (!createThread_) {
+#ifdef WIN32
+      thread_ = (HANDLE) 0;
+#endif
+      return;
+    }
 #ifdef WIN32
     thread_ = (HANDLE) _beginthreadex(NULL, 0U,
                                       &Thread::threadRoutine_, this, 0U, NULL);
@@ -257,6 +270,8 @@ namespace Ep128Emu {
     return (*this);
   }
 
+  uint64_t Timer::fixedRandomSeed = 0U;
+
   uint64_t Timer::getRealTime_()
   {
 #ifdef WIN32
@@ -316,7 +331,11 @@ namespace Ep128Emu {
 
   uint32_t Timer::getRandomSeedFromTime()
   {
-    uint32_t  tmp1 = uint32_t(getRealTime_() & 0xFFFFFFFFUL);
+    uint32_t  tmp1;
+    if (EP128EMU_UNLIKELY(fixedRandomSeed != 0U))
+      tmp1 = uint32_t(fixedRandomSeed++ & 0xFFFFFFFFUL);
+    else
+      tmp1 = uint32_t(getRealTime_() & 0xFFFFFFFFUL);
     uint64_t  tmp2 = tmp1 * uint64_t(0xC2B0C3CCUL);
     tmp1 = ((uint32_t(tmp2) ^ uint32_t(tmp2 >> 32)) & uint32_t(0xFFFFFFFFUL));
     tmp2 = tmp1 * uint64_t(0xC2B0C3CCUL);
@@ -324,6 +343,11 @@ namespace Ep128Emu {
     return tmp1;
   }
 
+  void Timer::setFixedRandomSeed(uint32_t seed)
+  {
+    fixedRandomSeed = seed;
+  }
+
   // --------------------------------------------------------------------------
 
   void stripString(std::string& s)
@@ -527,6 +551,94 @@ namespace Ep128Emu {
 #endif
   }
 
+  struct MemoryFile {
+    std::vector< uint8_t >  data;
+    size_t    refCnt;
+  };
+
+  struct MemoryFileState {
+    Mutex     mutex_;
+    std::map< std::string, MemoryFile >  files;
+  };
+
+  static MemoryFileState& getMemoryFileState()
+  {
+    static MemoryFileState  *state = new MemoryFileState();
+    return *state;
+  }
+
+  void registerMemoryFile(const char *fileName,
+                          const void *data, size_t nBytes)
+  {
+    if (fileName == (char *) 0 || fileName[0] == '\0')
+      throw Exception("invalid memory file name");
+    MemoryFileState&  state = getMemoryFileState();
+    state.mutex_.lock();
+    try {
+      MemoryFile& f = state.files[std::string(fileName)];
+      // streams may still be open on the data of an earlier registration
+      // of the same name, so it is kept, and only freed when the last
+      // registration is removed
+      if (f.refCnt == 0) {
+        f.data.assign(reinterpret_cast< const uint8_t * >(data),
+                      reinterpret_cast< const uint8_t * >(data) + nBytes);
+      }
+      f.refCnt++;
+    }
+    catch (...) {
+      std::map< std::string, MemoryFile >::iterator i =
+          state.files.find(std::string(fileName));
+      if (i != state.files.end() && (*i).second.refCnt == 0)
+        state.files.erase(i);
+      state.mutex_.unlock();
+      throw;
+    }
+    state.mutex_.unlock();
+  }
+
+  void unregisterMemoryFile(const char *fileName)
+  {
+    if (fileName == (char *) 0 || fileName[0] == '\0')
+      return;
+    MemoryFileState&  state = getMemoryFileState();
+    state.mutex_.lock();
+    std::map< std::string, MemoryFile >::iterator i =
+        state.files.find(std::string(fileName));
+    if (i != state.files.end()) {
+      if (--((*i).second.refCnt) == 0)
+        state.files.erase(i);
+    }
+    state.mutex_.unlock();
+  }
+
+  std::FILE *openMemoryFile(const char *fileName, const char *mode)
+  {
+    if (fileName == (char *) 0 || fileName[0] == '\0' ||
+        mode == (char *) 0 || mode[0] != 'r') {
+      return (std::FILE *) 0;
+    }
+    for (size_t i = 1; mode[i] != '\0'; i++) {
+      if (mode[i] != 'b')
+        return (std::FILE *) 0;
+    }
+    MemoryFileState&  state = getMemoryFileState();
+    std::FILE *f = (std::FILE *) 0;
+    state.mutex_.lock();
+    if (!state.files.empty()) {
+      std::map< std::string, MemoryFile >::iterator i =
+          state.files.find(std::string(fileName));
+      if (i != state.files.end() && (*i).second.data.size() > 0) {
+#ifndef WIN32
+        // the data is not freed until the file is unregistered
+        f = fmemopen(&((*i).second.data.front()), (*i).second.data.size(),
+                     "rb");
+#endif
+      }
+    }
+    state.mutex_.unlock();
+    return f;
+  }
+
   bool does_file_exist(const char *fileName)
   {
     std::ifstream infile(fileName);
@@ -645,6 +757,9 @@ namespace Ep128Emu {
   // fopen() wrapper with support for UTF-8 encoded file names
   std::FILE *fileOpen(const char *fileName, const char *mode)
   {
+    std::FILE *f = openMemoryFile(fileName, mode);
+    if (f)
+      return f;
     wchar_t tmpBuf1[480];
     wchar_t tmpBuf2[32];
     wchar_t *fileName_ = &(tmpBuf1[0]);
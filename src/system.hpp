@@ -93,6 +93,12 @@ namespace Ep128Emu {
     }
    public:
     Thread();
+    /*!
+     * If 'createThread_' is false, no child thread is created: run() is
+     * never called, and join() returns immediately. This allows classes
+     * derived from Thread to be used without a thread of their own.
+     */
+    Thread(bool createThread_);
     virtual ~Thread();
     /*!
      * Signal the child thread, allowing it to execute run() after the thread
@@ -148,6 +154,7 @@ namespace Ep128Emu {
     uint64_t  startTime;
     double    secondsPerTick;
     static uint64_t getRealTime_();
+    static uint64_t fixedRandomSeed;
    public:
     Timer();
     ~Timer();
@@ -156,6 +163,9 @@ namespace Ep128Emu {
     void reset(double t);
     static void wait(double t);
     static uint32_t getRandomSeedFromTime();
+    // if 'seed' is non-zero, getRandomSeedFromTime() will return a
+    // reproducible sequence of values derived from it instead of the time
+    static void setFixedRandomSeed(uint32_t seed);
   };
 
   /*!
@@ -212,9 +222,36 @@ namespace Ep128Emu {
    */
   void addFileNameExtension(std::string& fileName, const char *s);
 
+  /*!
+   * Register 'nBytes' of data at 'data' as the contents of the read-only
+   * file 'fileName', e.g. content that the frontend has already loaded to
+   * memory. A copy of the data is made. Opening 'fileName' with fileOpen()
+   * in "r" or "rb" mode returns a stream reading from memory instead of the
+   * file system; other modes are not affected. Registering a name that is
+   * already registered only increments its reference count, the data of
+   * the first registration is kept, as streams may be open on it.
+   */
+  void registerMemoryFile(const char *fileName,
+                          const void *data, size_t nBytes);
+  /*!
+   * Decrement the reference count of memory file 'fileName', and remove it
+   * if no longer used. All streams opened from the file must have been
+   * closed by then.
+   */
+  void unregisterMemoryFile(const char *fileName);
+  /*!
+   * Open memory file 'fileName' for reading, or return NULL if there is no
+   * such file, 'mode' is not read-only, or memory streams are not supported
+   * on this platform.
+   */
+  std::FILE *openMemoryFile(const char *fileName, const char *mode);
+
 #ifndef WIN32
   EP128EMU_INLINE std::FILE *fileOpen(const char *fileName, const char *mode)
   {
+    std::FILE *f = openMemoryFile(fileName, mode);
+    if (f)
+      return f;
     return std::fopen(fileName, mode);
   }
   EP128EMU_INLINE int fileRemove(const char *fileName)
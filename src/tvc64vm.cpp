@@ -108,6 +108,23 @@ namespace TVC64 {
     updateCPUHalfCycles(4);
   }
 
+  EP128EMU_INLINE bool TVC64VM::runHaltCycle()
+  {
+    // repeat the HALT opcode fetch with the same timing as
+    // Z80_::readOpcodeFirstByte(), but without reading and decoding the
+    // opcode, unless breakpoints, single step mode or an extension (which
+    // may have side effects on reads) need the read
+    uint16_t  addr = uint16_t(z80.getReg().PC.W.l);
+    if (singleStepMode || memory.getHaveBreakPoints() ||
+        memory.isExtensionAddress(addr)) {
+      return false;
+    }
+    memoryWaitM1(addr);
+    updateCPUHalfCycles(4);
+    z80.executeHaltCycle();
+    return true;
+  }
+
   EP128EMU_INLINE void TVC64VM::ioPortWait(uint16_t addr)
   {
     updateCPUHalfCycles(6);
@@ -154,12 +171,8 @@ namespace TVC64 {
             updateSndIntState(cursorState);
         }
       }
-      TVC64VMCallback *p = firstCallback;
-      while (EP128EMU_UNLIKELY(bool(p))) {
-        TVC64VMCallback *nxt = p->nxt;
-        p->func(p->userData);
-        p = nxt;
-      }
+      if (EP128EMU_UNLIKELY(!(--callbackCyclesRemaining)))
+        runCallbacks();
       m++;
       if (EP128EMU_UNLIKELY(!(m & 3))) {
         uint32_t  tmp = uint32_t(tapeInputSignal + tapeOutputSignal) << 12;
@@ -279,6 +292,30 @@ namespace TVC64 {
     return retval;
   }
 
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_REGPARM1 uint32_t TVC64VM::Z80_::readOpcodeFirstByteDecoded()
+  {
+    // readOpcodeFirstByte(), followed by the memory timing of the operand
+    // reads that the predecoded instruction already includes
+    uint16_t  addr = uint16_t(R.PC.W.l);
+    uint32_t  retval = 0U;
+    if (EP128EMU_EXPECT(!(vm.singleStepMode ||
+                          vm.memory.getHaveBreakPoints()))) {
+      retval = vm.memory.readOpcodeDecoded(addr);
+    }
+    if (EP128EMU_UNLIKELY(!retval))
+      return (Z80_PREDECODED_VALID | uint32_t(Z80_::readOpcodeFirstByte()));
+    vm.memoryWaitM1(addr);
+    vm.updateCPUHalfCycles(4);
+    for (uint32_t n = (retval >> 24) & 3U; n; n--) {
+      addr = (addr + 1) & 0xFFFF;
+      vm.memoryWait(addr);
+      vm.updateCPUHalfCycles(1);
+    }
+    return retval;
+  }
+#endif
+
   EP128EMU_REGPARM3 void TVC64VM::Z80_::writeMemory(uint16_t addr,
                                                     uint8_t value)
   {
@@ -1060,7 +1097,7 @@ namespace TVC64 {
     vm.videoRenderer.crtcVSyncStateChange(newState);
   }
 
-  void TVC64VM::tapeCallback(void *userData)
+  uint32_t TVC64VM::tapeCallback(void *userData)
   {
     TVC64VM&  vm = *(reinterpret_cast<TVC64VM *>(userData));
     vm.tapeSamplesRemaining += vm.tapeSamplesPerCRTCCycle;
@@ -1069,9 +1106,21 @@ namespace TVC64 {
       vm.tapeSamplesRemaining -= (int64_t(1) << 32);
       vm.tapeInputSignal = uint8_t(vm.runTape(vm.tapeOutputSignal));
     }
+    // number of cycles until the next sample
+    uint32_t  n = 0x40000000U;
+    if (vm.tapeSamplesRemaining >= 0) {
+      n = 1U;
+    }
+    else if (vm.tapeSamplesPerCRTCCycle > 0) {
+      int64_t tmp = (vm.tapeSamplesPerCRTCCycle - 1 - vm.tapeSamplesRemaining)
+                    / vm.tapeSamplesPerCRTCCycle;
+      n = uint32_t(tmp < 0x40000000 ? tmp : 0x40000000);
+    }
+    vm.tapeSamplesRemaining += (int64_t(n - 1U) * vm.tapeSamplesPerCRTCCycle);
+    return n;
   }
 
-  void TVC64VM::demoPlayCallback(void *userData)
+  uint32_t TVC64VM::demoPlayCallback(void *userData)
   {
     TVC64VM&  vm = *(reinterpret_cast<TVC64VM *>(userData));
     while (!vm.demoTimeCnt) {
@@ -1113,20 +1162,25 @@ namespace TVC64 {
         break;
       }
     }
-    if (vm.demoTimeCnt)
-      vm.demoTimeCnt--;
+    // wait until the next event
+    uint32_t  n = uint32_t(vm.demoTimeCnt < 0x40000000U ?
+                           vm.demoTimeCnt : 0x40000000U);
+    vm.demoTimeCnt -= n;
+    return (n > 0U ? n : 1U);
   }
 
-  void TVC64VM::demoRecordCallback(void *userData)
+  uint32_t TVC64VM::demoRecordCallback(void *userData)
   {
     TVC64VM&  vm = *(reinterpret_cast<TVC64VM *>(userData));
     vm.demoTimeCnt++;
+    return 1U;
   }
 
-  void TVC64VM::videoCaptureCallback(void *userData)
+  uint32_t TVC64VM::videoCaptureCallback(void *userData)
   {
     TVC64VM&  vm = *(reinterpret_cast<TVC64VM *>(userData));
     vm.videoCapture->runOneCycle(vm.soundOutputSignal);
+    return 1U;
   }
 
   uint8_t TVC64VM::checkSingleStepModeBreak()
@@ -1234,8 +1288,8 @@ namespace TVC64 {
     }
   }
 
-  void TVC64VM::setCallback(void (*func)(void *userData), void *userData_,
-                            bool isEnabled)
+  void TVC64VM::setCallback(uint32_t (*func)(void *userData),
+                            void *userData_, bool isEnabled)
   {
     if (!func)
       return;
@@ -1262,7 +1316,7 @@ namespace TVC64 {
         p = p->nxt;
       }
       if (!isEnabled) {
-        callbacks[ndx].func = (void (*)(void *)) 0;
+        callbacks[ndx].func = (uint32_t (*)(void *)) 0;
         callbacks[ndx].userData = (void *) 0;
         callbacks[ndx].nxt = (TVC64VMCallback *) 0;
       }
@@ -1271,7 +1325,7 @@ namespace TVC64 {
       return;
     if (ndx < 0) {
       for (size_t i = 0; i < maxCallbacks; i++) {
-        if (callbacks[i].func == (void (*)(void *)) 0) {
+        if (callbacks[i].func == (uint32_t (*)(void *)) 0) {
           ndx = int(i);
           break;
         }
@@ -1282,6 +1336,12 @@ namespace TVC64 {
     callbacks[ndx].func = func;
     callbacks[ndx].userData = userData_;
     callbacks[ndx].nxt = (TVC64VMCallback *) 0;
+    // schedule the function for the next cycle
+    callbacks[ndx].delay = (callbackCycles - callbackCyclesRemaining) + 1U;
+    if (callbackCyclesRemaining > 1U) {
+      callbackCycles = callbackCycles - callbackCyclesRemaining + 1U;
+      callbackCyclesRemaining = 1U;
+    }
     if (isEnabled) {
       TVC64VMCallback   *prv = (TVC64VMCallback *) 0;
       TVC64VMCallback   *p = firstCallback;
@@ -1297,6 +1357,30 @@ namespace TVC64 {
     }
   }
 
+  void TVC64VM::runCallbacks()
+  {
+    // make the delays relative to the current cycle
+    TVC64VMCallback   *p = firstCallback;
+    while (p) {
+      p->delay -= callbackCycles;
+      p = p->nxt;
+    }
+    callbackCycles = 0U;
+    callbackCyclesRemaining = 0U;
+    p = firstCallback;
+    while (p) {
+      TVC64VMCallback *nxt = p->nxt;
+      if (!p->delay)
+        p->delay = p->func(p->userData);
+      p = nxt;
+    }
+    uint32_t  n = 0x40000000U;
+    for (p = firstCallback; p; p = p->nxt)
+      n = (p->delay < n ? p->delay : n);
+    callbackCycles = n;
+    callbackCyclesRemaining = n;
+  }
+
   // --------------------------------------------------------------------------
 
   TVC64VM::TVC64VM(Ep128Emu::VideoDisplay& display_,
@@ -1337,6 +1421,8 @@ namespace TVC64 {
       vtdosROMPage(0),
       breakPointPriorityThreshold(0),
       firstCallback((TVC64VMCallback *) 0),
+      callbackCycles(1U),
+      callbackCyclesRemaining(1U),
       videoCapture((Ep128Emu::VideoCapture *) 0),
       tapeSamplesPerCRTCCycle(0L),
       tapeSamplesRemaining(-1L),
@@ -1345,9 +1431,10 @@ namespace TVC64 {
     for (size_t i = 0;
          i < (sizeof(callbacks) / sizeof(TVC64VMCallback));
          i++) {
-      callbacks[i].func = (void (*)(void *)) 0;
+      callbacks[i].func = (uint32_t (*)(void *)) 0;
       callbacks[i].userData = (void *) 0;
       callbacks[i].nxt = (TVC64VMCallback *) 0;
+      callbacks[i].delay = 0U;
     }
     // register I/O callbacks
     ioPorts.setReadCallback(
@@ -1416,7 +1503,10 @@ namespace TVC64 {
     crtcCyclesRemainingH = int32_t(crtcCyclesRemaining >> 32);
     z80.triggerInterrupt();
     while (EP128EMU_EXPECT(crtcCyclesRemainingH > 0)) {
-      z80.executeInstruction();
+      // while the CPU is waiting for an interrupt in HALT, only the timing
+      // of the repeated opcode fetches needs to be emulated
+      if (EP128EMU_EXPECT(!z80.isExecutingHalt()) || !runHaltCycle())
+        z80.executeInstruction();
       if ((z80HalfCycleCnt - machineHalfCycleCnt) & 0xFE)
         runDevices();
     }
@@ -1845,6 +1935,18 @@ namespace TVC64 {
     return nullptr;
   }
 
+  void TVC64VM::getMemoryUsage(MemoryUsage& memoryUsage_) const
+  {
+    memory.getMemoryUsage(memoryUsage_.ramSize, memoryUsage_.romSize,
+                          memoryUsage_.sharedROMSize, memoryUsage_.tableSize);
+    memoryUsage_.machineSize = sizeof(TVC64VM);
+  }
+
+  uint64_t TVC64VM::getInstructionCount() const
+  {
+    return z80.getInstructionCount();
+  }
+
   uint8_t TVC64VM::readMemory(uint32_t addr, bool isCPUAddress) const
   {
     if (isCPUAddress)
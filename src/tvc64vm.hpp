@@ -62,6 +62,9 @@ namespace TVC64 {
                                            (bool *) 0);
       virtual EP128EMU_REGPARM2 uint8_t readOpcodeByte(int offset);
       virtual EP128EMU_REGPARM2 uint16_t readOpcodeWord(int offset);
+#ifdef Z80_DECODE_CACHE
+      virtual EP128EMU_REGPARM1 uint32_t readOpcodeFirstByteDecoded();
+#endif
       virtual EP128EMU_REGPARM3 void writeMemory(uint16_t addr, uint8_t value);
       virtual EP128EMU_REGPARM3 void writeMemoryWord(uint16_t addr,
                                                      uint16_t value);
@@ -73,6 +76,10 @@ namespace TVC64 {
       virtual EP128EMU_REGPARM1 void tapePatch();
      public:
       void closeFile();
+      inline bool haveOpenFile() const
+      {
+        return (fileIOFile != (std::FILE *) 0);
+      }
     };
     class Memory_ : public Memory {
      private:
@@ -169,12 +176,15 @@ namespace TVC64 {
     uint8_t   vtdosROMPage;             // 0 to 3
     uint8_t   breakPointPriorityThreshold;
     struct TVC64VMCallback {
-      void      (*func)(void *);
+      uint32_t  (*func)(void *);
       void      *userData;
       TVC64VMCallback  *nxt;
+      uint32_t  delay;
     };
     TVC64VMCallback  callbacks[16];
     TVC64VMCallback  *firstCallback;
+    uint32_t  callbackCycles;           // length of the current wait
+    uint32_t  callbackCyclesRemaining;  // until the next callback is due
     Ep128Emu::VideoCapture  *videoCapture;
     int64_t   tapeSamplesPerCRTCCycle;
     int64_t   tapeSamplesRemaining;
@@ -191,6 +201,9 @@ namespace TVC64 {
     EP128EMU_INLINE void memoryWaitM1(uint16_t addr);
     EP128EMU_INLINE void ioPortWait(uint16_t addr);
     EP128EMU_INLINE void updateSndIntState(bool cursorState);
+    // runs one cycle of a CPU executing HALT without decoding the opcode,
+    // returns false if the instruction needs to be executed normally
+    EP128EMU_INLINE bool runHaltCycle();
     EP128EMU_REGPARM1 void runDevices();
     static uint8_t ioPortReadCallback(void *userData, uint16_t addr);
     static void ioPortWriteCallback(void *userData,
@@ -200,20 +213,24 @@ namespace TVC64 {
                                                            bool newState);
     static EP128EMU_REGPARM2 void vSyncStateChangeCallback(void *userData,
                                                            bool newState);
-    static void tapeCallback(void *userData);
-    static void demoPlayCallback(void *userData);
-    static void demoRecordCallback(void *userData);
-    static void videoCaptureCallback(void *userData);
+    static uint32_t tapeCallback(void *userData);
+    static uint32_t demoPlayCallback(void *userData);
+    static uint32_t demoRecordCallback(void *userData);
+    static uint32_t videoCaptureCallback(void *userData);
     void stopDemoPlayback();
     void stopDemoRecording(bool writeFile_);
     uint8_t checkSingleStepModeBreak();
     void convertKeyboardState();
     void resetKeyboard();
     void resetFloppyDrives(bool isColdReset);
-    // Set function to be called at every CRTC cycle. The functions are called
-    // in the order of being registered; up to 16 callbacks can be set.
-    void setCallback(void (*func)(void *userData), void *userData_,
+    // Set function to be called at the next CRTC cycle. The function returns
+    // the number of cycles (>= 1) until it is to be called again. Functions
+    // that are due in the same cycle are called in the order of being
+    // registered; up to 16 callbacks can be set.
+    void setCallback(uint32_t (*func)(void *userData), void *userData_,
                      bool isEnabled);
+    // Call the functions that are due, and schedule the next call.
+    void runCallbacks();
    public:
     TVC64VM(Ep128Emu::VideoDisplay&, Ep128Emu::AudioOutput&);
     virtual ~TVC64VM();
@@ -381,6 +398,11 @@ namespace TVC64 {
      * Returns a memory pointer to page 'n' (0x00 to 0xFF).
      */
     virtual void * getSegmentPtr(int n) const;
+    /*!
+     * Returns the number of bytes allocated by the emulated machine.
+     */
+    virtual void getMemoryUsage(MemoryUsage& memoryUsage_) const;
+    virtual uint64_t getInstructionCount() const;
     /*!
      * Read a byte from memory. If 'isCPUAddress' is false, bits 14 to 21 of
      * 'addr' define the segment number, while bits 0 to 13 are the offset
@@ -515,6 +537,16 @@ namespace TVC64 {
      * playing a demo.
      */
     virtual bool getIsPlayingDemo() const;
+    /*!
+     * Returns true if the state can be saved with forkState(); this is false
+     * while tape, disk or file I/O, demo recording or playback, or video
+     * capture is in progress.
+     */
+    virtual bool getIsStateForkAllowed() const;
+    /*!
+     * Save or restore the state of the emulated machine for run-ahead.
+     */
+    virtual void forkState(Ep128Emu::StateFork& f);
     // ----------------
     virtual void loadState(Ep128Emu::File::Buffer&);
     virtual void loadMachineConfiguration(Ep128Emu::File::Buffer&);
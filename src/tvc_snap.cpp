@@ -121,6 +121,45 @@ namespace TVC64 {
     return isPlayingDemo;
   }
 
+  bool TVC64VM::getIsStateForkAllowed() const
+  {
+    if (isRecordingDemo || isPlayingDemo || demoFile || videoCapture)
+      return false;
+    if (haveTape() && getTapeButtonState() != 0)
+      return false;
+    if (z80.haveOpenFile())
+      return false;
+    for (int i = 0; i < 4; i++) {
+      if (floppyDrives[i].getIsActive())
+        return false;
+    }
+#ifdef ENABLE_SDEXT
+    if (sdext.getLEDState() != 0U)
+      return false;
+#endif
+    return true;
+  }
+
+  void TVC64VM::forkState(Ep128Emu::StateFork& f)
+  {
+    Ep128Emu::VirtualMachine::forkState(f);
+    z80.forkState(f);
+    memory.forkState(f);
+    ioPorts.forkState(f);
+    crtc.forkState(f);
+    videoRenderer.forkState(f);
+    wd177x.forkState(f);
+    EP128EMU_FORK_RANGE(f, TVC64VM, crtcCyclesRemainingL, soundOutputSignal);
+    f.copy(snapshotLoadFlag);
+    f.copy(vtdosROMPage);
+    EP128EMU_FORK_RANGE(f, TVC64VM, callbacks, callbackCyclesRemaining);
+    f.copy(tapeSamplesRemaining);
+    EP128EMU_FORK_RANGE(f, TVC64VM, keyboardState, tvcKeyboardState);
+#ifdef ENABLE_SDEXT
+    sdext.forkState(f);
+#endif
+  }
+
   // --------------------------------------------------------------------------
 
   void TVC64VM::loadState(Ep128Emu::File::Buffer& buf)
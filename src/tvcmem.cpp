@@ -28,78 +28,15 @@ namespace TVC64 {
       throw Ep128Emu::Exception("video memory cannot be ROM");
     if (n > 0x04 && n < 0xF8)
       throw Ep128Emu::Exception("invalid segment number");
-    if (segmentTable[n] == (uint8_t *) 0)
-      segmentTable[n] = new uint8_t[16384];
-    segmentROMTable[n] = isROM;
-    setPaging(currentPaging);
-  }
-
-  void Memory::checkExecuteBreakPoint(uint16_t addr, uint8_t page,
-                                      uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 36) == 4) {
-      breakPointCallback(false, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page >> 1]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 36) == 4) {
-        breakPointCallback(false, addr, value);
-      }
-    }
-  }
-
-  void Memory::checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 1) != 0) {
-      breakPointCallback(false, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page >> 1]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 1) != 0) {
-        breakPointCallback(false, addr, value);
-      }
-    }
-  }
-
-  void Memory::checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 2) != 0) {
-      breakPointCallback(true, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page >> 1]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 2) != 0) {
-        breakPointCallback(true, addr, value);
-      }
-    }
+    MemoryBase::allocateSegment(n, isROM);
   }
 
   Memory::Memory()
-    : segmentTable((uint8_t **) 0),
-      segmentROMTable((bool *) 0),
+    : Ep128Emu::MemoryBase(),
       currentPaging(0x3F00),
       totalRAMSegments(5),
       segment1IsExtension(false),
-      breakPointTable((uint8_t *) 0),
-      breakPointCnt(0),
-      segmentBreakPointTable((uint8_t **) 0),
-      segmentBreakPointCntTable((size_t *) 0),
-      haveBreakPoints(false),
-      breakPointPriorityThreshold(0),
-      videoMemory((uint8_t *) 0),
-      dummyMemory((uint8_t *) 0)
+      videoMemory((uint8_t *) 0)
   {
     for (int i = 0; i < 4; i++)
       pageTable[i] = 0x00;
@@ -107,173 +44,22 @@ namespace TVC64 {
       pageAddressTableR[i] = (uint8_t *) 0;
       pageAddressTableW[i] = (uint8_t *) 0;
     }
-    try {
-      segmentTable = new uint8_t*[256];
-      for (int i = 0; i < 256; i++)
-        segmentTable[i] = (uint8_t *) 0;
-      segmentROMTable = new bool[256];
-      for (int i = 0; i < 256; i++)
-        segmentROMTable[i] = true;
-      segmentBreakPointTable = new uint8_t*[256];
-      for (int i = 0; i < 256; i++)
-        segmentBreakPointTable[i] = (uint8_t *) 0;
-      segmentBreakPointCntTable = new size_t[256];
-      for (int i = 0; i < 256; i++)
-        segmentBreakPointCntTable[i] = 0;
-      videoMemory = new uint8_t[65536];
-      for (int i = 0; i < 65536; i++)
-        videoMemory[i] = 0xFF;
-      for (int i = 0xFC; i <= 0xFF; i++) {
-        segmentTable[i] = &(videoMemory[(i & 3) << 14]);
-        segmentROMTable[i] = false;
-      }
-      dummyMemory = new uint8_t[32768];
-      for (int i = 0; i < 32768; i++)
-        dummyMemory[i] = 0xFF;
-      setPaging(0x3F00);
-    }
-    catch (...) {
-      if (segmentTable) {
-        delete[] segmentTable;
-        segmentTable = (uint8_t **) 0;
-      }
-      if (segmentROMTable) {
-        delete[] segmentROMTable;
-        segmentROMTable = (bool *) 0;
-      }
-      if (segmentBreakPointTable) {
-        delete[] segmentBreakPointTable;
-        segmentBreakPointTable = (uint8_t **) 0;
-      }
-      if (segmentBreakPointCntTable) {
-        delete[] segmentBreakPointCntTable;
-        segmentBreakPointCntTable = (size_t *) 0;
-      }
-      if (videoMemory) {
-        delete[] videoMemory;
-        videoMemory = (uint8_t *) 0;
-      }
-      if (dummyMemory) {
-        delete[] dummyMemory;
-        dummyMemory = (uint8_t *) 0;
-      }
-      throw;
+    videoMemory = new uint8_t[65536];
+    for (int i = 0; i < 65536; i++)
+      videoMemory[i] = 0xFF;
+    for (int i = 0xFC; i <= 0xFF; i++) {
+      segmentTable[i] = &(videoMemory[(i & 3) << 14]);
+      segmentROMTable[i] = false;
     }
+    setPaging(0x3F00);
   }
 
   Memory::~Memory()
   {
-    for (int i = 0x00; i < 0xFC; i++) {
-      if (segmentTable[i])
-        delete[] segmentTable[i];
-    }
-    delete[] dummyMemory;
+    // video memory is not owned by MemoryBase
+    for (int i = 0xFC; i <= 0xFF; i++)
+      segmentTable[i] = (uint8_t *) 0;
     delete[] videoMemory;
-    delete[] segmentTable;
-    delete[] segmentROMTable;
-    if (breakPointTable)
-      delete[] breakPointTable;
-    for (int i = 0; i < 256; i++) {
-      if (segmentBreakPointTable[i])
-        delete[] segmentBreakPointTable[i];
-    }
-    delete[] segmentBreakPointTable;
-    delete[] segmentBreakPointCntTable;
-  }
-
-  void Memory::setBreakPoint(uint8_t segment, uint16_t addr, int priority,
-                             bool r, bool w, bool x, bool ignoreFlag)
-  {
-    uint8_t mode =
-        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
-    if (mode) {
-      // create new breakpoint, or change existing one
-      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
-      if (!segmentBreakPointTable[segment]) {
-        segmentBreakPointTable[segment] = new uint8_t[16384];
-        for (int i = 0; i < 16384; i++)
-          segmentBreakPointTable[segment][i] = 0;
-      }
-      haveBreakPoints = true;
-      uint8_t&  bp = segmentBreakPointTable[segment][addr & 0x3FFF];
-      if (!bp)
-        segmentBreakPointCntTable[segment]++;
-      if (bp > mode)
-        mode = (bp & 56) + (mode & 7);
-      mode |= (bp & 7);
-      bp = mode;
-    }
-    else if (segmentBreakPointTable[segment]) {
-      if (segmentBreakPointTable[segment][addr & 0x3FFF]) {
-        // remove a previously existing breakpoint
-        segmentBreakPointCntTable[segment]--;
-        if (!segmentBreakPointCntTable[segment]) {
-          delete[] segmentBreakPointTable[segment];
-          segmentBreakPointTable[segment] = (uint8_t *) 0;
-        }
-      }
-    }
-  }
-
-  void Memory::setBreakPoint(uint16_t addr, int priority,
-                             bool r, bool w, bool x, bool ignoreFlag)
-  {
-    uint8_t mode =
-        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
-    if (mode) {
-      // create new breakpoint, or change existing one
-      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
-      if (!breakPointTable) {
-        breakPointTable = new uint8_t[65536];
-        for (int i = 0; i < 65536; i++)
-          breakPointTable[i] = 0;
-      }
-      haveBreakPoints = true;
-      uint8_t&  bp = breakPointTable[addr];
-      if (!bp)
-        breakPointCnt++;
-      if (bp > mode)
-        mode = (bp & 56) + (mode & 7);
-      mode |= (bp & 7);
-      bp = mode;
-    }
-    else if (breakPointTable) {
-      if (breakPointTable[addr]) {
-        // remove a previously existing breakpoint
-        breakPointCnt--;
-        if (!breakPointCnt) {
-          delete[] breakPointTable;
-          breakPointTable = (uint8_t *) 0;
-        }
-      }
-    }
-  }
-
-  void Memory::clearBreakPoints(uint8_t segment)
-  {
-    for (uint16_t addr = 0; addr < 16384; addr++)
-      setBreakPoint(segment, addr, 0, false, false, false, false);
-  }
-
-  void Memory::clearBreakPoints()
-  {
-    for (unsigned int addr = 0; addr < 65536; addr++)
-      setBreakPoint((uint16_t) addr, 0, false, false, false, false);
-  }
-
-  void Memory::clearAllBreakPoints()
-  {
-    clearBreakPoints();
-    for (unsigned int segment = 0; segment < 256; segment++)
-      clearBreakPoints((uint8_t) segment);
-    haveBreakPoints = false;
-  }
-
-  void Memory::breakPointCallback(bool isWrite, uint16_t addr, uint8_t value)
-  {
-    (void) isWrite;
-    (void) addr;
-    (void) value;
   }
 
   EP128EMU_REGPARM2 uint8_t Memory::extensionRead(uint16_t addr)
@@ -294,16 +80,6 @@ namespace TVC64 {
     (void) value;
   }
 
-  void Memory::setBreakPointPriorityThreshold(int n)
-  {
-    breakPointPriorityThreshold = uint8_t((n > 0 ? (n < 4 ? n : 4) : 0) << 3);
-  }
-
-  int Memory::getBreakPointPriorityThreshold()
-  {
-    return int(breakPointPriorityThreshold >> 3);
-  }
-
   void Memory::setRAMSize(size_t n)
   {
     totalRAMSegments = 5;
@@ -332,6 +108,7 @@ namespace TVC64 {
       return;
     }
     // allocate memory for segment if necessary
+    uint8_t firstSegment = segment;
     allocateSegment(segment, true);
     size_t  i = 0;
     if (dataSize) {
@@ -353,17 +130,15 @@ namespace TVC64 {
       std::memcpy(&(segmentTable[segment][0x2000]),
                   &(segmentTable[segment][0]), dataSize);
     }
+    for (size_t j = 0; j < (i >> 14); j++)
+      shareSegment(uint8_t((firstSegment + j) & 0xFF));
   }
 
   void Memory::deleteSegment(uint8_t segment)
   {
     if (segment >= 0xFC)
       throw Ep128Emu::Exception("cannot delete video memory segments");
-    if (segmentTable[segment])
-      delete[] segmentTable[segment];
-    segmentTable[segment] = (uint8_t*) 0;
-    segmentROMTable[segment] = true;
-    setPaging(currentPaging);
+    MemoryBase::deleteSegment(segment);
   }
 
   void Memory::deleteAllSegments()
@@ -372,6 +147,11 @@ namespace TVC64 {
       deleteSegment(uint8_t(segment));
   }
 
+  void Memory::updatePaging()
+  {
+    setPaging(currentPaging);
+  }
+
   void Memory::setPaging(uint16_t n)
   {
     if (totalRAMSegments < 8)
@@ -443,24 +223,9 @@ namespace TVC64 {
     }
   }
 
-  bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 && (tbl[addr] & 32) != 0) {
-      return true;
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[addr >> 14]];
-      if (tbl != (uint8_t *) 0 && (tbl[offs] & 32) != 0) {
-        return true;
-      }
-    }
-    return false;
-  }
-
   void Memory::clearRAM()
   {
+    setAllSegmentsDirty();
     for (int i = 0xF8; i <= 0xFF; i++) {
       if (i == (0xF7 + totalRAMSegments))
         i = 0xFF;
@@ -472,32 +237,6 @@ namespace TVC64 {
       std::memset(&(extensionRAM.front()), 0xFF, extensionRAM.size());
   }
 
-  Ep128Emu::BreakPointList Memory::getBreakPointList()
-  {
-    Ep128Emu::BreakPointList  bplst;
-    if (breakPointTable) {
-      for (size_t i = 0; i < 65536; i++) {
-        uint8_t bp = breakPointTable[i];
-        if (bp)
-          bplst.addMemoryBreakPoint(uint16_t(i),
-                                    bool(bp & 1), bool(bp & 2), bool(bp & 4),
-                                    bool(bp & 32), bp >> 3);
-      }
-    }
-    for (size_t j = 0; j < 256; j++) {
-      if (segmentBreakPointTable[j]) {
-        for (size_t i = 0; i < 16384; i++) {
-          uint8_t bp = segmentBreakPointTable[j][i];
-          if (bp)
-            bplst.addMemoryBreakPoint(uint8_t(j), uint16_t(i),
-                                      bool(bp & 1), bool(bp & 2), bool(bp & 4),
-                                      bool(bp & 32), bp >> 3);
-        }
-      }
-    }
-    return bplst;
-  }
-
   // --------------------------------------------------------------------------
 
   class ChunkType_TVCMemSnapshot : public Ep128Emu::File::ChunkTypeHandler {
@@ -535,8 +274,7 @@ namespace TVC64 {
       if (i == 0xFC && totalRAMSegments < 8)
         i = 0xFF;
       if (segmentTable[i] != (uint8_t *) 0) {
-        for (size_t j = 0; j < 16384; j++)
-          buf.writeByte(segmentTable[i][j]);
+        buf.writeData(segmentTable[i], 16384);
       }
       else {
         for (size_t j = 0; j < 16384; j++)
@@ -565,6 +303,7 @@ namespace TVC64 {
 
   void Memory::loadState(Ep128Emu::File::Buffer& buf)
   {
+    setAllSegmentsDirty();
     buf.setPosition(0);
     // check version number
     unsigned int  version = buf.readUInt32();
@@ -590,8 +329,7 @@ namespace TVC64 {
           i = 0xFC;
         if (i == 0xFC && totalRAMSegments < 8)
           i = 0xFF;
-        for (size_t j = 0; j < 16384; j++)
-          segmentTable[i][j] = buf.readByte();
+        buf.readData(segmentTable[i], 16384);
       }
       if (version < 0x01000001) {
         if (extensionRAM.size() > 0)
@@ -615,6 +353,7 @@ namespace TVC64 {
              i++) {
           segmentTable[segment][i] = buf.readByte();
         }
+        shareSegment(segment);
       }
       setPaging(currentPaging);
     }
@@ -640,5 +379,16 @@ namespace TVC64 {
     }
   }
 
+  void Memory::forkState(Ep128Emu::StateFork& f)
+  {
+    f.copy(pageTable);
+    f.copy(currentPaging);
+    f.copy(pageAddressTableR);
+    f.copy(pageAddressTableW);
+    forkSegments(f);
+    if (extensionRAM.size() > 0)
+      f.copyData(&(extensionRAM.front()), extensionRAM.size());
+  }
+
 }       // namespace TVC64
 
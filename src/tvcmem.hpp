@@ -22,13 +22,12 @@
 
 #include "ep128emu.hpp"
 #include "bplist.hpp"
+#include "membase.hpp"
 
 namespace TVC64 {
 
-  class Memory {
+  class Memory : public Ep128Emu::MemoryBase {
    private:
-    uint8_t   **segmentTable;
-    bool      *segmentROMTable;
     uint8_t   pageTable[4];
     uint16_t  currentPaging;            // configuration set with setPaging()
     uint8_t   totalRAMSegments;         // 3 (TVC32), 5 (TVC64) or 8 (TVC64+)
@@ -37,43 +36,28 @@ namespace TVC64 {
     bool      segment1IsExtension;
     std::vector< uint8_t >  extensionRAM;
    private:
-    uint8_t   *breakPointTable;
-    size_t    breakPointCnt;
-    uint8_t   **segmentBreakPointTable;
-    size_t    *segmentBreakPointCntTable;
-    bool      haveBreakPoints;
-    uint8_t   breakPointPriorityThreshold;
     uint8_t   *videoMemory; // 64K for segments FC to FF; always RAM
-    uint8_t   *dummyMemory; // 2*16K dummy memory for invalid reads and writes
     uint8_t   *pageAddressTableR[8];
     uint8_t   *pageAddressTableW[8];
     void allocateSegment(uint8_t n, bool isROM);
-    void checkExecuteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
+   protected:
+    virtual void updatePaging();
    public:
     Memory();
     virtual ~Memory();
-    void setBreakPoint(uint8_t segment, uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void setBreakPoint(uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void clearBreakPoints(uint8_t segment);
-    void clearBreakPoints();
-    void clearAllBreakPoints();
-    void setBreakPointPriorityThreshold(int n);
-    int getBreakPointPriorityThreshold();
     void setRAMSize(size_t n);          // in kilobytes; 48, 80 or 128
     void loadROMSegment(uint8_t segment, const uint8_t *data, size_t dataSize);
     void deleteSegment(uint8_t segment);
     void deleteAllSegments();
     inline uint8_t read(uint16_t addr);
     inline uint8_t readOpcode(uint16_t addr);
+#ifdef Z80_DECODE_CACHE
+    // returns the predecoded instruction at 'addr', or zero if it cannot
+    // be cached
+    inline uint32_t readOpcodeDecoded(uint16_t addr);
+#endif
     inline uint8_t readNoDebug(uint16_t addr) const;
-    inline uint8_t readRaw(uint32_t addr) const;
     inline void write(uint16_t addr, uint8_t value);
-    inline void writeRaw(uint32_t addr, uint8_t value);
-    inline void writeROM(uint32_t addr, uint8_t value);
     // set memory paging:
     //   bits 0 to 7:   port 02h:
     //          b0, b1:   unused
@@ -101,20 +85,18 @@ namespace TVC64 {
     void setPaging(uint16_t n);
     inline uint16_t getPaging() const;
     inline uint8_t getPage(uint8_t page) const;
+    // returns true if 'addr' is in a page handled by extensionRead()
+    inline bool isExtensionAddress(uint16_t addr) const;
     // get current video RAM page for display
     inline const uint8_t * getVideoMemory() const;
-    inline bool isSegmentROM(uint8_t segment) const;
-    inline bool isSegmentRAM(uint8_t segment) const;
-    inline void * getSegmentPtr(uint8_t segment) const;
-    bool checkIgnoreBreakPoint(uint16_t addr) const;
+    inline bool checkIgnoreBreakPoint(uint16_t addr) const;
     void clearRAM();
-    Ep128Emu::BreakPointList getBreakPointList();
     void saveState(Ep128Emu::File::Buffer&);
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
    protected:
-    virtual void breakPointCallback(bool isWrite, uint16_t addr, uint8_t value);
     // these functions are used when accessing special memory areas like IOMEM
     virtual EP128EMU_REGPARM2 uint8_t extensionRead(uint16_t addr);
     virtual EP128EMU_REGPARM2 uint8_t extensionReadNoDebug(uint16_t addr) const;
@@ -132,7 +114,7 @@ namespace TVC64 {
     else
       value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkReadBreakPoint(addr, page, value);
+      checkReadBreakPoint(addr, pageTable[page >> 1], value);
     return value;
   }
 
@@ -145,10 +127,19 @@ namespace TVC64 {
     else
       value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkExecuteBreakPoint(addr, page, value);
+      checkExecuteBreakPoint(addr, pageTable[page >> 1], value);
     return value;
   }
 
+#ifdef Z80_DECODE_CACHE
+  inline uint32_t Memory::readOpcodeDecoded(uint16_t addr)
+  {
+    if (EP128EMU_UNLIKELY(!pageAddressTableR[addr >> 13]))
+      return 0U;
+    return readDecodeCache(pageTable[addr >> 14], uint16_t(addr & 0x3FFF));
+  }
+
+#endif
   inline uint8_t Memory::readNoDebug(uint16_t addr) const
   {
     uint8_t page = uint8_t(addr >> 13);
@@ -157,18 +148,6 @@ namespace TVC64 {
     return pageAddressTableR[page][addr];
   }
 
-  inline uint8_t Memory::readRaw(uint32_t addr) const
-  {
-    uint8_t segment, value;
-
-    segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      value = segmentTable[segment][addr & 0x3FFF];
-    else
-      value = 0xFF;
-    return value;
-  }
-
   inline void Memory::write(uint16_t addr, uint8_t value)
   {
     uint8_t page = uint8_t(addr >> 13);
@@ -177,22 +156,9 @@ namespace TVC64 {
       return;
     }
     if (haveBreakPoints)
-      checkWriteBreakPoint(addr, page, value);
+      checkWriteBreakPoint(addr, pageTable[page >> 1], value);
     pageAddressTableW[page][addr] = value;
-  }
-
-  inline void Memory::writeRaw(uint32_t addr, uint8_t value)
-  {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (!segmentROMTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
-  }
-
-  inline void Memory::writeROM(uint32_t addr, uint8_t value)
-  {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
+    segmentWritten(pageTable[page >> 1], addr);
   }
 
   inline uint16_t Memory::getPaging() const
@@ -205,26 +171,19 @@ namespace TVC64 {
     return pageTable[page & 3];
   }
 
-  inline const uint8_t * Memory::getVideoMemory() const
+  inline bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
   {
-    return &(videoMemory[(currentPaging & 0x3000) << 2]);
+    return MemoryBase::checkIgnoreBreakPoint(addr, pageTable[addr >> 14]);
   }
 
-  inline bool Memory::isSegmentROM(uint8_t segment) const
+  inline bool Memory::isExtensionAddress(uint16_t addr) const
   {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            segmentROMTable[segment]);
+    return !pageAddressTableR[uint8_t(addr >> 13)];
   }
 
-  inline bool Memory::isSegmentRAM(uint8_t segment) const
-  {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            !segmentROMTable[segment]);
-  }
-
-  inline void * Memory::getSegmentPtr(uint8_t segment) const
+  inline const uint8_t * Memory::getVideoMemory() const
   {
-    return (segmentTable[segment]);
+    return &(videoMemory[(currentPaging & 0x3000) << 2]);
   }
 
 }       // namespace TVC64
@@ -313,5 +313,11 @@ namespace TVC64 {
     videoMode = 0;
   }
 
+  void TVCVideo::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, TVCVideo, lineBufPtr, hSyncPos);
+    f.copyData(lineBuf, 112 * sizeof(uint32_t));
+  }
+
 }       // namespace TVC64
 
@@ -104,6 +104,7 @@ namespace TVC64 {
       videoMemory = videoMemory_;
     }
     void reset();
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace TVC64
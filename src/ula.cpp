@@ -55,58 +55,25 @@ namespace ZX128 {
         ula.currentLine = 0;
         ula.ld1Ptr = &(ula.videoRAMPtr[0x1800]);
         ula.ld2Ptr = ula.videoRAMPtr;
-        ula.runOneSlot_ = &ULA::videoFunc_DisplayLBorder;
+        ula.runOneSlot_ = &ULA::videoFunc_Display;
       }
       else {
         ula.runOneSlot_ = &ULA::videoFunc_TBorder;
       }
       ula.lineBufPtr = ula.lineBuf;
+      ula.renderPos = 0;
     }
   }
 
-  void EP128EMU_REGPARM1 ULA::videoFunc_DisplayLBorder(void *userData)
+  void EP128EMU_REGPARM1 ULA::videoFunc_Display(void *userData)
   {
     ULA&    ula = *(reinterpret_cast<ULA *>(userData));
-    ula.lineBufPtr[0] = 0x01;
-    ula.lineBufPtr[1] = ula.borderColor;
-    ula.lineBufPtr = ula.lineBufPtr + 2;
     ula.currentSlot++;
     if (EP128EMU_UNLIKELY(ula.currentSlot == ula.slotsPerLine)) {
       ula.currentSlot = 0;
-      ula.runOneSlot_ = &ULA::videoFunc_Display;
     }
-  }
-
-  void EP128EMU_REGPARM1 ULA::videoFunc_Display(void *userData)
-  {
-    ULA&    ula = *(reinterpret_cast<ULA *>(userData));
-    uint8_t a = ula.ld1Ptr[ula.currentSlot];
-    uint8_t b = ula.ld2Ptr[ula.currentSlot];
-    uint8_t c0 = (a & 0x78) >> 3;
-    uint8_t c1 = (a & 0x07) | ((a & 0x40) >> 3);
-    if (EP128EMU_UNLIKELY((a & ula.flashCnt) & 0x80)) {
-      uint8_t tmp = c0;
-      c0 = c1;
-      c1 = tmp;
-    }
-    ula.lineBufPtr[0] = 0x03;
-    ula.lineBufPtr[1] = c0;
-    ula.lineBufPtr[2] = c1;
-    ula.lineBufPtr[3] = b;
-    ula.lineBufPtr = ula.lineBufPtr + 4;
-    ula.currentSlot++;
-    if (EP128EMU_UNLIKELY(ula.currentSlot == 32))
-      ula.runOneSlot_ = &ULA::videoFunc_DisplayRBorder;
-  }
-
-  void EP128EMU_REGPARM1 ULA::videoFunc_DisplayRBorder(void *userData)
-  {
-    ULA&    ula = *(reinterpret_cast<ULA *>(userData));
-    ula.lineBufPtr[0] = 0x01;
-    ula.lineBufPtr[1] = ula.borderColor;
-    ula.lineBufPtr = ula.lineBufPtr + 2;
-    ula.currentSlot++;
-    if (EP128EMU_UNLIKELY(ula.currentSlot == 40)) {
+    else if (EP128EMU_UNLIKELY(ula.currentSlot == 40)) {
+      ula.renderDisplayLine_();
       ula.runOneSlot_ = &ULA::videoFunc_DisplayHBlank;
       ula.drawLine(ula.lineBuf, size_t(ula.lineBufPtr - ula.lineBuf));
     }
@@ -133,9 +100,10 @@ namespace ZX128 {
           ula.ld1Ptr = ula.ld1Ptr + 0x0020;
           ula.ld2Ptr = ula.ld2Ptr + 0x0020;
         }
-        ula.runOneSlot_ = &ULA::videoFunc_DisplayLBorder;
+        ula.runOneSlot_ = &ULA::videoFunc_Display;
       }
       ula.lineBufPtr = ula.lineBuf;
+      ula.renderPos = 0;
     }
   }
 
@@ -226,6 +194,54 @@ namespace ZX128 {
     lineBufPtr = lineBuf;
   }
 
+  void ULA::renderDisplayLine_()
+  {
+    // cells 0 to 7: left border, 8 to 39: bitmap, 40 to 47: right border
+    uint8_t endPos = currentSlot + 8;
+    if (currentSlot >= hSyncEndSlot)
+      endPos = currentSlot - hSyncEndSlot;
+    else if (endPos > 48)
+      endPos = 48;
+    uint8_t pos = renderPos;
+    if (pos >= endPos)
+      return;
+    renderPos = endPos;
+    uint8_t *bufp = lineBuf;
+    if (pos < 8)
+      bufp = bufp + (pos << 1);
+    else if (pos < 40)
+      bufp = bufp + ((pos << 2) - 16);
+    else
+      bufp = bufp + ((pos << 1) + 64);
+    for ( ; pos < endPos && pos < 8; pos++) {
+      bufp[0] = 0x01;
+      bufp[1] = borderColor;
+      bufp = bufp + 2;
+    }
+    for ( ; pos < endPos && pos < 40; pos++) {
+      uint8_t a = ld1Ptr[pos - 8];
+      uint8_t b = ld2Ptr[pos - 8];
+      uint8_t c0 = (a & 0x78) >> 3;
+      uint8_t c1 = (a & 0x07) | ((a & 0x40) >> 3);
+      if (EP128EMU_UNLIKELY((a & flashCnt) & 0x80)) {
+        uint8_t tmp = c0;
+        c0 = c1;
+        c1 = tmp;
+      }
+      bufp[0] = 0x03;
+      bufp[1] = c0;
+      bufp[2] = c1;
+      bufp[3] = b;
+      bufp = bufp + 4;
+    }
+    for ( ; pos < endPos; pos++) {
+      bufp[0] = 0x01;
+      bufp[1] = borderColor;
+      bufp = bufp + 2;
+    }
+    lineBufPtr = bufp;
+  }
+
   EP128EMU_REGPARM2 bool ULA::getInterruptFlag_(int timeOffs) const
   {
     int     x = 0;
@@ -274,12 +290,8 @@ namespace ZX128 {
         runOneSlot_ = &videoFunc_TBorderHBlank;
     }
     else if (currentLine < 192) {
-      if (currentSlot >= hSyncEndSlot)
-        runOneSlot_ = &videoFunc_DisplayLBorder;
-      else if (currentSlot < 32)
+      if (currentSlot < 40 || currentSlot >= hSyncEndSlot)
         runOneSlot_ = &videoFunc_Display;
-      else if (currentSlot < 40)
-        runOneSlot_ = &videoFunc_DisplayRBorder;
       else
         runOneSlot_ = &videoFunc_DisplayHBlank;
     }
@@ -303,6 +315,10 @@ namespace ZX128 {
       lineBufPtr = &(lineBuf[(currentSlot << 1) + 80]);
     else
       lineBufPtr = &(lineBuf[160]);
+    if (currentSlot >= hSyncEndSlot)
+      renderPos = currentSlot - hSyncEndSlot;
+    else
+      renderPos = (currentSlot < 40 ? (currentSlot + 8) : 48);
     ld1Ptr = videoRAMPtr + 0x1800;
     ld2Ptr = videoRAMPtr;
     if (currentLine < 192) {
@@ -325,6 +341,7 @@ namespace ZX128 {
       currentSlot(48),
       hSyncEndSlot(48),
       slotsPerLine(56),
+      renderPos(48),
       ioPortValue(0x00),
       borderColor(0x00),
       flashCnt(0x00),
@@ -407,6 +424,7 @@ namespace ZX128 {
 
   void ULA::writePort(uint8_t value)
   {
+    updateDisplay();
     int     tmp = int(value & 0x18) - int(ioPortValue & 0x18);
     if (tmp != 0)
       tapeOutput = uint8_t(tmp >= 0);
@@ -430,6 +448,7 @@ namespace ZX128 {
 
   void ULA::setSpectrum128Mode(bool isSpectrum128)
   {
+    updateDisplay();
     if (currentSlot >= (hSyncEndSlot - 1)) {
       currentSlot = (currentSlot - uint8_t(spectrum128Mode))
                     + uint8_t(isSpectrum128);
@@ -553,5 +572,11 @@ namespace ZX128 {
     }
   }
 
+  void ULA::forkState(Ep128Emu::StateFork& f)
+  {
+    EP128EMU_FORK_RANGE(f, ULA, runOneSlot_, keyboardState);
+    f.copyData(lineBuf, 48 * sizeof(uint32_t));
+  }
+
 }       // namespace ZX128
 
@@ -31,6 +31,8 @@ namespace ZX128 {
     uint8_t   currentSlot;
     uint8_t   hSyncEndSlot;             // 48K: 48, 128K: 49
     uint8_t   slotsPerLine;             // 48K: 56, 128K: 57
+    uint8_t   renderPos;                // display line cells (0 to 48) in
+                                        // lineBuf, the rest is not rendered
     uint8_t   ioPortValue;              // last value written to I/O port 0xFE
     uint8_t   borderColor;
     uint8_t   flashCnt;                 // incremented by 8 from 0 to 0xF8
@@ -50,15 +52,14 @@ namespace ZX128 {
     // --------
     static EP128EMU_REGPARM1 void videoFunc_TBorder(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_TBorderHBlank(void *userData);
-    static EP128EMU_REGPARM1 void videoFunc_DisplayLBorder(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_Display(void *userData);
-    static EP128EMU_REGPARM1 void videoFunc_DisplayRBorder(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_DisplayHBlank(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_BBorder(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_BBorderHBlank(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_VBlank(void *userData);
     static EP128EMU_REGPARM1 void videoFunc_VBlankHBlank(void *userData);
     void clearLineBuffer();
+    void renderDisplayLine_();
     EP128EMU_REGPARM2 bool getInterruptFlag_(int timeOffs) const;
     EP128EMU_REGPARM2 int getWaitHalfCycles_(int timeOffs) const;
     EP128EMU_REGPARM2 uint8_t idleDataBusRead_(int timeOffs) const;
@@ -79,6 +80,15 @@ namespace ZX128 {
     {
       runOneSlot_((void *) this);
     }
+    // The border and bitmap cells of display lines are only rendered at the
+    // end of the line, or when this function is called. It needs to be
+    // called before writing to video memory, so that the cells already
+    // displayed use the previous data.
+    EP128EMU_INLINE void updateDisplay()
+    {
+      if (runOneSlot_ == &ULA::videoFunc_Display)
+        renderDisplayLine_();
+    }
     inline uint16_t getSoundOutput() const
     {
       return audioOutput;
@@ -204,6 +214,7 @@ namespace ZX128 {
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    void forkState(Ep128Emu::StateFork&);
   };
 
 }       // namespace ZX128
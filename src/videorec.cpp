@@ -46,6 +46,24 @@ namespace Ep128Emu {
   {
   }
 
+  VideoCapture::FrameWriterThread::FrameWriterThread(
+      VideoCapture& videoCapture_)
+    : Thread(),
+      videoCapture(videoCapture_)
+  {
+  }
+
+  VideoCapture::FrameWriterThread::~FrameWriterThread()
+  {
+  }
+
+  void VideoCapture::FrameWriterThread::run()
+  {
+    videoCapture.writerThreadLoop();
+  }
+
+  // --------------------------------------------------------------------------
+
   void VideoCapture::AudioConverter_::audioOutput(int16_t left, int16_t right)
   {
     const int   totalBufSize =
@@ -127,7 +145,20 @@ namespace Ep128Emu {
       errorCallback(&defaultErrorCallback),
       errorCallbackUserData((void *) this),
       fileNameCallback(&defaultFileNameCallback),
-      fileNameCallbackUserData((void *) this)
+      fileNameCallbackUserData((void *) this),
+      frameDataSize(0),
+      frameQueueBuf((uint8_t *) 0),
+      frameQueueChanged((bool *) 0),
+      frameQueueReadPos(0),
+      frameQueueWritePos(0),
+      frameQueueFrames(0),
+      frameQueueStopFlag(false),
+      dropFramesWhenBusy(false),
+      forceNextFrameChanged(false),
+      droppedFrames(0),
+      frameQueueNotEmpty(false),
+      frameQueueNotFull(false),
+      writerThread((FrameWriterThread *) 0)
   {
     try {
       frameRate = (frameRate > 24 ? (frameRate < 60 ? frameRate : 60) : 24);
@@ -151,6 +182,8 @@ namespace Ep128Emu {
 
   VideoCapture::~VideoCapture()
   {
+    // derived classes should have already called closeFile()
+    stopWriterThread();
     delete[] audioBuf;
     delete audioConverter;
   }
@@ -170,6 +203,29 @@ namespace Ep128Emu {
     closeFile();
     if (fileName == (char *) 0 || fileName[0] == '\0')
       return;
+    openAVIFile(fileName);
+    try {
+      size_t  entrySize = frameDataSize + size_t(audioBufSize * 4);
+      frameQueueBuf = new uint8_t[entrySize * size_t(frameQueueSize)];
+      frameQueueChanged = new bool[frameQueueSize];
+      frameQueueReadPos = 0;
+      frameQueueWritePos = 0;
+      frameQueueFrames = 0;
+      frameQueueStopFlag = false;
+      forceNextFrameChanged = false;
+      droppedFrames = 0;
+      writerThread = new FrameWriterThread(*this);
+      writerThread->start();
+    }
+    catch (...) {
+      stopWriterThread();
+      closeAVIFile();
+      throw;
+    }
+  }
+
+  void VideoCapture::openAVIFile(const char *fileName)
+  {
     aviFile = fileOpen(fileName, "wb");
     if (!aviFile)
       throw Exception("error opening AVI file");
@@ -180,6 +236,13 @@ namespace Ep128Emu {
   }
 
   void VideoCapture::closeFile()
+  {
+    // write all queued frames first
+    stopWriterThread();
+    closeAVIFile();
+  }
+
+  void VideoCapture::closeAVIFile()
   {
     if (aviFile) {
       // FIXME: file I/O errors are ignored here
@@ -198,6 +261,100 @@ namespace Ep128Emu {
     }
   }
 
+  void VideoCapture::stopWriterThread()
+  {
+    if (writerThread) {
+      frameQueueMutex.lock();
+      frameQueueStopFlag = true;
+      frameQueueMutex.unlock();
+      frameQueueNotEmpty.notify();
+      writerThread->join();
+      delete writerThread;
+      writerThread = (FrameWriterThread *) 0;
+    }
+    if (frameQueueBuf) {
+      delete[] frameQueueBuf;
+      frameQueueBuf = (uint8_t *) 0;
+    }
+    if (frameQueueChanged) {
+      delete[] frameQueueChanged;
+      frameQueueChanged = (bool *) 0;
+    }
+    frameQueueReadPos = 0;
+    frameQueueWritePos = 0;
+    frameQueueFrames = 0;
+  }
+
+  void VideoCapture::writerThreadLoop()
+  {
+    size_t  entrySize = frameDataSize + size_t(audioBufSize * 4);
+    while (true) {
+      frameQueueMutex.lock();
+      if (frameQueueFrames < 1) {
+        bool    stopFlag = frameQueueStopFlag;
+        frameQueueMutex.unlock();
+        if (stopFlag)
+          break;
+        frameQueueNotEmpty.wait();
+        continue;
+      }
+      int     n = frameQueueReadPos;
+      frameQueueMutex.unlock();
+      // the entry is not modified by the emulation thread until it is
+      // removed from the queue
+      if (aviFile) {
+        const uint8_t *p = frameQueueBuf + (size_t(n) * entrySize);
+        writeFrame(p, p + frameDataSize, frameQueueChanged[n]);
+      }
+      frameQueueMutex.lock();
+      frameQueueReadPos = (n + 1) % frameQueueSize;
+      frameQueueFrames--;
+      frameQueueMutex.unlock();
+      frameQueueNotFull.notify();
+    }
+  }
+
+  void VideoCapture::queueFrame(bool frameChanged)
+  {
+    if (!writerThread)
+      return;
+    frameQueueMutex.lock();
+    while (frameQueueFrames >= frameQueueSize) {
+      if (dropFramesWhenBusy) {
+        droppedFrames++;
+        // the next frame written must not be a duplicate of an earlier one
+        forceNextFrameChanged = true;
+        frameQueueMutex.unlock();
+        return;
+      }
+      frameQueueMutex.unlock();
+      frameQueueNotFull.wait();
+      frameQueueMutex.lock();
+    }
+    int     n = frameQueueWritePos;
+    frameChanged = frameChanged || forceNextFrameChanged;
+    forceNextFrameChanged = false;
+    frameQueueMutex.unlock();
+    uint8_t *p = frameQueueBuf
+                 + (size_t(n) * (frameDataSize + size_t(audioBufSize * 4)));
+    grabFrame(p);
+    p = p + frameDataSize;
+    int     bufPos = audioBufReadPos;
+    for (int i = 0; i < (audioBufSize * 2); i++) {
+      if (bufPos >= (audioBufSize * audioBuffers * 2))
+        bufPos = 0;
+      uint16_t  tmp = uint16_t(audioBuf[bufPos++]);
+      *(p++) = uint8_t(tmp & 0xFF);
+      *(p++) = uint8_t(tmp >> 8);
+    }
+    frameQueueChanged[n] = frameChanged;
+    frameQueueMutex.lock();
+    frameQueueWritePos = (n + 1) % frameQueueSize;
+    frameQueueFrames++;
+    frameQueueMutex.unlock();
+    frameQueueNotEmpty.notify();
+  }
+
   void VideoCapture::errorMessage(const char *msg)
   {
     if (msg == (char *) 0 || msg[0] == '\0')
@@ -233,6 +390,21 @@ namespace Ep128Emu {
     }
   }
 
+  void VideoCapture::setDropFramesWhenBusy(bool isEnabled)
+  {
+    frameQueueMutex.lock();
+    dropFramesWhenBusy = isEnabled;
+    frameQueueMutex.unlock();
+  }
+
+  size_t VideoCapture::getDroppedFrameCnt()
+  {
+    frameQueueMutex.lock();
+    size_t  n = droppedFrames;
+    frameQueueMutex.unlock();
+    return n;
+  }
+
   // --------------------------------------------------------------------------
 
   VideoCapture_RLE8::VideoCaptureFrameBuffer::VideoCaptureFrameBuffer(int w,
@@ -317,6 +489,7 @@ namespace Ep128Emu {
     : VideoCapture(frameRate_),
       tmpFrameBuf(videoWidth, videoHeight),
       outputFrameBuf(videoWidth, videoHeight),
+      rleFrameBuf((uint8_t *) 0),
       frameSizes((uint32_t *) 0),
       cycleCnt(2),
       prvOddFrame(false),
@@ -324,6 +497,8 @@ namespace Ep128Emu {
   {
     try {
       aviHeaderSize = aviHeaderSize_RLE8;
+      frameDataSize = frameDataLineSize * size_t(videoHeight);
+      rleFrameBuf = new uint8_t[size_t(videoHeight) * 1024];
       size_t  maxFrames = 0x20000000 / size_t(audioBufSize);
       frameSizes = new uint32_t[maxFrames];
       std::memset(frameSizes, 0x00, maxFrames * sizeof(uint32_t));
@@ -345,6 +520,8 @@ namespace Ep128Emu {
       }
     }
     catch (...) {
+      if (rleFrameBuf)
+        delete[] rleFrameBuf;
       if (frameSizes)
         delete[] frameSizes;
       if (colormap)
@@ -357,6 +534,7 @@ namespace Ep128Emu {
   VideoCapture_RLE8::~VideoCapture_RLE8()
   {
     closeFile();
+    delete[] rleFrameBuf;
     delete[] frameSizes;
     delete[] colormap;
   }
@@ -431,7 +609,7 @@ namespace Ep128Emu {
       }
       do {
         audioBufSamples -= (audioBufSize * 2);
-        writeFrame(frameChanged);
+        queueFrame(frameChanged);
         frameChanged = false;
         audioBufReadPos += (audioBufSize * 2);
         while (audioBufReadPos >= (audioBufSize * audioBuffers * 2))
@@ -610,7 +788,19 @@ namespace Ep128Emu {
     return nBytes;
   }
 
-  void VideoCapture_RLE8::writeFrame(bool frameChanged)
+  void VideoCapture_RLE8::grabFrame(uint8_t *buf)
+  {
+    for (int i = 0; i < videoHeight; i++) {
+      uint8_t   *p = buf + (size_t(i) * frameDataLineSize);
+      uint32_t  n = outputFrameBuf.lineBytes(i);
+      std::memcpy(p, &n, sizeof(uint32_t));
+      std::memcpy(p + 4, outputFrameBuf[i], frameDataLineSize - 4);
+    }
+  }
+
+  void VideoCapture_RLE8::writeFrame(const uint8_t *frameData,
+                                     const uint8_t *audioData,
+                                     bool frameChanged)
   {
     if (!aviFile)
       return;
@@ -624,7 +814,7 @@ namespace Ep128Emu {
       duplicateFrames = 0;
     try {
       if (fileSize >= 0x7F800000) {
-        closeFile();
+        closeAVIFile();
         try {
           errorMessage("AVI file is too large, starting new output file");
         }
@@ -634,47 +824,47 @@ namespace Ep128Emu {
         fileNameCallback(fileNameCallbackUserData, fileName);
         if (fileName.length() < 1)
           return;
-        openFile(fileName.c_str());
+        openAVIFile(fileName.c_str());
+        frameChanged = true;
+        duplicateFrames = 0;
       }
       if (std::fseek(aviFile, 0L, SEEK_END) < 0)
         throw Exception("error seeking AVI file");
-      uint8_t headerBuf[8];
-      uint8_t *bufp = &(headerBuf[0]);
       size_t  nBytes = 0;
-      frameSizes[framesWritten] = 0U;
-      aviHeader_writeFourCC(bufp, "00dc");
-      aviHeader_writeUInt32(bufp, 0x00000000U);
-      fileSize = fileSize + 8;
-      if (std::fwrite(&(headerBuf[0]), 1, 8, aviFile) != 8)
-        throw Exception("error writing AVI file");
       if (frameChanged) {
-        long    savedFilePos = std::ftell(aviFile);
-        if (savedFilePos < 4L)
-          throw Exception("error seeking AVI file");
-        savedFilePos = savedFilePos - 4L;
+        // encode the frame first, so that its size is known in advance
         uint8_t lineBuf[1024];
-        uint8_t rleBuf[1024];
         size_t  n = 0;
         for (int i = (videoHeight - 1); i >= 0; i--) {
+          const uint8_t *p = frameData + (size_t(i) * frameDataLineSize);
+          uint32_t  lineBytes = 0U;
+          std::memcpy(&lineBytes, p, sizeof(uint32_t));
           if (i == (videoHeight - 1) ||
-              !outputFrameBuf.compareLine(i, outputFrameBuf, i + 1)) {
-            decodeLine(&(lineBuf[0]), outputFrameBuf[i]);
-            n = rleCompressLine(&(rleBuf[0]), &(lineBuf[0]));
+              std::memcmp(p, p + frameDataLineSize, sizeof(uint32_t)) != 0 ||
+              std::memcmp(p + 4, p + (frameDataLineSize + 4),
+                          lineBytes) != 0) {
+            decodeLine(&(lineBuf[0]), p + 4);
+            n = rleCompressLine(&(rleFrameBuf[nBytes]), &(lineBuf[0]));
+          }
+          else {
+            // same as the previous line
+            std::memcpy(&(rleFrameBuf[nBytes]), &(rleFrameBuf[nBytes - n]), n);
           }
           nBytes += n;
-          fileSize += n;
-          if (std::fwrite(&(rleBuf[0]), 1, n, aviFile) != n)
-            throw Exception("error writing AVI file");
         }
-        if (std::fseek(aviFile, savedFilePos, SEEK_SET) < 0)
-          throw Exception("error seeking AVI file");
-        bufp = &(headerBuf[4]);
-        frameSizes[framesWritten] = uint32_t(nBytes);
-        aviHeader_writeUInt32(bufp, uint32_t(nBytes));
-        if (std::fwrite(&(headerBuf[4]), 1, 4, aviFile) != 4)
+      }
+      uint8_t headerBuf[8];
+      uint8_t *bufp = &(headerBuf[0]);
+      frameSizes[framesWritten] = uint32_t(nBytes);
+      aviHeader_writeFourCC(bufp, "00dc");
+      aviHeader_writeUInt32(bufp, uint32_t(nBytes));
+      fileSize = fileSize + 8;
+      if (std::fwrite(&(headerBuf[0]), 1, 8, aviFile) != 8)
+        throw Exception("error writing AVI file");
+      if (nBytes > 0) {
+        fileSize = fileSize + nBytes;
+        if (std::fwrite(&(rleFrameBuf[0]), 1, nBytes, aviFile) != nBytes)
           throw Exception("error writing AVI file");
-        if (std::fseek(aviFile, 0L, SEEK_END) < 0)
-          throw Exception("error seeking AVI file");
       }
       bufp = &(headerBuf[0]);
       nBytes = size_t(audioBufSize * 4);
@@ -683,21 +873,12 @@ namespace Ep128Emu {
       fileSize = fileSize + 8;
       if (std::fwrite(&(headerBuf[0]), 1, 8, aviFile) != 8)
         throw Exception("error writing AVI file");
-      int     bufPos = audioBufReadPos;
-      for (int i = 0; i < (audioBufSize * 2); i++) {
-        if (bufPos >= (audioBufSize * audioBuffers * 2))
-          bufPos = 0;
-        int16_t tmp = audioBuf[bufPos++];
-        fileSize++;
-        if (std::fputc(int(uint16_t(tmp) & 0xFF), aviFile) == EOF)
-          throw Exception("error writing AVI file");
-        fileSize++;
-        if (std::fputc(int((uint16_t(tmp) >> 8) & 0xFF), aviFile) == EOF)
-          throw Exception("error writing AVI file");
-      }
+      fileSize = fileSize + nBytes;
+      if (std::fwrite(audioData, 1, nBytes, aviFile) != nBytes)
+        throw Exception("error writing AVI file");
     }
     catch (std::exception& e) {
-      closeFile();
+      closeAVIFile();
       errorMessage(e.what());
       return;
     }
@@ -983,6 +1164,7 @@ namespace Ep128Emu {
   {
     try {
       aviHeaderSize = aviHeaderSize_YV12;
+      frameDataSize = size_t((videoWidth * videoHeight * 3) / 2);
       size_t    bufSize1 = size_t(videoWidth * videoHeight);
       size_t    bufSize2 = 1024 / 4;
       size_t    bufSize3 = (bufSize1 + 3) >> 2;
@@ -1668,7 +1850,7 @@ namespace Ep128Emu {
         frameChanged |= (tmp2 ^ outBufY[i]);
         outBufY[i] = tmp2;
       } while (++i < n);
-      writeFrame(bool(frameChanged));
+      queueFrame(bool(frameChanged));
       audioBufReadPos += (audioBufSize * 2);
       while (audioBufReadPos >= (audioBufSize * audioBuffers * 2))
         audioBufReadPos -= (audioBufSize * audioBuffers * 2);
@@ -1716,7 +1898,15 @@ namespace Ep128Emu {
     } while (++i < n);
   }
 
-  void VideoCapture_YV12::writeFrame(bool frameChanged)
+  void VideoCapture_YV12::grabFrame(uint8_t *buf)
+  {
+    // outBufY, outBufV, and outBufU are stored in a contiguous buffer
+    std::memcpy(buf, outBufY, frameDataSize);
+  }
+
+  void VideoCapture_YV12::writeFrame(const uint8_t *frameData,
+                                     const uint8_t *audioData,
+                                     bool frameChanged)
   {
     if (!aviFile)
       return;
@@ -1726,18 +1916,9 @@ namespace Ep128Emu {
       else
         duplicateFrames++;
     }
-    if (frameChanged) {
-      duplicateFrames = 0;
-      duplicateFrameBitmap[framesWritten >> 3] &=
-          uint8_t((1 << (framesWritten & 7)) ^ 0xFF);
-    }
-    else {
-      duplicateFrameBitmap[framesWritten >> 3] |=
-          uint8_t(1 << (framesWritten & 7));
-    }
     try {
       if (fileSize >= 0x7F800000) {
-        closeFile();
+        closeAVIFile();
         try {
           errorMessage("AVI file is too large, starting new output file");
         }
@@ -1747,7 +1928,17 @@ namespace Ep128Emu {
         fileNameCallback(fileNameCallbackUserData, fileName);
         if (fileName.length() < 1)
           return;
-        openFile(fileName.c_str());
+        openAVIFile(fileName.c_str());
+        frameChanged = true;
+      }
+      if (frameChanged) {
+        duplicateFrames = 0;
+        duplicateFrameBitmap[framesWritten >> 3] &=
+            uint8_t((1 << (framesWritten & 7)) ^ 0xFF);
+      }
+      else {
+        duplicateFrameBitmap[framesWritten >> 3] |=
+            uint8_t(1 << (framesWritten & 7));
       }
       if (std::fseek(aviFile, 0L, SEEK_END) < 0)
         throw Exception("error seeking AVI file");
@@ -1763,7 +1954,7 @@ namespace Ep128Emu {
         throw Exception("error writing AVI file");
       if (nBytes > 0) {
         fileSize = fileSize + nBytes;
-        if (std::fwrite(&(outBufY[0]), 1, nBytes, aviFile) != nBytes)
+        if (std::fwrite(frameData, 1, nBytes, aviFile) != nBytes)
           throw Exception("error writing AVI file");
       }
       bufp = &(headerBuf[0]);
@@ -1773,21 +1964,12 @@ namespace Ep128Emu {
       fileSize = fileSize + 8;
       if (std::fwrite(&(headerBuf[0]), 1, 8, aviFile) != 8)
         throw Exception("error writing AVI file");
-      int     bufPos = audioBufReadPos;
-      for (int i = 0; i < (audioBufSize * 2); i++) {
-        if (bufPos >= (audioBufSize * audioBuffers * 2))
-          bufPos = 0;
-        int16_t tmp = audioBuf[bufPos++];
-        fileSize++;
-        if (std::fputc(int(uint16_t(tmp) & 0xFF), aviFile) == EOF)
-          throw Exception("error writing AVI file");
-        fileSize++;
-        if (std::fputc(int((uint16_t(tmp) >> 8) & 0xFF), aviFile) == EOF)
-          throw Exception("error writing AVI file");
-      }
+      fileSize = fileSize + nBytes;
+      if (std::fwrite(audioData, 1, nBytes, aviFile) != nBytes)
+        throw Exception("error writing AVI file");
     }
     catch (std::exception& e) {
-      closeFile();
+      closeAVIFile();
       errorMessage(e.what());
       return;
     }
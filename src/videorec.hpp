@@ -23,6 +23,7 @@
 #include "ep128emu.hpp"
 #include "display.hpp"
 #include "snd_conv.hpp"
+#include "system.hpp"
 
 namespace Ep128Emu {
 
@@ -30,7 +31,18 @@ namespace Ep128Emu {
    public:
     static const int  sampleRate = 48000;
     static const int  audioBuffers = 8;
+    // number of frames that can be waiting to be written to the AVI file
+    static const int  frameQueueSize = 8;
    protected:
+    class FrameWriterThread : public Thread {
+     private:
+      VideoCapture& videoCapture;
+     public:
+      FrameWriterThread(VideoCapture& videoCapture_);
+      virtual ~FrameWriterThread();
+     protected:
+      virtual void run();
+    };
     class AudioConverter_ : public AudioConverterHighQuality {
      private:
       VideoCapture& videoCapture;
@@ -67,6 +79,23 @@ namespace Ep128Emu {
     void        *errorCallbackUserData;
     void        (*fileNameCallback)(void *userData, std::string& fileName);
     void        *fileNameCallbackUserData;
+    // Frames are copied to a queue by the emulation thread, and encoded and
+    // written to the file by a separate thread. The queue and all members
+    // below are protected by frameQueueMutex.
+    size_t      frameDataSize;          // video data bytes per queued frame
+    uint8_t     *frameQueueBuf;         // frameQueueSize * (video + audio)
+    bool        *frameQueueChanged;
+    int         frameQueueReadPos;
+    int         frameQueueWritePos;
+    int         frameQueueFrames;
+    bool        frameQueueStopFlag;
+    bool        dropFramesWhenBusy;
+    bool        forceNextFrameChanged;
+    size_t      droppedFrames;
+    Mutex       frameQueueMutex;
+    ThreadLock  frameQueueNotEmpty;
+    ThreadLock  frameQueueNotFull;
+    FrameWriterThread *writerThread;
     // ----------------
     static void aviHeader_writeFourCC(uint8_t*& bufp, const char *s);
     static void aviHeader_writeUInt16(uint8_t*& bufp, uint16_t n);
@@ -75,6 +104,28 @@ namespace Ep128Emu {
     static void defaultFileNameCallback(void *userData, std::string& fileName);
     virtual void writeAVIHeader() = 0;
     virtual void writeAVIIndex() = 0;
+    /*!
+     * Copy the current video frame to 'buf' (frameDataSize bytes).
+     * Called by the emulation thread.
+     */
+    virtual void grabFrame(uint8_t *buf) = 0;
+    /*!
+     * Encode and write a frame previously stored by grabFrame(), followed
+     * by 'audioData' (sampleRate / frameRate stereo 16-bit little endian
+     * samples). Called by the writer thread.
+     */
+    virtual void writeFrame(const uint8_t *frameData, const uint8_t *audioData,
+                            bool frameChanged) = 0;
+    /*!
+     * Queue the current frame and one frame of audio data for writing.
+     * If the queue is full, either waits for the writer thread, or drops
+     * the frame (see setDropFramesWhenBusy()).
+     */
+    void queueFrame(bool frameChanged);
+    void writerThreadLoop();
+    void stopWriterThread();
+    void openAVIFile(const char *fileName);
+    void closeAVIFile();
     void closeFile();
     void errorMessage(const char *msg);
    public:
@@ -114,6 +165,16 @@ namespace Ep128Emu {
     void setFileNameCallback(void (*func)(void *userData,
                                           std::string& fileName),
                              void *userData_);
+    /*!
+     * If 'isEnabled' is true, frames are dropped (both video and audio)
+     * instead of blocking the emulation when the writer thread cannot keep
+     * up with the data. The default is to wait, so that no data is lost.
+     */
+    void setDropFramesWhenBusy(bool isEnabled);
+    /*!
+     * Returns the number of frames dropped since the file was opened.
+     */
+    size_t getDroppedFrameCnt();
   };
 
   // --------------------------------------------------------------------------
@@ -156,8 +217,11 @@ namespace Ep128Emu {
       void clearLine(long n);
     };
     // --------
+    // size of a line in frames stored by grabFrame()
+    static const size_t frameDataLineSize = 4 + 432;
     VideoCaptureFrameBuffer tmpFrameBuf;    // 768x576
     VideoCaptureFrameBuffer outputFrameBuf; // 768x576
+    uint8_t     *rleFrameBuf;           // 576 * 1024 bytes, for writeFrame()
     uint32_t    *frameSizes;
     int         cycleCnt;
     bool        prvOddFrame;
@@ -166,7 +230,9 @@ namespace Ep128Emu {
     void frameDone();
     void decodeLine(uint8_t *outBuf, const uint8_t *inBuf);
     size_t rleCompressLine(uint8_t *outBuf, const uint8_t *inBuf);
-    void writeFrame(bool frameChanged);
+    virtual void grabFrame(uint8_t *buf);
+    virtual void writeFrame(const uint8_t *frameData, const uint8_t *audioData,
+                            bool frameChanged);
     virtual void writeAVIHeader();
     virtual void writeAVIIndex();
    public:
@@ -213,7 +279,9 @@ namespace Ep128Emu {
     void decodeLine();
     void frameDone();
     void resampleFrame();
-    void writeFrame(bool frameChanged);
+    virtual void grabFrame(uint8_t *buf);
+    virtual void writeFrame(const uint8_t *frameData, const uint8_t *audioData,
+                            bool frameChanged);
     virtual void writeAVIHeader();
     virtual void writeAVIIndex();
    public:
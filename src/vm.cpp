@@ -117,6 +117,12 @@ namespace Ep128Emu {
         audioOutput_.sendAudioData(&(buf[0]), 16);
       }
     }
+    virtual void forkState(StateFork& f)
+    {
+      T::forkState(f);
+      f.copy(buf);
+      f.copy(bufPos);
+    }
   };
 
   VirtualMachine::VirtualMachine(VideoDisplay& display_,
@@ -696,6 +702,20 @@ namespace Ep128Emu {
     return nullptr;
   }
 
+  void VirtualMachine::getMemoryUsage(MemoryUsage& memoryUsage_) const
+  {
+    memoryUsage_.ramSize = 0;
+    memoryUsage_.romSize = 0;
+    memoryUsage_.sharedROMSize = 0;
+    memoryUsage_.tableSize = 0;
+    memoryUsage_.machineSize = sizeof(VirtualMachine);
+  }
+
+  uint64_t VirtualMachine::getInstructionCount() const
+  {
+    return 0UL;
+  }
+
   uint8_t VirtualMachine::readMemory(uint32_t addr, bool isCPUAddress) const
   {
     (void) addr;
@@ -825,6 +845,21 @@ namespace Ep128Emu {
     return false;
   }
 
+  bool VirtualMachine::getIsStateForkAllowed() const
+  {
+    return false;
+  }
+
+  void VirtualMachine::forkState(StateFork& f)
+  {
+    f.copy(tapeMotorState);
+    f.copy(tapeMotorOn);
+    if (f.isRestoring() && tape)
+      tape->setIsMotorOn(tapeMotorOn);
+    if (audioConverter)
+      audioConverter->forkState(f);
+  }
+
   void VirtualMachine::loadState(File::Buffer& buf)
   {
     (void) buf;
@@ -934,6 +969,12 @@ namespace Ep128Emu {
         if (fullName.length() == 0)
           return -2;                    // error: invalid file name
       }
+      // content supplied by the frontend in memory does not exist as a file
+      f = openMemoryFile(fullName.c_str(), mode);
+      if (f) {
+        fileName_ = fullName;
+        return 0;
+      }
       // attempt to stat() file
 #ifndef WIN32
       struct stat   st;
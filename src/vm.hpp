@@ -104,6 +104,14 @@ namespace Ep128Emu {
       //   0x0C000000: IDE drive 3 red LED is on (high priority)
       uint32_t  floppyDriveLEDState;
     };
+    struct MemoryUsage {
+      size_t    ramSize;        // RAM segments
+      size_t    romSize;        // ROM segments owned by this machine
+      size_t    sharedROMSize;  // ROM segments shared with other machines
+      size_t    tableSize;      // segment and breakpoint tables
+      size_t    machineSize;    // the machine object, including the
+                                // emulated hardware
+    };
     // --------
     VirtualMachine(VideoDisplay& display_, AudioOutput& audioOutput_);
     virtual ~VirtualMachine();
@@ -476,6 +484,15 @@ namespace Ep128Emu {
      * Returns a memory pointer to page 'n' (0x00 to 0xFF).
      */
     virtual void * getSegmentPtr(int n) const;
+    /*!
+     * Returns the number of bytes allocated by the emulated machine.
+     */
+    virtual void getMemoryUsage(MemoryUsage& memoryUsage_) const;
+    /*!
+     * Returns the number of CPU instructions executed since the machine was
+     * created (not including the repeated opcode fetches while halted).
+     */
+    virtual uint64_t getInstructionCount() const;
     /*!
      * Read a byte from memory. If 'isCPUAddress' is false, bits 14 to 21 of
      * 'addr' define the segment number, while bits 0 to 13 are the offset
@@ -633,6 +650,22 @@ namespace Ep128Emu {
      * playing a demo.
      */
     virtual bool getIsPlayingDemo() const;
+    /*!
+     * Returns true if the state of the emulated machine can be saved with
+     * forkState() at this time. This is false if the machine does not
+     * support it, or tape, disk or file I/O, or demo recording or playback
+     * is in progress, because the effect of these on files would not be
+     * undone by restoring the state.
+     */
+    virtual bool getIsStateForkAllowed() const;
+    /*!
+     * Save the state of the emulated machine to 'f', or restore it if
+     * f.isRestoring() is true (see statefork.hpp). This is used for running
+     * the emulation ahead, and then rewinding it, without the overhead of
+     * snapshots. The configuration must not be changed between saving and
+     * restoring the state.
+     */
+    virtual void forkState(StateFork& f);
     // ----------------
     virtual void loadState(File::Buffer& buf);
     virtual void loadMachineConfiguration(File::Buffer& buf);
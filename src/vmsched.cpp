@@ -0,0 +1,344 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include "ep128emu.hpp"
+#include "system.hpp"
+#include "vmthread.hpp"
+#include "vmsched.hpp"
+
+#include <deque>
+#include <thread>
+
+#ifdef WIN32
+#  include <windows.h>
+#elif defined(__linux__)
+#  include <sched.h>
+#endif
+
+namespace Ep128Emu {
+
+  class VMScheduler::Worker : public Thread {
+   private:
+    VMScheduler&  sched;
+    int           index;
+    volatile bool exitFlag;
+    void bindToCPU();
+   public:
+    // machines to be run by this worker, protected by 'queueMutex'
+    std::deque< Job * > queue;
+    Mutex         queueMutex;
+    // true while running a job, also protected by 'queueMutex'; the jobs
+    // of a worker that is not busy are not taken by the others, as it will
+    // run them itself after waking up
+    bool          busy;
+    // --------
+    Worker(VMScheduler& sched_, int index_);
+    virtual ~Worker();
+    virtual void run();
+    // wake up the worker if it is waiting for jobs
+    inline void wake()
+    {
+      start();
+    }
+  };
+
+  VMScheduler::Worker::Worker(VMScheduler& sched_, int index_)
+    : Thread(),
+      sched(sched_),
+      index(index_),
+      exitFlag(false),
+      busy(false)
+  {
+  }
+
+  VMScheduler::Worker::~Worker()
+  {
+    exitFlag = true;
+    start();
+    join();
+  }
+
+  void VMScheduler::Worker::bindToCPU()
+  {
+    // use the allowed CPU cores in a round robin order
+#ifdef WIN32
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(),
+                                &processMask, &systemMask)) {
+      return;
+    }
+    int     nCPUs = 0;
+    for (DWORD_PTR m = processMask; m != 0; m = m & (m - 1))
+      nCPUs++;
+    if (nCPUs < 1)
+      return;
+    int     n = index % nCPUs;
+    for (size_t i = 0; i < (sizeof(DWORD_PTR) * 8); i++) {
+      if (processMask & (DWORD_PTR(1) << i)) {
+        if (!n) {
+          SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << i);
+          break;
+        }
+        n--;
+      }
+    }
+#elif defined(__linux__)
+    cpu_set_t allowedCPUs;
+    CPU_ZERO(&allowedCPUs);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowedCPUs) != 0)
+      return;
+    int     nCPUs = CPU_COUNT(&allowedCPUs);
+    if (nCPUs < 1)
+      return;
+    int     n = index % nCPUs;
+    for (int i = 0; i < CPU_SETSIZE; i++) {
+      if (CPU_ISSET(i, &allowedCPUs)) {
+        if (!n) {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(i, &cpus);
+          pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+          break;
+        }
+        n--;
+      }
+    }
+#endif
+  }
+
+  void VMScheduler::Worker::run()
+  {
+    bindToCPU();
+    while (!exitFlag) {
+      while (!exitFlag) {
+        Job     *j = sched.getJob(index);
+        if (!j)
+          break;
+        sched.runJob(j, index);
+      }
+      if (exitFlag)
+        break;
+      sched.mutex_.lock();
+      sched.idleCnt++;
+      sched.mutex_.unlock();
+      wait();
+      sched.mutex_.lock();
+      sched.idleCnt--;
+      sched.mutex_.unlock();
+    }
+  }
+
+  // --------------------------------------------------------------------------
+
+  VMScheduler::VMScheduler(int nWorkers)
+    : doneLock(false),
+      pendingCnt(0),
+      idleCnt(0),
+      sliceLength(20000)
+  {
+    if (nWorkers < 1) {
+      nWorkers = int(std::thread::hardware_concurrency());
+      nWorkers = (nWorkers > 1 ? nWorkers : 1);
+    }
+    try {
+      for (int i = 0; i < nWorkers; i++) {
+        workers.push_back((Worker *) 0);
+        workers[i] = new Worker(*this, i);
+      }
+    }
+    catch (...) {
+      for (size_t i = 0; i < workers.size(); i++) {
+        if (workers[i])
+          delete workers[i];
+      }
+      throw;
+    }
+  }
+
+  VMScheduler::~VMScheduler()
+  {
+    for (size_t i = 0; i < workers.size(); i++)
+      delete workers[i];
+    for (size_t i = 0; i < jobs.size(); i++) {
+      if (jobs[i])
+        delete jobs[i];
+    }
+  }
+
+  int VMScheduler::addVM(VMThread& vmThread_)
+  {
+    Job     *j = new Job;
+    j->vmThread = &vmThread_;
+    j->stats.emulatedTime = 0;
+    j->stats.runTime = 0.0;
+    j->stats.sliceCnt = 0;
+    j->stats.migrationCnt = 0;
+    j->stats.workerIndex = -1;
+    for (size_t i = 0; i < jobs.size(); i++) {
+      if (!jobs[i]) {
+        jobs[i] = j;
+        return int(i);
+      }
+    }
+    try {
+      jobs.push_back(j);
+    }
+    catch (...) {
+      delete j;
+      throw;
+    }
+    return int(jobs.size() - 1);
+  }
+
+  void VMScheduler::removeVM(int n)
+  {
+    if (n < 0 || size_t(n) >= jobs.size() || !jobs[n])
+      throw Exception("VMScheduler: invalid machine index");
+    delete jobs[n];
+    jobs[n] = (Job *) 0;
+  }
+
+  void VMScheduler::setSliceLength(size_t microseconds)
+  {
+    sliceLength = (microseconds > 2000 ? microseconds : 2000);
+  }
+
+  void VMScheduler::getVMStats(int n, VMStats& s) const
+  {
+    if (n < 0 || size_t(n) >= jobs.size() || !jobs[n])
+      throw Exception("VMScheduler: invalid machine index");
+    s = jobs[n]->stats;
+  }
+
+  void VMScheduler::runFor(size_t microseconds)
+  {
+    int     nWorkers = int(workers.size());
+    doneLock.wait(0);
+    mutex_.lock();
+    pendingCnt = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+      if (jobs[i])
+        pendingCnt++;
+    }
+    mutex_.unlock();
+    if (!pendingCnt)
+      return;
+    // machines that have not been run yet are distributed evenly; all jobs
+    // are queued before any worker is woken up, otherwise the first ones
+    // would take the jobs queued for the others
+    int     nextWorker = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+      Job     *j = jobs[i];
+      if (!j)
+        continue;
+      j->vmThread->allowRunFor(microseconds);
+      int     n = j->stats.workerIndex;
+      if (n < 0 || n >= nWorkers) {
+        n = nextWorker;
+        nextWorker = (nextWorker + 1) % nWorkers;
+      }
+      Worker& w = *(workers[n]);
+      w.queueMutex.lock();
+      w.queue.push_back(j);
+      w.queueMutex.unlock();
+    }
+    for (int i = 0; i < nWorkers; i++)
+      workers[i]->wake();
+    doneLock.wait();
+  }
+
+  VMScheduler::Job * VMScheduler::getJob(int workerIndex)
+  {
+    Job     *j = (Job *) 0;
+    // take the first job from the own queue, or the last one from the
+    // queue of another worker that is busy running a job
+    int     nWorkers = int(workers.size());
+    for (int i = 0; i < nWorkers && !j; i++) {
+      Worker& w = *(workers[(workerIndex + i) % nWorkers]);
+      w.queueMutex.lock();
+      if (!w.queue.empty()) {
+        if (i == 0) {
+          j = w.queue.front();
+          w.queue.pop_front();
+        }
+        else if (w.busy) {
+          j = w.queue.back();
+          w.queue.pop_back();
+        }
+      }
+      w.queueMutex.unlock();
+    }
+    Worker& w = *(workers[workerIndex]);
+    w.queueMutex.lock();
+    w.busy = (j != (Job *) 0);
+    w.queueMutex.unlock();
+    return j;
+  }
+
+  void VMScheduler::queueJob(Job *j, int workerIndex)
+  {
+    Worker& w = *(workers[workerIndex]);
+    w.queueMutex.lock();
+    w.queue.push_back(j);
+    size_t  queueSize = w.queue.size();
+    w.queueMutex.unlock();
+    if (queueSize > 1) {
+      // more jobs are waiting than this worker can run, wake up any idle
+      // workers so that they can take some
+      mutex_.lock();
+      bool    idleFlag = (idleCnt > 0);
+      mutex_.unlock();
+      if (idleFlag) {
+        for (size_t i = 0; i < workers.size(); i++) {
+          if (int(i) != workerIndex)
+            workers[i]->wake();
+        }
+      }
+    }
+  }
+
+  void VMScheduler::runJob(Job *j, int workerIndex)
+  {
+    if (j->stats.workerIndex >= 0 && j->stats.workerIndex != workerIndex)
+      j->stats.migrationCnt++;
+    j->stats.workerIndex = workerIndex;
+    uint64_t  startTime = j->vmThread->getEmulatedTime();
+    Timer     t;
+    bool      moreTime = j->vmThread->runSlice(sliceLength);
+    j->stats.runTime += t.getRealTime();
+    Worker& w = *(workers[workerIndex]);
+    w.queueMutex.lock();
+    w.busy = false;
+    w.queueMutex.unlock();
+    j->stats.emulatedTime += (j->vmThread->getEmulatedTime() - startTime);
+    j->stats.sliceCnt++;
+    if (moreTime) {
+      queueJob(j, workerIndex);
+      return;
+    }
+    mutex_.lock();
+    pendingCnt--;
+    bool    doneFlag = (pendingCnt == 0);
+    mutex_.unlock();
+    if (doneFlag)
+      doneLock.notify();
+  }
+
+}       // namespace Ep128Emu
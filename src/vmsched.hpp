@@ -0,0 +1,100 @@
+
+// ep128emu -- portable Enterprise 128 emulator
+// Copyright (C) 2003-2017 Istvan Varga <istvanv@users.sourceforge.net>
+// https://sourceforge.net/projects/ep128emu/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#ifndef EP128EMU_VMSCHED_HPP
+#define EP128EMU_VMSCHED_HPP
+
+#include "ep128emu.hpp"
+#include "system.hpp"
+#include "vmthread.hpp"
+
+#include <vector>
+
+namespace Ep128Emu {
+
+  // Runs any number of virtual machines on a fixed pool of worker threads,
+  // instead of one emulation thread per machine. The machines are added as
+  // VMThread objects created without a thread of their own (see the
+  // VMThread constructor), and are run in time slices of sliceLength
+  // microseconds. Each worker has its own queue of machines; a machine that
+  // has not used up its run time yet is put back to the queue of the worker
+  // that has run it, so that it tends to stay on the same CPU core, and an
+  // idle worker takes machines from the end of the queue of the others
+  // that are busy running a machine.
+  // The workers are bound to CPU cores where this is supported.
+  // None of the functions may be called while runFor() is in progress.
+
+  class VMScheduler {
+   public:
+    struct VMStats {
+      // total emulated time in microseconds
+      uint64_t  emulatedTime;
+      // total time in seconds spent running the machine
+      double    runTime;
+      // number of time slices run
+      uint64_t  sliceCnt;
+      // number of time slices run on a different worker than the previous
+      // one
+      uint64_t  migrationCnt;
+      // the worker that has run the last time slice, or -1 if none yet
+      int       workerIndex;
+    };
+   private:
+    class Worker;
+    struct Job {
+      VMThread  *vmThread;
+      VMStats   stats;
+    };
+    std::vector< Worker * > workers;
+    std::vector< Job * >    jobs;
+    Mutex         mutex_;
+    ThreadLock    doneLock;
+    // number of machines that have not finished yet in runFor()
+    size_t        pendingCnt;
+    // number of workers waiting for a job
+    int           idleCnt;
+    size_t        sliceLength;
+    Job * getJob(int workerIndex);
+    void queueJob(Job *j, int workerIndex);
+    void runJob(Job *j, int workerIndex);
+   public:
+    // creates 'nWorkers' worker threads, or one per CPU core if 'nWorkers'
+    // is zero or negative
+    VMScheduler(int nWorkers = 0);
+    virtual ~VMScheduler();
+    inline int getWorkerCount() const
+    {
+      return int(workers.size());
+    }
+    // adds a machine, and returns its index for the functions below
+    int addVM(VMThread& vmThread_);
+    // removes machine 'n', which is no longer run by the scheduler
+    void removeVM(int n);
+    // allows all machines to run for 'microseconds' of emulated time (see
+    // VMThread::allowRunFor()), and returns when all of them have finished
+    void runFor(size_t microseconds);
+    // sets the length of a time slice in microseconds (default: 20000)
+    void setSliceLength(size_t microseconds);
+    // returns the throughput counters of machine 'n'
+    void getVMStats(int n, VMStats& s) const;
+  };
+
+}       // namespace Ep128Emu
+
+#endif  // EP128EMU_VMSCHED_HPP
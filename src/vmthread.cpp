@@ -36,8 +36,10 @@ static void dummyErrorCallback(void *userData_, const char *msg)
 
 namespace Ep128Emu {
 
-  VMThread::VMThread(VirtualMachine& vm_, void *userData_)
-    : vm(vm_),
+  VMThread::VMThread(VirtualMachine& vm_, void *userData_,
+                     bool createThread_)
+    : Thread(createThread_),
+      vm(vm_),
       lockCnt(0UL),
       threadLock1(true),
       threadLock2(true),
@@ -49,11 +51,15 @@ namespace Ep128Emu {
       joinFlag(false),
       errorFlag(false),
       pauseFlag(true),
+      threadFlag(createThread_),
+      holdMessages(false),
       timesliceLength(0.0f),
       avgTimesliceLength(0.002f),
       prvTime(0.0),
       nxtTime(0.0),
       allowedRuntime(0),
+      exactRunTime(false),
+      emulatedTime(0),
       userData(userData_),
       errorCallback(&defaultErrorCallback),
       processCallback((void (*)(void *)) 0)
@@ -129,7 +135,10 @@ namespace Ep128Emu {
         return false;
       }
       Message *m = messageQueue;
-      if (!m)
+      if (!m || holdMessages)
+        break;
+      // timed input is held back until the emulated time reaches it
+      if (m->emulatedTime > emulatedTime && !pauseFlag)
         break;
       messageQueue = m->nextMessage;
       if (!messageQueue)
@@ -156,10 +165,22 @@ namespace Ep128Emu {
       m->nextMessage = freeMessageStack;
       freeMessageStack = m;
     }
-    nxtTime += double(timesliceLength);
+    // if a timed message is due within this time slice, run only until then
+    size_t  runTime = 2000;
+    if (messageQueue && !holdMessages &&
+        messageQueue->emulatedTime > emulatedTime &&
+        messageQueue->emulatedTime < (emulatedTime + runTime)) {
+      runTime = size_t(messageQueue->emulatedTime - emulatedTime);
+    }
 #ifdef EP128EMU_LIBRETRO_CORE
     bool runAllowed = allowedRuntime >= 2000 ? true : false;
+    if (exactRunTime) {
+      runAllowed = (allowedRuntime > 0);
+      if (runTime > allowedRuntime)
+        runTime = allowedRuntime;
+    }
 #endif // EP128EMU_LIBRETRO_CORE
+    nxtTime += double(timesliceLength) * (double(runTime) / 2000.0);
     mutex_.unlock();
     // run emulation, or wait if paused
     double  curTime = prvTime;
@@ -171,7 +192,7 @@ namespace Ep128Emu {
 #else
       if (!pauseFlag) {
 #endif // EP128EMU_LIBRETRO_CORE
-        vm.run(2000);
+        vm.run(runTime);
         curTime = speedTimer.getRealTime();
         if (curTime < nxtTime)
           Timer::wait(nxtTime - curTime);
@@ -202,7 +223,13 @@ namespace Ep128Emu {
     // update status information
     mutex_.lock();
 #ifdef EP128EMU_LIBRETRO_CORE
-    if (runAllowed) allowedRuntime -= 2000;
+    if (runAllowed) {
+      allowedRuntime -= runTime;
+      emulatedTime += runTime;
+    }
+#else
+    if (!pauseFlag)
+      emulatedTime += runTime;
 #endif // EP128EMU_LIBRETRO_CORE
     float   deltaTime = float(curTime - prvTime);
     prvTime = curTime;
@@ -270,7 +297,7 @@ namespace Ep128Emu {
       return -1;
     }
     lockCnt++;
-    if (lockCnt > 1UL) {
+    if (lockCnt > 1UL || !threadFlag) {
       mutex_.unlock();
       return 0;
     }
@@ -298,7 +325,8 @@ namespace Ep128Emu {
     if (!lockCnt)
       threadLock1.notify();
     mutex_.unlock();
-    Timer::wait(0.0);           // allow the VM thread to actually wake up
+    if (threadFlag)
+      Timer::wait(0.0);         // allow the VM thread to actually wake up
   }
 
   // --------------------------------------------------------------------------
@@ -323,7 +351,10 @@ namespace Ep128Emu {
     }
     joinFlag = true;
     mutex_.unlock();
-    this->join();
+    if (threadFlag)
+      this->join();
+    else
+      this->cleanup();
   }
 
   void VMThread::setUserData(void *userData_)
@@ -356,6 +387,23 @@ namespace Ep128Emu {
                      keyCode_, isPressed_));
   }
 
+  void VMThread::setKeyboardState(const uint8_t *keyEvents_, size_t nEvents_,
+                                  uint64_t emulatedTime_)
+  {
+    while (nEvents_ > 0) {
+      size_t  n = nEvents_;
+      if (n > Message_KeyboardEvents::maxEvents)
+        n = Message_KeyboardEvents::maxEvents;
+      Message *m = allocateMessage<Message_KeyboardEvents,
+                                   const uint8_t *, size_t>(keyEvents_, n);
+      if (m)
+        m->emulatedTime = emulatedTime_;
+      queueMessage(m);
+      keyEvents_ = keyEvents_ + n;
+      nEvents_ = nEvents_ - n;
+    }
+  }
+
   void VMThread::setMouseState(int8_t dX, int8_t dY,
                                uint8_t buttonState, uint8_t mouseWheelEvents)
   {
@@ -423,13 +471,71 @@ namespace Ep128Emu {
     mutex_.unlock();
   }
 
+  void VMThread::setExactRunTime(bool n)
+  {
+    mutex_.lock();
+    exactRunTime = n;
+    mutex_.unlock();
+  }
+
+  uint64_t VMThread::getInputTime()
+  {
+    mutex_.lock();
+    uint64_t  t = emulatedTime + allowedRuntime;
+    mutex_.unlock();
+    return t;
+  }
+
+  uint64_t VMThread::getEmulatedTime()
+  {
+    mutex_.lock();
+    uint64_t  t = emulatedTime;
+    mutex_.unlock();
+    return t;
+  }
+
   bool VMThread::isReady(void)
   {
-    if (allowedRuntime > 2000)
+    if (allowedRuntime > (exactRunTime ? 0 : 2000))
       return false;
     else return true;
   }
 
+  bool VMThread::runLocked(bool holdMessages_)
+  {
+    bool    retval = true;
+    holdMessages = holdMessages_;
+    while (!isReady() && !pauseFlag) {
+      if (!process()) {
+        retval = false;
+        break;
+      }
+    }
+    holdMessages = false;
+    return retval;
+  }
+
+  bool VMThread::runSlice(size_t microseconds)
+  {
+    uint64_t  endTime = emulatedTime + microseconds;
+    while (!isReady() && !pauseFlag) {
+      if (emulatedTime >= endTime)
+        return true;
+      if (!process())
+        return false;
+    }
+    return false;
+  }
+
+  void VMThread::forkState(StateFork& f)
+  {
+    vm.forkState(f);
+    f.copy(emulatedTime);
+    size_t  t = allowedRuntime;
+    f.copy(t);
+    allowedRuntime = t;
+  }
+
 
   VMThread::Message * VMThread::allocateMessage_()
   {
@@ -513,6 +619,22 @@ namespace Ep128Emu {
     }
   }
 
+  VMThread::Message_KeyboardEvents::~Message_KeyboardEvents()
+  {
+  }
+
+  void VMThread::Message_KeyboardEvents::process()
+  {
+    for (uint8_t i = 0; i < nEvents; i++) {
+      uint8_t keyCode = keyEvents[i] & 0x7F;
+      bool    isPressed = bool(keyEvents[i] & 0x80);
+      if (vmThread.keyboardState[keyCode] != isPressed) {
+        vmThread.keyboardState[keyCode] = isPressed;
+        vmThread.vm.setKeyboardState(keyCode, isPressed);
+      }
+    }
+  }
+
   VMThread::Message_MouseEvent::~Message_MouseEvent()
   {
   }
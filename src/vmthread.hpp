@@ -54,18 +54,34 @@ namespace Ep128Emu {
     bool            joinFlag;
     bool            errorFlag;
     bool            pauseFlag;
+    // false if the object was created without an emulation thread
+    bool            threadFlag;
+    // if true, process() does not process queued messages
+    bool            holdMessages;
     float           timesliceLength;
     float           avgTimesliceLength;
     double          prvTime;
     double          nxtTime;
     volatile size_t allowedRuntime;
+    // if true, the time allowed with allowRunFor() is run exactly, instead
+    // of leaving any remainder shorter than a time slice for the next call
+    bool            exactRunTime;
+    // total emulated time in microseconds (the sum of time slices run)
+    uint64_t        emulatedTime;
     VirtualMachine::VMStatus  vmStatus;
     void            *userData;
     void            (*errorCallback)(void *userData_, const char *msg);
     void            (*processCallback)(void *userData_);
     bool            keyboardState[128];
    public:
-    VMThread(VirtualMachine& vm_, void *userData_ = (void *) 0);
+    /*!
+     * If 'createThread_' is false, no emulation thread is created, and
+     * the virtual machine is only run by calls to process(), runLocked()
+     * or runSlice() (e.g. from a VMScheduler worker thread); lock() and
+     * unlock() then only maintain the lock count.
+     */
+    VMThread(VirtualMachine& vm_, void *userData_ = (void *) 0,
+             bool createThread_ = true);
     virtual ~VMThread();
     /*!
      * Block the execution of the emulation thread, so that the main thread
@@ -91,10 +107,38 @@ namespace Ep128Emu {
      * Allow execution for a short period of time (one frame of frontend)
      */
     void allowRunFor(size_t microseconds);
+    /*!
+     * If 'n' is true, the time allowed with allowRunFor() is run to the
+     * microsecond, with a shorter last time slice if needed. Otherwise
+     * (the default), the emulation stops when less than one time slice
+     * (2000 microseconds) is left, and the remainder is added to the time
+     * allowed by the next call.
+     */
+    void setExactRunTime(bool n);
     /*!
      * True if VM has already consumed the execution time set up in allowRunFor.
      */
     bool isReady(void);
+    /*!
+     * Run the emulation in the calling thread until isReady() returns true;
+     * lock() must be called first. If
+     * 'holdMessages_' is true, queued messages are left in the queue, so
+     * that they are not lost if the state is restored with forkState().
+     * Returns false after quit() was called or a fatal error occured.
+     */
+    bool runLocked(bool holdMessages_ = false);
+    /*!
+     * Run at most 'microseconds' of the time allowed with allowRunFor()
+     * in the calling thread; lock() must be called first. Returns true if
+     * there is still run time left, and false if isReady() is true, the
+     * emulation is paused, or quit() was called or a fatal error occured.
+     */
+    bool runSlice(size_t microseconds);
+    /*!
+     * Save or restore the state of the virtual machine and the emulated
+     * time (see VirtualMachine::forkState()); lock() must be called first.
+     */
+    void forkState(StateFork& f);
     /*!
      * Pause emulation if 'n' is true, or continue if 'n' is false.
      * NOTE: the initial state is pause=true.
@@ -127,6 +171,27 @@ namespace Ep128Emu {
      * Set state of key 'keyCode_' (0 to 127).
      */
     void setKeyboardState(uint8_t keyCode_, bool isPressed_);
+    /*!
+     * Set the state of multiple keys, using as few messages as possible.
+     * Bits 0 to 6 of each element of 'keyEvents_' are the key code, and
+     * bit 7 is set if the key is pressed. The events are processed in the
+     * order in which they are stored in the array.
+     * If 'emulatedTime_' is non-zero, the events are applied when the
+     * emulated time (see getInputTime()) reaches this value, so that the
+     * result does not depend on the scheduling of the emulation thread.
+     * Messages queued later are not processed until then either.
+     */
+    void setKeyboardState(const uint8_t *keyEvents_, size_t nEvents_,
+                          uint64_t emulatedTime_ = 0);
+    /*!
+     * Returns the emulated time in microseconds at which the run time
+     * granted by the next call to allowRunFor() will start.
+     */
+    uint64_t getInputTime();
+    /*!
+     * Returns the total emulated time in microseconds.
+     */
+    uint64_t getEmulatedTime();
     /*!
      * Send mouse event to the emulated machine. 'dX' and 'dY' are the
      * horizontal and vertical motion of the pointer relative to the position
@@ -195,9 +260,12 @@ namespace Ep128Emu {
       VMThread& vmThread;
      public:
       Message   *nextMessage;
+      // emulated time at which the message is processed, 0: immediately
+      uint64_t  emulatedTime;
       Message(VMThread& vmThread_)
         : vmThread(vmThread_),
-          nextMessage((Message *) 0)
+          nextMessage((Message *) 0),
+          emulatedTime(0)
       {
       }
       virtual ~Message();
@@ -242,6 +310,25 @@ namespace Ep128Emu {
       virtual ~Message_KeyboardEvent();
       virtual void process();
     };
+    class Message_KeyboardEvents : public Message {
+     public:
+      // must fit in the space of Message_Dummy
+      static const size_t maxEvents = 15;
+     private:
+      uint8_t nEvents;
+      uint8_t keyEvents[maxEvents];
+     public:
+      Message_KeyboardEvents(VMThread& vmThread_,
+                             const uint8_t *keyEvents_, size_t nEvents_)
+        : Message(vmThread_),
+          nEvents(uint8_t(nEvents_))
+      {
+        for (size_t i = 0; i < nEvents_; i++)
+          keyEvents[i] = keyEvents_[i];
+      }
+      virtual ~Message_KeyboardEvents();
+      virtual void process();
+    };
     class Message_MouseEvent : public Message {
      private:
       uint32_t  mouseData;
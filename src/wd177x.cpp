@@ -641,6 +641,12 @@ namespace Ep128Emu {
     writeTrackState = 0xFF;
   }
 
+  void WD177x::forkState(StateFork& f)
+  {
+    // the floppy drives are not included, see Ep128VM::getIsStateForkAllowed()
+    EP128EMU_FORK_RANGE(f, WD177x, floppyDrive, writeTrackState);
+  }
+
   void WD177x::interruptRequest()
   {
   }
@@ -101,6 +101,7 @@ namespace Ep128Emu {
     }
     void setEnableBusyFlagHack(bool isEnabled);
     virtual void reset(bool isColdReset);
+    void forkState(StateFork&);
    protected:
     virtual void interruptRequest();
     virtual void clearInterruptRequest();
@@ -127,14 +127,32 @@ namespace ZX128 {
     }
   }
 
+  EP128EMU_INLINE void ZX128VM::videoMemoryWrite(uint16_t addr)
+  {
+    // the ULA renders display lines lazily, update it before the write
+    if ((addr & 0x3FFF) < 0x1B00 && isContendedAddress(addr))
+      ula.updateDisplay();
+  }
+
+  EP128EMU_INLINE bool ZX128VM::runHaltCycle()
+  {
+    // repeat the HALT opcode fetch with the same timing as
+    // Z80_::readOpcodeFirstByte(), but without reading and decoding the
+    // opcode, unless breakpoints, single step mode or the tape loader
+    // hook need the read
+    uint16_t  addr = uint16_t(z80.getReg().PC.W.l);
+    if (singleStepMode || memory.getHaveBreakPoints() || addr == 0x05E7)
+      return false;
+    memoryWaitM1(addr);
+    updateCPUHalfCycles(4);
+    z80.executeHaltCycle();
+    return true;
+  }
+
   EP128EMU_REGPARM1 void ZX128VM::runOneCycle()
   {
-    ZX128VMCallback *p = firstCallback;
-    while (p) {
-      ZX128VMCallback *nxt = p->nxt;
-      p->func(p->userData);
-      p = nxt;
-    }
+    if (EP128EMU_UNLIKELY(!(--callbackCyclesRemaining)))
+      runCallbacks();
     if (--ayCycleCnt == 0) {
       ayCycleCnt = 4;
       uint32_t  tmp = soundOutputAccumulator;
@@ -266,6 +284,43 @@ namespace ZX128 {
     return retval;
   }
 
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_REGPARM1 uint32_t ZX128VM::Z80_::readOpcodeFirstByteDecoded()
+  {
+    // readOpcodeFirstByte(), followed by the memory timing of the operand
+    // reads that the predecoded instruction already includes
+    uint16_t  addr = uint16_t(R.PC.W.l);
+    uint32_t  retval = 0U;
+    if (EP128EMU_EXPECT(!(vm.singleStepMode ||
+                          vm.memory.getHaveBreakPoints() || addr == 0x05E7))) {
+      retval = vm.memory.readOpcodeDecoded(addr);
+    }
+    if (EP128EMU_UNLIKELY(!retval))
+      return (Z80_PREDECODED_VALID | uint32_t(Z80_::readOpcodeFirstByte()));
+    addressBusState.B.h = R.I;
+    vm.memoryWaitM1(addr);
+    vm.updateCPUHalfCycles(4);
+    switch ((retval >> 24) & 3U) {
+    case 1U:
+      addr = (addr + 1) & 0xFFFF;
+      addressBusState.W = addr;
+      vm.memoryWait(addr);
+      vm.updateCPUHalfCycles(1);
+      break;
+    case 2U:
+      addr = (addr + 1) & 0xFFFF;
+      vm.memoryWait(addr);
+      vm.updateCPUHalfCycles(1);
+      addr = (addr + 1) & 0xFFFF;
+      addressBusState.W = addr;
+      vm.memoryWait(addr);
+      vm.updateCPUHalfCycles(1);
+      break;
+    }
+    return retval;
+  }
+#endif
+
   EP128EMU_REGPARM3 void ZX128VM::Z80_::writeMemory(uint16_t addr,
                                                     uint8_t value)
   {
@@ -273,6 +328,7 @@ namespace ZX128 {
     vm.memoryWait(addr);
     while (vm.z80OpcodeHalfCycles >= 8)
       vm.runOneCycle();
+    vm.videoMemoryWrite(addr);
     vm.memory.write(addr, value);
     vm.updateCPUHalfCycles(1);
   }
@@ -283,6 +339,7 @@ namespace ZX128 {
     vm.memoryWait(addr);
     while (vm.z80OpcodeHalfCycles >= 8)
       vm.runOneCycle();
+    vm.videoMemoryWrite(addr);
     vm.memory.write(addr, uint8_t(value) & 0xFF);
     vm.updateCPUHalfCycles(1);
     addr = (addr + 1) & 0xFFFF;
@@ -290,6 +347,7 @@ namespace ZX128 {
     vm.memoryWait(addr);
     while (vm.z80OpcodeHalfCycles >= 8)
       vm.runOneCycle();
+    vm.videoMemoryWrite(addr);
     vm.memory.write(addr, uint8_t(value >> 8));
     vm.updateCPUHalfCycles(1);
   }
@@ -306,11 +364,13 @@ namespace ZX128 {
     vm.memoryWait((addr + 1) & 0xFFFF);
     while (vm.z80OpcodeHalfCycles >= 8)
       vm.runOneCycle();
+    vm.videoMemoryWrite((addr + 1) & 0xFFFF);
     vm.memory.write((addr + 1) & 0xFFFF, uint8_t(value >> 8));
     vm.updateCPUHalfCycles(1);
     vm.memoryWait(addr);
     while (vm.z80OpcodeHalfCycles >= 8)
       vm.runOneCycle();
+    vm.videoMemoryWrite(addr);
     vm.memory.write(addr, uint8_t(value) & 0xFF);
     vm.updateCPUHalfCycles(1);
   }
@@ -642,7 +702,7 @@ namespace ZX128 {
     return retval;
   }
 
-  void ZX128VM::tapeCallback(void *userData)
+  uint32_t ZX128VM::tapeCallback(void *userData)
   {
     ZX128VM&  vm = *(reinterpret_cast<ZX128VM *>(userData));
     vm.tapeSamplesRemaining += vm.tapeSamplesPerULACycle;
@@ -651,9 +711,20 @@ namespace ZX128 {
       vm.tapeSamplesRemaining -= (int64_t(1) << 32);
       vm.ula.setTapeInput(vm.runTape(vm.ula.getTapeOutput()));
     }
+    // number of cycles until the next sample
+    uint32_t  n = 0x40000000U;
+    if (vm.tapeSamplesRemaining > 0) {
+      n = 1U;
+    }
+    else if (vm.tapeSamplesPerULACycle > 0) {
+      int64_t tmp = (-vm.tapeSamplesRemaining) / vm.tapeSamplesPerULACycle + 1;
+      n = uint32_t(tmp < 0x40000000 ? tmp : 0x40000000);
+    }
+    vm.tapeSamplesRemaining += (int64_t(n - 1U) * vm.tapeSamplesPerULACycle);
+    return n;
   }
 
-  void ZX128VM::demoPlayCallback(void *userData)
+  uint32_t ZX128VM::demoPlayCallback(void *userData)
   {
     ZX128VM&  vm = *(reinterpret_cast<ZX128VM *>(userData));
     while (!vm.demoTimeCnt) {
@@ -693,20 +764,25 @@ namespace ZX128 {
         break;
       }
     }
-    if (vm.demoTimeCnt)
-      vm.demoTimeCnt--;
+    // wait until the next event
+    uint32_t  n = uint32_t(vm.demoTimeCnt < 0x40000000U ?
+                           vm.demoTimeCnt : 0x40000000U);
+    vm.demoTimeCnt -= n;
+    return (n > 0U ? n : 1U);
   }
 
-  void ZX128VM::demoRecordCallback(void *userData)
+  uint32_t ZX128VM::demoRecordCallback(void *userData)
   {
     ZX128VM&  vm = *(reinterpret_cast<ZX128VM *>(userData));
     vm.demoTimeCnt++;
+    return 1U;
   }
 
-  void ZX128VM::videoCaptureCallback(void *userData)
+  uint32_t ZX128VM::videoCaptureCallback(void *userData)
   {
     ZX128VM&  vm = *(reinterpret_cast<ZX128VM *>(userData));
     vm.videoCapture->runOneCycle(vm.soundOutputSignal);
+    return 1U;
   }
 
   uint8_t ZX128VM::checkSingleStepModeBreak()
@@ -824,8 +900,8 @@ namespace ZX128 {
     }
   }
 
-  void ZX128VM::setCallback(void (*func)(void *userData), void *userData_,
-                            bool isEnabled)
+  void ZX128VM::setCallback(uint32_t (*func)(void *userData),
+                            void *userData_, bool isEnabled)
   {
     if (!func)
       return;
@@ -852,7 +928,7 @@ namespace ZX128 {
         p = p->nxt;
       }
       if (!isEnabled) {
-        callbacks[ndx].func = (void (*)(void *)) 0;
+        callbacks[ndx].func = (uint32_t (*)(void *)) 0;
         callbacks[ndx].userData = (void *) 0;
         callbacks[ndx].nxt = (ZX128VMCallback *) 0;
       }
@@ -861,7 +937,7 @@ namespace ZX128 {
       return;
     if (ndx < 0) {
       for (size_t i = 0; i < maxCallbacks; i++) {
-        if (callbacks[i].func == (void (*)(void *)) 0) {
+        if (callbacks[i].func == (uint32_t (*)(void *)) 0) {
           ndx = int(i);
           break;
         }
@@ -872,6 +948,12 @@ namespace ZX128 {
     callbacks[ndx].func = func;
     callbacks[ndx].userData = userData_;
     callbacks[ndx].nxt = (ZX128VMCallback *) 0;
+    // schedule the function for the next cycle
+    callbacks[ndx].delay = (callbackCycles - callbackCyclesRemaining) + 1U;
+    if (callbackCyclesRemaining > 1U) {
+      callbackCycles = callbackCycles - callbackCyclesRemaining + 1U;
+      callbackCyclesRemaining = 1U;
+    }
     if (isEnabled) {
       ZX128VMCallback   *prv = (ZX128VMCallback *) 0;
       ZX128VMCallback   *p = firstCallback;
@@ -887,6 +969,30 @@ namespace ZX128 {
     }
   }
 
+  void ZX128VM::runCallbacks()
+  {
+    // make the delays relative to the current cycle
+    ZX128VMCallback   *p = firstCallback;
+    while (p) {
+      p->delay -= callbackCycles;
+      p = p->nxt;
+    }
+    callbackCycles = 0U;
+    callbackCyclesRemaining = 0U;
+    p = firstCallback;
+    while (p) {
+      ZX128VMCallback *nxt = p->nxt;
+      if (!p->delay)
+        p->delay = p->func(p->userData);
+      p = nxt;
+    }
+    uint32_t  n = 0x40000000U;
+    for (p = firstCallback; p; p = p->nxt)
+      n = (p->delay < n ? p->delay : n);
+    callbackCycles = n;
+    callbackCyclesRemaining = n;
+  }
+
   // --------------------------------------------------------------------------
 
   ZX128VM::ZX128VM(Ep128Emu::VideoDisplay& display_,
@@ -918,15 +1024,18 @@ namespace ZX128 {
       demoTimeCnt(0UL),
       breakPointPriorityThreshold(0),
       firstCallback((ZX128VMCallback *) 0),
+      callbackCycles(1U),
+      callbackCyclesRemaining(1U),
       videoCapture((Ep128Emu::VideoCapture *) 0),
       tapeSamplesPerULACycle(0L),
       tapeSamplesRemaining(0L),
       ulaFrequency(886724)
   {
     for (size_t i = 0; i < (sizeof(callbacks) / sizeof(ZX128VMCallback)); i++) {
-      callbacks[i].func = (void (*)(void *)) 0;
+      callbacks[i].func = (uint32_t (*)(void *)) 0;
       callbacks[i].userData = (void *) 0;
       callbacks[i].nxt = (ZX128VMCallback *) 0;
+      callbacks[i].delay = 0U;
     }
     // register I/O callbacks
     ioPorts.setCallbackUserData((void *) this);
@@ -985,7 +1094,10 @@ namespace ZX128 {
     ulaCyclesRemainingL = uint32_t(uint64_t(ulaCyclesRemaining) & 0xFFFFFFFFUL);
     ulaCyclesRemainingH = int32_t(ulaCyclesRemaining >> 32);
     while (EP128EMU_EXPECT(ulaCyclesRemainingH > 0)) {
-      z80.executeInstruction();
+      // while the CPU is waiting for an interrupt in HALT, only the timing
+      // of the repeated opcode fetches needs to be emulated
+      if (EP128EMU_EXPECT(!z80.isExecutingHalt()) || !runHaltCycle())
+        z80.executeInstruction();
       if (EP128EMU_EXPECT(z80OpcodeHalfCycles >= 8)) {
         do {
           runOneCycle();
@@ -1349,6 +1461,18 @@ namespace ZX128 {
     return nullptr;
   }
 
+  void ZX128VM::getMemoryUsage(MemoryUsage& memoryUsage_) const
+  {
+    memory.getMemoryUsage(memoryUsage_.ramSize, memoryUsage_.romSize,
+                          memoryUsage_.sharedROMSize, memoryUsage_.tableSize);
+    memoryUsage_.machineSize = sizeof(ZX128VM);
+  }
+
+  uint64_t ZX128VM::getInstructionCount() const
+  {
+    return z80.getInstructionCount();
+  }
+
   uint8_t ZX128VM::readMemory(uint32_t addr, bool isCPUAddress) const
   {
     if (isCPUAddress)
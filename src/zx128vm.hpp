@@ -61,6 +61,9 @@ namespace ZX128 {
                                            (bool *) 0);
       virtual EP128EMU_REGPARM2 uint8_t readOpcodeByte(int offset);
       virtual EP128EMU_REGPARM2 uint16_t readOpcodeWord(int offset);
+#ifdef Z80_DECODE_CACHE
+      virtual EP128EMU_REGPARM1 uint32_t readOpcodeFirstByteDecoded();
+#endif
       virtual EP128EMU_REGPARM3 void writeMemory(uint16_t addr, uint8_t value);
       virtual EP128EMU_REGPARM3 void writeMemoryWord(uint16_t addr,
                                                      uint16_t value);
@@ -74,6 +77,11 @@ namespace ZX128 {
      public:
       void rewindTapeFile();
       void closeTapeFile();
+      inline bool haveTapeFile() const
+      {
+        return (tapFile != (std::FILE *) 0);
+      }
+      virtual void forkState(Ep128Emu::StateFork& f);
     };
     class Memory_ : public Memory {
      private:
@@ -152,12 +160,15 @@ namespace ZX128 {
     uint64_t  demoTimeCnt;
     uint8_t   breakPointPriorityThreshold;
     struct ZX128VMCallback {
-      void      (*func)(void *);
+      uint32_t  (*func)(void *);
       void      *userData;
       ZX128VMCallback *nxt;
+      uint32_t  delay;
     };
     ZX128VMCallback   callbacks[16];
     ZX128VMCallback   *firstCallback;
+    uint32_t  callbackCycles;           // length of the current wait
+    uint32_t  callbackCyclesRemaining;  // until the next callback is due
     Ep128Emu::VideoCapture  *videoCapture;
     int64_t   tapeSamplesPerULACycle;
     int64_t   tapeSamplesRemaining;
@@ -171,25 +182,33 @@ namespace ZX128 {
     EP128EMU_INLINE void memoryWait(uint16_t addr);
     EP128EMU_INLINE void memoryWaitM1(uint16_t addr);
     EP128EMU_INLINE void ioPortWait(uint16_t addr);
+    EP128EMU_INLINE void videoMemoryWrite(uint16_t addr);
+    // runs one cycle of a CPU executing HALT without decoding the opcode,
+    // returns false if the instruction needs to be executed normally
+    EP128EMU_INLINE bool runHaltCycle();
     EP128EMU_REGPARM1 void runOneCycle();
     static uint8_t ioPortReadCallback(void *userData, uint16_t addr);
     static void ioPortWriteCallback(void *userData,
                                     uint16_t addr, uint8_t value);
     static uint8_t ioPortDebugReadCallback(void *userData, uint16_t addr);
-    static void tapeCallback(void *userData);
-    static void demoPlayCallback(void *userData);
-    static void demoRecordCallback(void *userData);
-    static void videoCaptureCallback(void *userData);
+    static uint32_t tapeCallback(void *userData);
+    static uint32_t demoPlayCallback(void *userData);
+    static uint32_t demoRecordCallback(void *userData);
+    static uint32_t videoCaptureCallback(void *userData);
     void stopDemoPlayback();
     void stopDemoRecording(bool writeFile_);
     uint8_t checkSingleStepModeBreak();
     void convertKeyboardState();
     void resetKeyboard();
     void initializeMemoryPaging();
-    // Set function to be called at every ULA cycle. The functions are called
-    // in the order of being registered; up to 16 callbacks can be set.
-    void setCallback(void (*func)(void *userData), void *userData_,
+    // Set function to be called at the next ULA cycle. The function returns
+    // the number of cycles (>= 1) until it is to be called again. Functions
+    // that are due in the same cycle are called in the order of being
+    // registered; up to 16 callbacks can be set.
+    void setCallback(uint32_t (*func)(void *userData), void *userData_,
                      bool isEnabled);
+    // Call the functions that are due, and schedule the next call.
+    void runCallbacks();
    public:
     ZX128VM(Ep128Emu::VideoDisplay&, Ep128Emu::AudioOutput&);
     virtual ~ZX128VM();
@@ -313,6 +332,11 @@ namespace ZX128 {
      * Returns a memory pointer to page 'n' (0x00 to 0xFF).
      */
     virtual void * getSegmentPtr(int n) const;
+    /*!
+     * Returns the number of bytes allocated by the emulated machine.
+     */
+    virtual void getMemoryUsage(MemoryUsage& memoryUsage_) const;
+    virtual uint64_t getInstructionCount() const;
     /*!
      * Read a byte from memory. If 'isCPUAddress' is false, bits 14 to 21 of
      * 'addr' define the segment number, while bits 0 to 13 are the offset
@@ -447,6 +471,16 @@ namespace ZX128 {
      * playing a demo.
      */
     virtual bool getIsPlayingDemo() const;
+    /*!
+     * Returns true if the state can be saved with forkState(); this is false
+     * while tape, disk or file I/O, demo recording or playback, or video
+     * capture is in progress.
+     */
+    virtual bool getIsStateForkAllowed() const;
+    /*!
+     * Save or restore the state of the emulated machine for run-ahead.
+     */
+    virtual void forkState(Ep128Emu::StateFork& f);
     // ----------------
     virtual void loadState(Ep128Emu::File::Buffer&);
     virtual void loadMachineConfiguration(Ep128Emu::File::Buffer&);
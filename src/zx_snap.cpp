@@ -94,6 +94,35 @@ namespace ZX128 {
     return isPlayingDemo;
   }
 
+  bool ZX128VM::getIsStateForkAllowed() const
+  {
+    if (isRecordingDemo || isPlayingDemo || demoFile || videoCapture)
+      return false;
+    if (haveTape() && getTapeButtonState() != 0)
+      return false;
+    return !z80.haveTapeFile();
+  }
+
+  void ZX128VM::Z80_::forkState(Ep128Emu::StateFork& f)
+  {
+    Ep128::Z80::forkState(f);
+    f.copy(addressBusState);
+  }
+
+  void ZX128VM::forkState(Ep128Emu::StateFork& f)
+  {
+    Ep128Emu::VirtualMachine::forkState(f);
+    z80.forkState(f);
+    memory.forkState(f);
+    ay3.forkState(f);
+    ula.forkState(f);
+    EP128EMU_FORK_RANGE(f, ZX128VM, ulaCyclesRemainingL, soundOutputSignal);
+    f.copy(snapshotLoadFlag);
+    EP128EMU_FORK_RANGE(f, ZX128VM, callbacks, callbackCyclesRemaining);
+    f.copy(tapeSamplesRemaining);
+    f.copy(keyboardState);
+  }
+
   // --------------------------------------------------------------------------
 
   void ZX128VM::loadState(Ep128Emu::File::Buffer& buf)
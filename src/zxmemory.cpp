@@ -22,249 +22,20 @@
 
 namespace ZX128 {
 
-  void Memory::allocateSegment(uint8_t n, bool isROM)
-  {
-    if (segmentTable[n] == (uint8_t *) 0)
-      segmentTable[n] = new uint8_t[16384];
-    segmentROMTable[n] = isROM;
-    for (uint8_t i = 0; i < 4; i++)
-      setPage(i, getPage(i));
-  }
-
-  void Memory::checkExecuteBreakPoint(uint16_t addr, uint8_t page,
-                                      uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 36) == 4) {
-      breakPointCallback(false, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 36) == 4) {
-        breakPointCallback(false, addr, value);
-      }
-    }
-  }
-
-  void Memory::checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 1) != 0) {
-      breakPointCallback(false, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 1) != 0) {
-        breakPointCallback(false, addr, value);
-      }
-    }
-  }
-
-  void Memory::checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value)
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 &&
-        tbl[addr] >= breakPointPriorityThreshold && (tbl[addr] & 2) != 0) {
-      breakPointCallback(true, addr, value);
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[page]];
-      if (tbl != (uint8_t *) 0 &&
-          tbl[offs] >= breakPointPriorityThreshold && (tbl[offs] & 2) != 0) {
-        breakPointCallback(true, addr, value);
-      }
-    }
-  }
-
   Memory::Memory()
-    : segmentTable((uint8_t **) 0),
-      segmentROMTable((bool *) 0),
-      breakPointTable((uint8_t *) 0),
-      breakPointCnt(0),
-      segmentBreakPointTable((uint8_t **) 0),
-      segmentBreakPointCntTable((size_t *) 0),
-      haveBreakPoints(false),
-      breakPointPriorityThreshold(0),
-      dummyMemory((uint8_t *) 0)
+    : Ep128Emu::MemoryBase()
   {
     for (int i = 0; i < 4; i++) {
       pageTable[i] = 0;
       pageAddressTableR[i] = (uint8_t *) 0;
       pageAddressTableW[i] = (uint8_t *) 0;
     }
-    try {
-      segmentTable = new uint8_t*[256];
-      for (int i = 0; i < 256; i++)
-        segmentTable[i] = (uint8_t *) 0;
-      segmentROMTable = new bool[256];
-      for (int i = 0; i < 256; i++)
-        segmentROMTable[i] = true;
-      segmentBreakPointTable = new uint8_t*[256];
-      for (int i = 0; i < 256; i++)
-        segmentBreakPointTable[i] = (uint8_t *) 0;
-      segmentBreakPointCntTable = new size_t[256];
-      for (int i = 0; i < 256; i++)
-        segmentBreakPointCntTable[i] = 0;
-      dummyMemory = new uint8_t[32768];
-      for (int i = 0; i < 32768; i++)
-        dummyMemory[i] = 0xFF;
-      for (uint8_t i = 0; i < 4; i++)
-        setPage(i, 0x00);
-    }
-    catch (...) {
-      if (segmentTable) {
-        delete[] segmentTable;
-        segmentTable = (uint8_t **) 0;
-      }
-      if (segmentROMTable) {
-        delete[] segmentROMTable;
-        segmentROMTable = (bool *) 0;
-      }
-      if (segmentBreakPointTable) {
-        delete[] segmentBreakPointTable;
-        segmentBreakPointTable = (uint8_t **) 0;
-      }
-      if (segmentBreakPointCntTable) {
-        delete[] segmentBreakPointCntTable;
-        segmentBreakPointCntTable = (size_t *) 0;
-      }
-      if (dummyMemory) {
-        delete[] dummyMemory;
-        dummyMemory = (uint8_t *) 0;
-      }
-      throw;
-    }
+    for (uint8_t i = 0; i < 4; i++)
+      setPage(i, 0x00);
   }
 
   Memory::~Memory()
   {
-    for (int i = 0; i < 256; i++) {
-      if (segmentTable[i])
-        delete[] segmentTable[i];
-    }
-    delete[] dummyMemory;
-    delete[] segmentTable;
-    delete[] segmentROMTable;
-    if (breakPointTable)
-      delete[] breakPointTable;
-    for (int i = 0; i < 256; i++) {
-      if (segmentBreakPointTable[i])
-        delete[] segmentBreakPointTable[i];
-    }
-    delete[] segmentBreakPointTable;
-    delete[] segmentBreakPointCntTable;
-  }
-
-  void Memory::setBreakPoint(uint8_t segment, uint16_t addr, int priority,
-                             bool r, bool w, bool x, bool ignoreFlag)
-  {
-    uint8_t mode =
-        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
-    if (mode) {
-      // create new breakpoint, or change existing one
-      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
-      if (!segmentBreakPointTable[segment]) {
-        segmentBreakPointTable[segment] = new uint8_t[16384];
-        for (int i = 0; i < 16384; i++)
-          segmentBreakPointTable[segment][i] = 0;
-      }
-      haveBreakPoints = true;
-      uint8_t&  bp = segmentBreakPointTable[segment][addr & 0x3FFF];
-      if (!bp)
-        segmentBreakPointCntTable[segment]++;
-      if (bp > mode)
-        mode = (bp & 56) + (mode & 7);
-      mode |= (bp & 7);
-      bp = mode;
-    }
-    else if (segmentBreakPointTable[segment]) {
-      if (segmentBreakPointTable[segment][addr & 0x3FFF]) {
-        // remove a previously existing breakpoint
-        segmentBreakPointCntTable[segment]--;
-        if (!segmentBreakPointCntTable[segment]) {
-          delete[] segmentBreakPointTable[segment];
-          segmentBreakPointTable[segment] = (uint8_t *) 0;
-        }
-      }
-    }
-  }
-
-  void Memory::setBreakPoint(uint16_t addr, int priority,
-                             bool r, bool w, bool x, bool ignoreFlag)
-  {
-    uint8_t mode =
-        (r ? 1 : 0) + (w ? 2 : 0) + (x ? 4 : 0) + (ignoreFlag ? 32 : 0);
-    if (mode) {
-      // create new breakpoint, or change existing one
-      mode += uint8_t((priority > 0 ? (priority < 3 ? priority : 3) : 0) << 3);
-      if (!breakPointTable) {
-        breakPointTable = new uint8_t[65536];
-        for (int i = 0; i < 65536; i++)
-          breakPointTable[i] = 0;
-      }
-      haveBreakPoints = true;
-      uint8_t&  bp = breakPointTable[addr];
-      if (!bp)
-        breakPointCnt++;
-      if (bp > mode)
-        mode = (bp & 56) + (mode & 7);
-      mode |= (bp & 7);
-      bp = mode;
-    }
-    else if (breakPointTable) {
-      if (breakPointTable[addr]) {
-        // remove a previously existing breakpoint
-        breakPointCnt--;
-        if (!breakPointCnt) {
-          delete[] breakPointTable;
-          breakPointTable = (uint8_t *) 0;
-        }
-      }
-    }
-  }
-
-  void Memory::clearBreakPoints(uint8_t segment)
-  {
-    for (uint16_t addr = 0; addr < 16384; addr++)
-      setBreakPoint(segment, addr, 0, false, false, false, false);
-  }
-
-  void Memory::clearBreakPoints()
-  {
-    for (unsigned int addr = 0; addr < 65536; addr++)
-      setBreakPoint((uint16_t) addr, 0, false, false, false, false);
-  }
-
-  void Memory::clearAllBreakPoints()
-  {
-    clearBreakPoints();
-    for (unsigned int segment = 0; segment < 256; segment++)
-      clearBreakPoints((uint8_t) segment);
-    haveBreakPoints = false;
-  }
-
-  void Memory::breakPointCallback(bool isWrite, uint16_t addr, uint8_t value)
-  {
-    (void) isWrite;
-    (void) addr;
-    (void) value;
-  }
-
-  void Memory::setBreakPointPriorityThreshold(int n)
-  {
-    breakPointPriorityThreshold = uint8_t((n > 0 ? (n < 4 ? n : 4) : 0) << 3);
-  }
-
-  int Memory::getBreakPointPriorityThreshold()
-  {
-    return int(breakPointPriorityThreshold >> 3);
   }
 
   void Memory::loadSegment(uint8_t segment, bool isROM,
@@ -278,6 +49,7 @@ namespace ZX128 {
       return;
     }
     // allocate memory for segment if necessary
+    uint8_t firstSegment = segment;
     allocateSegment(segment, isROM);
     size_t  i = 0;
     if (dataSize) {
@@ -294,16 +66,10 @@ namespace ZX128 {
     }
     for ( ; i < 0x4000 || (i & 0x3FFF) != 0; i++)
       segmentTable[segment][i & 0x3FFF] = 0x00;
-  }
-
-  void Memory::deleteSegment(uint8_t segment)
-  {
-    if (segmentTable[segment])
-      delete[] segmentTable[segment];
-    segmentTable[segment] = (uint8_t *) 0;
-    segmentROMTable[segment] = true;
-    for (uint8_t i = 0; i < 4; i++)
-      setPage(i, getPage(i));
+    if (isROM) {
+      for (size_t j = 0; j < (i >> 14); j++)
+        shareSegment(uint8_t((firstSegment + j) & 0xFF));
+    }
   }
 
   void Memory::deleteAllSegments()
@@ -312,6 +78,12 @@ namespace ZX128 {
       deleteSegment(uint8_t(segment));
   }
 
+  void Memory::updatePaging()
+  {
+    for (uint8_t i = 0; i < 4; i++)
+      setPage(i, getPage(i));
+  }
+
   void Memory::setPage(uint8_t page, uint8_t segment)
   {
     page = page & 3;
@@ -330,48 +102,6 @@ namespace ZX128 {
     }
   }
 
-  bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
-  {
-    const uint8_t *tbl = breakPointTable;
-    if (tbl != (uint8_t *) 0 && (tbl[addr] & 32) != 0) {
-      return true;
-    }
-    else {
-      uint16_t  offs = addr & 0x3FFF;
-      tbl = segmentBreakPointTable[pageTable[addr >> 14]];
-      if (tbl != (uint8_t *) 0 && (tbl[offs] & 32) != 0) {
-        return true;
-      }
-    }
-    return false;
-  }
-
-  Ep128Emu::BreakPointList Memory::getBreakPointList()
-  {
-    Ep128Emu::BreakPointList  bplst;
-    if (breakPointTable) {
-      for (size_t i = 0; i < 65536; i++) {
-        uint8_t bp = breakPointTable[i];
-        if (bp)
-          bplst.addMemoryBreakPoint(uint16_t(i),
-                                    bool(bp & 1), bool(bp & 2), bool(bp & 4),
-                                    bool(bp & 32), bp >> 3);
-      }
-    }
-    for (size_t j = 0; j < 256; j++) {
-      if (segmentBreakPointTable[j]) {
-        for (size_t i = 0; i < 16384; i++) {
-          uint8_t bp = segmentBreakPointTable[j][i];
-          if (bp)
-            bplst.addMemoryBreakPoint(uint8_t(j), uint16_t(i),
-                                      bool(bp & 1), bool(bp & 2), bool(bp & 4),
-                                      bool(bp & 32), bp >> 3);
-        }
-      }
-    }
-    return bplst;
-  }
-
   // --------------------------------------------------------------------------
 
   class ChunkType_MemorySnapshot : public Ep128Emu::File::ChunkTypeHandler {
@@ -405,12 +135,15 @@ namespace ZX128 {
     buf.writeByte(pageTable[2]);
     buf.writeByte(pageTable[3]);
     if (segmentTable != (uint8_t **) 0 && segmentROMTable != (bool *) 0) {
+      size_t  nSegments = 0;
+      for (size_t i = 0; i < 256; i++)
+        nSegments += size_t(segmentTable[i] != (uint8_t *) 0);
+      buf.reserve(buf.getPosition() + (nSegments * 16386));
       for (size_t i = 0; i < 256; i++) {
         if (segmentTable[i] != (uint8_t *) 0) {
           buf.writeByte(uint8_t(i));
           buf.writeBoolean(segmentROMTable[i]);
-          for (size_t j = 0; j < 16384; j++)
-            buf.writeByte(segmentTable[i][j]);
+          buf.writeData(segmentTable[i], 16384);
         }
       }
     }
@@ -425,6 +158,7 @@ namespace ZX128 {
 
   void Memory::loadState(Ep128Emu::File::Buffer& buf)
   {
+    setAllSegmentsDirty();
     buf.setPosition(0);
     // check version number
     unsigned int  version = buf.readUInt32();
@@ -449,8 +183,8 @@ namespace ZX128 {
       loadSegment(segment, false, (uint8_t *) 0, 0);
       // set ROM flag and load data
       allocateSegment(segment, buf.readBoolean());
-      for (size_t i = 0; i < 16384; i++)
-        segmentTable[segment][i] = buf.readByte();
+      buf.readData(segmentTable[segment], 16384);
+      shareSegment(segment);
     }
   }
 
@@ -467,5 +201,13 @@ namespace ZX128 {
     }
   }
 
+  void Memory::forkState(Ep128Emu::StateFork& f)
+  {
+    f.copy(pageTable);
+    f.copy(pageAddressTableR);
+    f.copy(pageAddressTableW);
+    forkSegments(f);
+  }
+
 }       // namespace ZX128
 
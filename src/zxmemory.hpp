@@ -22,64 +22,41 @@
 
 #include "ep128emu.hpp"
 #include "bplist.hpp"
+#include "membase.hpp"
 
 namespace ZX128 {
 
-  class Memory {
+  class Memory : public Ep128Emu::MemoryBase {
    private:
-    uint8_t **segmentTable;
-    bool    *segmentROMTable;
     uint8_t pageTable[4];
-    uint8_t *breakPointTable;
-    size_t  breakPointCnt;
-    uint8_t **segmentBreakPointTable;
-    size_t  *segmentBreakPointCntTable;
-    bool    haveBreakPoints;
-    uint8_t breakPointPriorityThreshold;
-    uint8_t *dummyMemory;   // 2*16K dummy memory for invalid reads and writes
     uint8_t *pageAddressTableR[4];
     uint8_t *pageAddressTableW[4];
-    void allocateSegment(uint8_t n, bool isROM);
-    void checkExecuteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkReadBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
-    void checkWriteBreakPoint(uint16_t addr, uint8_t page, uint8_t value);
+   protected:
+    virtual void updatePaging();
    public:
     Memory();
     virtual ~Memory();
-    void setBreakPoint(uint8_t segment, uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void setBreakPoint(uint16_t addr,
-                       int priority, bool r, bool w, bool x, bool ignoreFlag);
-    void clearBreakPoints(uint8_t segment);
-    void clearBreakPoints();
-    void clearAllBreakPoints();
-    void setBreakPointPriorityThreshold(int n);
-    int getBreakPointPriorityThreshold();
     void loadSegment(uint8_t segment, bool isROM,
                      const uint8_t *data, size_t dataSize);
-    void deleteSegment(uint8_t segment);
     void deleteAllSegments();
     inline uint8_t read(uint16_t addr);
     inline uint8_t readOpcode(uint16_t addr);
+#ifdef Z80_DECODE_CACHE
+    // returns the predecoded instruction at 'addr', or zero if it cannot
+    // be cached
+    inline uint32_t readOpcodeDecoded(uint16_t addr);
+#endif
     inline uint8_t readNoDebug(uint16_t addr) const;
-    inline uint8_t readRaw(uint32_t addr) const;
     inline void write(uint16_t addr, uint8_t value);
-    inline void writeRaw(uint32_t addr, uint8_t value);
-    inline void writeROM(uint32_t addr, uint8_t value);
     void setPage(uint8_t page, uint8_t segment);
     inline uint8_t getPage(uint8_t page) const;
     inline const uint8_t * getSegmentData(uint8_t segment) const;
-    inline bool isSegmentROM(uint8_t segment) const;
-    inline bool isSegmentRAM(uint8_t segment) const;
-    inline void * getSegmentPtr(uint8_t segment) const;
-    bool checkIgnoreBreakPoint(uint16_t addr) const;
-    Ep128Emu::BreakPointList getBreakPointList();
+    inline bool checkIgnoreBreakPoint(uint16_t addr) const;
     void saveState(Ep128Emu::File::Buffer&);
     void saveState(Ep128Emu::File&);
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
-   protected:
-    virtual void breakPointCallback(bool isWrite, uint16_t addr, uint8_t value);
+    void forkState(Ep128Emu::StateFork&);
   };
 
   // --------------------------------------------------------------------------
@@ -89,7 +66,7 @@ namespace ZX128 {
     uint8_t page = uint8_t(addr >> 14);
     uint8_t value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkReadBreakPoint(addr, page, value);
+      checkReadBreakPoint(addr, pageTable[page], value);
     return value;
   }
 
@@ -98,52 +75,39 @@ namespace ZX128 {
     uint8_t page = uint8_t(addr >> 14);
     uint8_t value = pageAddressTableR[page][addr];
     if (haveBreakPoints)
-      checkExecuteBreakPoint(addr, page, value);
+      checkExecuteBreakPoint(addr, pageTable[page], value);
     return value;
   }
 
-  inline uint8_t Memory::readNoDebug(uint16_t addr) const
+#ifdef Z80_DECODE_CACHE
+  inline uint32_t Memory::readOpcodeDecoded(uint16_t addr)
   {
-    return pageAddressTableR[uint8_t(addr >> 14)][addr];
+    return readDecodeCache(pageTable[addr >> 14], uint16_t(addr & 0x3FFF));
   }
 
-  inline uint8_t Memory::readRaw(uint32_t addr) const
+#endif
+  inline uint8_t Memory::readNoDebug(uint16_t addr) const
   {
-    uint8_t segment, value;
-
-    segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      value = segmentTable[segment][addr & 0x3FFF];
-    else
-      value = 0xFF;
-    return value;
+    return pageAddressTableR[uint8_t(addr >> 14)][addr];
   }
 
   inline void Memory::write(uint16_t addr, uint8_t value)
   {
     uint8_t page = uint8_t(addr >> 14);
     if (haveBreakPoints)
-      checkWriteBreakPoint(addr, page, value);
+      checkWriteBreakPoint(addr, pageTable[page], value);
     pageAddressTableW[page][addr] = value;
+    segmentWritten(pageTable[page], addr);
   }
 
-  inline void Memory::writeRaw(uint32_t addr, uint8_t value)
-  {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (!segmentROMTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
-  }
-
-  inline void Memory::writeROM(uint32_t addr, uint8_t value)
+  inline uint8_t Memory::getPage(uint8_t page) const
   {
-    uint8_t segment = uint8_t(addr >> 14);
-    if (segmentTable[segment])
-      segmentTable[segment][addr & 0x3FFF] = value;
+    return pageTable[page & 3];
   }
 
-  inline uint8_t Memory::getPage(uint8_t page) const
+  inline bool Memory::checkIgnoreBreakPoint(uint16_t addr) const
   {
-    return pageTable[page & 3];
+    return MemoryBase::checkIgnoreBreakPoint(addr, pageTable[addr >> 14]);
   }
 
   inline const uint8_t * Memory::getSegmentData(uint8_t segment) const
@@ -152,23 +116,6 @@ namespace ZX128 {
             segmentTable[segment] : dummyMemory);
   }
 
-  inline bool Memory::isSegmentROM(uint8_t segment) const
-  {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            segmentROMTable[segment]);
-  }
-
-  inline bool Memory::isSegmentRAM(uint8_t segment) const
-  {
-    return (segmentTable[segment] != (uint8_t *) 0 &&
-            !segmentROMTable[segment]);
-  }
-
-  inline void * Memory::getSegmentPtr(uint8_t segment) const
-  {
-    return (segmentTable[segment]);
-  }
-
 }       // namespace ZX128
 
 #endif  // EP128EMU_ZXMEMORY_HPP
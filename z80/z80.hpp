@@ -48,6 +48,13 @@
 #define Z80_SET_PC_FLAG                         0x0020
 #define Z80_FLAGS_MASK                          0x003E
 
+// predecoded opcode format (see Z80::predecodeInstruction()):
+//   bits 0 to 7:   opcode byte
+//   bits 8 to 23:  operand bytes fetched together with the opcode
+//   bits 24, 25:   number of operand bytes fetched (0 to 2)
+//   bit 31:        always set, so that zero can mark an empty cache entry
+#define Z80_PREDECODED_VALID                    0x80000000U
+
 #ifndef CPC_LSB_FIRST
 #  if defined(__i386__) || defined(__x86_64__) || defined(WIN32)
 #    define CPC_LSB_FIRST 1
@@ -191,11 +198,30 @@ namespace Ep128 {
     Z80_REGISTERS   R;
     int32_t newPCAddress;
    private:
-    EP128EMU_INLINE void Index_CB_ExecuteInstruction();
-    EP128EMU_INLINE void FD_ExecuteInstruction();
-    EP128EMU_INLINE void DD_ExecuteInstruction();
-    EP128EMU_INLINE void ED_ExecuteInstruction();
-    EP128EMU_INLINE void CB_ExecuteInstruction();
+#ifdef Z80_COMPUTED_GOTO
+    // the tables of label addresses prevent inlining
+#  define Z80_PREFIX_INLINE inline
+#else
+#  define Z80_PREFIX_INLINE EP128EMU_INLINE
+#endif
+    // number of instructions executed, for performance statistics only
+    uint64_t  instructionCnt;
+#ifdef Z80_DECODE_CACHE
+    // operands of the current instruction, if readOpcodeFirstByteDecoded()
+    // has already fetched them
+    uint16_t  prefetchedOperands;
+    uint8_t   prefetchedOperandCnt;
+    // the number of operand bytes of each unprefixed opcode that can be
+    // fetched together with the opcode (0 if any other cycles come first)
+    static const uint8_t  predecodeOperandCntTable[256];
+#endif
+    EP128EMU_INLINE uint8_t readOperandByte();
+    EP128EMU_INLINE uint16_t readOperandWord();
+    Z80_PREFIX_INLINE void Index_CB_ExecuteInstruction();
+    Z80_PREFIX_INLINE void FD_ExecuteInstruction();
+    Z80_PREFIX_INLINE void DD_ExecuteInstruction();
+    Z80_PREFIX_INLINE void ED_ExecuteInstruction();
+    Z80_PREFIX_INLINE void CB_ExecuteInstruction();
     EP128EMU_INLINE Z80_BYTE RD_BYTE_INDEX_(Z80_WORD Index);
     EP128EMU_INLINE void WR_BYTE_INDEX_(Z80_WORD Index, Z80_BYTE Data);
     EP128EMU_INLINE void LD_HL_n();
@@ -266,6 +292,53 @@ namespace Ep128 {
     void clearInterrupt();
     void setVectorBase(int);
     void executeInstruction();
+#ifdef Z80_DECODE_CACHE
+    /*!
+     * Returns the predecoded form (see Z80_PREDECODED_VALID) of the
+     * instruction at 'p', which is followed by at least 'nBytes' - 1 more
+     * bytes of memory in the same segment.
+     */
+    static inline uint32_t predecodeInstruction(const uint8_t *p,
+                                                size_t nBytes)
+    {
+      uint32_t  n = predecodeOperandCntTable[p[0]];
+      if (n >= nBytes)
+        n = 0;
+      uint32_t  retval = Z80_PREDECODED_VALID | (n << 24) | uint32_t(p[0]);
+      if (n >= 1)
+        retval = retval | (uint32_t(p[1]) << 8);
+      if (n >= 2)
+        retval = retval | (uint32_t(p[2]) << 16);
+      return retval;
+    }
+#endif
+    /*!
+     * Returns the number of instructions executed by executeInstruction()
+     * since the CPU was created.
+     */
+    inline uint64_t getInstructionCount() const
+    {
+      return instructionCnt;
+    }
+    /*!
+     * Returns true if the CPU is executing HALT. In this state, every
+     * instruction is a repeated fetch of the HALT opcode, which can be run
+     * with executeHaltCycle() instead of executeInstruction().
+     */
+    EP128EMU_INLINE bool isExecutingHalt() const
+    {
+      return bool(R.Flags & Z80_EXECUTING_HALT_FLAG);
+    }
+    /*!
+     * Complete a repeated HALT opcode fetch without decoding the opcode, and
+     * take any pending interrupt or NMI. The caller is expected to have
+     * updated the cycle count in the same way as readOpcodeFirstByte().
+     */
+    EP128EMU_INLINE void executeHaltCycle()
+    {
+      R.R++;
+      checkInterrupts();
+    }
     /*!
      * Save snapshot.
      */
@@ -276,6 +349,10 @@ namespace Ep128 {
      */
     void loadState(Ep128Emu::File::Buffer&);
     void registerChunkType(Ep128Emu::File&);
+    /*!
+     * Save or restore the registers for run-ahead (see statefork.hpp).
+     */
+    virtual void forkState(Ep128Emu::StateFork&);
    protected:
     /*!
      * Called when a maskable interrupt is to be executed. Subclasses should
@@ -315,6 +392,15 @@ namespace Ep128 {
      * Read the first byte of an opcode (4 cycles).
      */
     virtual EP128EMU_REGPARM1 uint8_t readOpcodeFirstByte();
+#ifdef Z80_DECODE_CACHE
+    /*!
+     * Read the first byte of an opcode like readOpcodeFirstByte(), and
+     * return it in predecoded form (see Z80_PREDECODED_VALID). If the
+     * operand bytes are also returned, they must be fetched with the same
+     * timing as readOpcodeByte(1) or readOpcodeWord(1) would.
+     */
+    virtual EP128EMU_REGPARM1 uint32_t readOpcodeFirstByteDecoded();
+#endif
     /*!
      * Read the second byte of an opcode (4 cycles).
      * If 'invalidOpcodeTable' is not NULL, and the opcode byte read is in the
@@ -356,6 +442,25 @@ namespace Ep128 {
     }
   };
 
+  // read the operand of an unprefixed instruction at PC + 1
+  EP128EMU_INLINE uint8_t Z80::readOperandByte()
+  {
+#ifdef Z80_DECODE_CACHE
+    if (prefetchedOperandCnt)
+      return uint8_t(prefetchedOperands & 0xFF);
+#endif
+    return readOpcodeByte(1);
+  }
+
+  EP128EMU_INLINE uint16_t Z80::readOperandWord()
+  {
+#ifdef Z80_DECODE_CACHE
+    if (prefetchedOperandCnt)
+      return prefetchedOperands;
+#endif
+    return readOpcodeWord(1);
+  }
+
 }       // namespace Ep128
 
 #endif  // __Z80_HEADER_INCLUDED__
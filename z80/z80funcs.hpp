@@ -40,7 +40,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::LD_HL_n()
   {
-    writeMemory(R.HL.W, readOpcodeByte(1));
+    writeMemory(R.HL.W, readOperandByte());
   }
 
   /*---------------------------*/
@@ -62,7 +62,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::ADD_A_n()
   {
-    ADD_A_X(readOpcodeByte(1));
+    ADD_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::ADC_A_HL()
@@ -72,7 +72,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::ADC_A_n()
   {
-    ADC_A_X(readOpcodeByte(1));
+    ADC_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::SUB_A_HL()
@@ -82,7 +82,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::SUB_A_n()
   {
-    SUB_A_X(readOpcodeByte(1));
+    SUB_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::SBC_A_HL()
@@ -92,7 +92,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::SBC_A_n()
   {
-    SBC_A_X(readOpcodeByte(1));
+    SBC_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::CP_A_HL()
@@ -102,12 +102,12 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::CP_A_n()
   {
-    CP_A_X(readOpcodeByte(1));
+    CP_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::AND_A_n()
   {
-    AND_A_X(readOpcodeByte(1));
+    AND_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::AND_A_HL()
@@ -117,7 +117,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::XOR_A_n()
   {
-    XOR_A_X(readOpcodeByte(1));
+    XOR_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::XOR_A_HL()
@@ -132,13 +132,13 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::OR_A_n()
   {
-    OR_A_X(readOpcodeByte(1));
+    OR_A_X(readOperandByte());
   }
 
   EP128EMU_INLINE void Z80::OUT_n_A()
   {
     /* A in upper byte of port, Data in lower byte of port */
-    doOut((Z80_WORD) readOpcodeByte(1) | ((Z80_WORD) (R.AF.B.h) << 8),
+    doOut((Z80_WORD) readOperandByte() | ((Z80_WORD) (R.AF.B.h) << 8),
           R.AF.B.h);
   }
 
@@ -146,7 +146,7 @@ namespace Ep128 {
   {
     /* A in upper byte of port, data in lower byte of port */
     R.AF.B.h =
-        doIn((Z80_WORD) readOpcodeByte(1) | ((Z80_WORD) (R.AF.B.h) << 8));
+        doIn((Z80_WORD) readOperandByte() | ((Z80_WORD) (R.AF.B.h) << 8));
   }
 
   EP128EMU_INLINE void Z80::RRA()
@@ -185,7 +185,7 @@ namespace Ep128 {
   EP128EMU_INLINE void Z80::JP()
   {
     /* set program counter to sub-routine address */
-    R.PC.W.l = readOpcodeWord(1);
+    R.PC.W.l = readOperandWord();
   }
 
   /*------------------------------------*/
@@ -194,7 +194,7 @@ namespace Ep128 {
   EP128EMU_INLINE void Z80::JR()
   {
     R.PC.W.l =
-        Z80_WORD((R.PC.W.l + 2 + int(Z80_BYTE_OFFSET(readOpcodeByte(1))))
+        Z80_WORD((R.PC.W.l + 2 + int(Z80_BYTE_OFFSET(readOperandByte())))
                  & 0xFFFF);
     updateCycles(5);
   }
@@ -204,7 +204,7 @@ namespace Ep128 {
 
   EP128EMU_INLINE void Z80::CALL()
   {
-    Z80_WORD  tempWord = readOpcodeWord(1);
+    Z80_WORD  tempWord = readOperandWord();
     /* store return address on stack */
     PUSH(Z80_WORD(R.PC.W.l + 3));
     /* set program counter to sub-routine address */
@@ -220,7 +220,7 @@ namespace Ep128 {
     /* if zero */
     if (R.BC.B.h == 0) {
       /* continue */
-      (void) readOpcodeByte(1);
+      (void) readOperandByte();
       R.PC.W.l += 2;
     }
     else {
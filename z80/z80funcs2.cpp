@@ -162,7 +162,36 @@ namespace Ep128 {
     }
   }
 
+#ifdef Z80_DECODE_CACHE
+  // LD r,n, LD (HL),n, ALU A,n, OUT (n),A, IN A,(n), JR, LD rr,nn,
+  // LD (nn),HL/A, LD HL/A,(nn), JP and CALL, which read the operand first;
+  // the handlers in z80.cpp use readOperandByte() and readOperandWord()
+  const uint8_t Z80::predecodeOperandCntTable[256] = {
+    0, 2, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,   // 0x
+    0, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0,   // 1x
+    1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,   // 2x
+    1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,   // 3x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 4x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 5x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 6x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 7x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 8x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 9x
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // Ax
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // Bx
+    0, 0, 2, 2, 2, 0, 1, 0, 0, 0, 2, 0, 2, 2, 1, 0,   // Cx
+    0, 0, 2, 1, 2, 0, 1, 0, 0, 0, 2, 1, 2, 0, 1, 0,   // Dx
+    0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0,   // Ex
+    0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0    // Fx
+  };
+
+#endif
   Z80::Z80()
+    : instructionCnt(0UL)
+#ifdef Z80_DECODE_CACHE
+      , prefetchedOperands(0),
+      prefetchedOperandCnt(0)
+#endif
   {
     std::memset(&R, 0, sizeof(Z80_REGISTERS));
     int     seed = 0;
@@ -429,6 +458,13 @@ namespace Ep128 {
     return readMemory(uint16_t(R.PC.W.l));
   }
 
+#ifdef Z80_DECODE_CACHE
+  EP128EMU_REGPARM1 uint32_t Z80::readOpcodeFirstByteDecoded()
+  {
+    return (Z80_PREDECODED_VALID | uint32_t(readOpcodeFirstByte()));
+  }
+
+#endif
   EP128EMU_REGPARM2 uint8_t Z80::readOpcodeSecondByte(
       const bool *invalidOpcodeTable)
   {
@@ -591,5 +627,11 @@ namespace Ep128 {
     }
   }
 
+  void Z80::forkState(Ep128Emu::StateFork& f)
+  {
+    f.copy(R);
+    f.copy(newPCAddress);
+  }
+
 }       // namespace Ep128
 
@@ -130,7 +130,7 @@
                     | t.zeroSignParityTable[(Register) & 0xFF];         \
 }
 
-#define LD_R_n(Register)        Register = readOpcodeByte(1)
+#define LD_R_n(Register)        Register = readOperandByte()
 
 #define LD_RI_n(Register)       Register = readOpcodeByte(2)
 
@@ -592,7 +592,7 @@
 
 /*-----------------*/
 
-#define LD_RR_nn(Register)      Register = readOpcodeWord(1)
+#define LD_RR_nn(Register)      Register = readOperandWord()
 
 #define LD_INDEXRR_nn(Index)    Index = readOpcodeWord(2)
 
@@ -1094,28 +1094,28 @@
 #define LD_HL_nnnn()                                                    \
 {                                                                       \
         Z80_WORD  Addr;                                                 \
-        Addr =  readOpcodeWord(1);                                      \
+        Addr =  readOperandWord();                                      \
         R.HL.W = readMemoryWord(Addr);                                  \
 }
 
 #define LD_nnnn_HL()                                                    \
 {                                                                       \
         Z80_WORD  Addr;                                                 \
-        Addr =  readOpcodeWord(1);                                      \
+        Addr =  readOperandWord();                                      \
         writeMemoryWord(Addr,R.HL.W);                                   \
 }
 
 #define LD_A_nnnn()                                                     \
 {                                                                       \
         Z80_WORD  Addr;                                                 \
-        Addr = readOpcodeWord(1);                                       \
+        Addr = readOperandWord();                                       \
         R.AF.B.h = readMemory(Addr);                                    \
 }
 
 #define LD_nnnn_A()                                                     \
 {                                                                       \
         Z80_WORD  Addr;                                                 \
-        Addr = readOpcodeWord(1);                                       \
+        Addr = readOperandWord();                                       \
         writeMemory(Addr,R.AF.B.h);                                     \
 }
 